@@ -21,6 +21,7 @@
 */
 
 #include "qrmatrixsvg.h"
+#include "../../QRMatrix/Render/qrmatrixsvgwriter.h"
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -35,39 +36,9 @@ void QRMatrixSvg::draw(QRMatrix::QRMatrixBoard board, const char* path, unsigned
     unsigned int quietZone = isMicro ? 2 : 4;
     ofstream outFile;
     outFile.open(path);
-    // <svg>
-    unsigned int dimension = board.dimension() * scale + 2 * quietZone * scale;
-    string dimensionStr = to_string(dimension);
-    outFile << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << dimensionStr.c_str()
-            << "\" height=\"" << dimensionStr.c_str()
-            << "\">\n";
-    outFile << "    <rect fill=\"white\" stroke=\"none\""
-            << " width=\"" << dimensionStr.c_str()
-            << "\" height=\""<< dimensionStr.c_str()
-            << "\" x=\"0\" y=\"0\"/>\n";
-    outFile << "    <g fill=\"black\" stroke=\"none\">\n";
-    // Content
-    UnsignedByte** data = board.buffer();
-    string cellSizeStr = to_string(scale);
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // </svg>
-    outFile << "</svg>\n";
+    QRMatrixSvgWriter::write(board, [&outFile](const char* text, unsigned int length) {
+        outFile.write(text, length);
+    }, scale, quietZone);
     outFile.close();
 }
 
@@ -91,206 +62,21 @@ void QRMatrixSvg::drawDetail(
         throw invalid_argument("Scale > 0");
     }
     unsigned int quietZone = isMicro ? 2 : 4;
+    QRMatrixSvgColors colors;
+    colors.background = backgroundColor;
+    colors.data = dataColor;
+    colors.finder = finderColor;
+    colors.timing = timingColor;
+    colors.dark = darkColor;
+    colors.alignment = aligmentColor;
+    colors.version = versionColor;
+    colors.format = formatColor;
+    colors.errorCorrection = ecColor;
+    colors.remainder = remainderColor;
     ofstream outFile;
     outFile.open(path);
-    // <svg>
-    unsigned int dimension = board.dimension() * scale + 2 * quietZone * scale;
-    string dimensionStr = to_string(dimension);
-    outFile << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << dimensionStr.c_str()
-            << "\" height=\"" << dimensionStr.c_str()
-            << "\">\n";
-    outFile << "    <rect fill=\"" << backgroundColor << "\" stroke=\"none\""
-            << " width=\"" << dimensionStr.c_str()
-            << "\" height=\""<< dimensionStr.c_str()
-            << "\" x=\"0\" y=\"0\"/>\n";
-    // Data cells
-    outFile << "    <!-- Data cells -->\n";
-    outFile << "    <g fill=\"" << dataColor << "\" stroke=\"none\">\n";
-    UnsignedByte** data = board.buffer();
-    string cellSizeStr = to_string(scale);
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == 0) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Finder cells
-    outFile << "    <!-- Finder cells -->\n";
-    outFile << "    <g fill=\"" << finderColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::finder) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Timing cells
-    outFile << "    <!-- Timing cells -->\n";
-    outFile << "    <g fill=\"" << timingColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::timing) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Aligment cells
-    outFile << "    <!-- Aligment cells -->\n";
-    outFile << "    <g fill=\"" << aligmentColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::alignment) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Version cells
-    outFile << "    <!-- Version info cells -->\n";
-    outFile << "    <g fill=\"" << versionColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::version) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Format cells
-    outFile << "    <!-- Format info cells -->\n";
-    outFile << "    <g fill=\"" << formatColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::format) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Dark cell
-    outFile << "    <!-- Dark cells -->\n";
-    outFile << "    <g fill=\"" << darkColor << "\" stroke=\"none\">\n";
-    UnsignedByte cell = data[board.dimension() - 8][8];
-    UnsignedByte high = cell & BoardCell::highMask;
-    UnsignedByte low = cell & BoardCell::lowMask;
-    if (low == BoardCell::set && high == BoardCell::dark) {
-        unsigned int x = (quietZone + 8) * scale;
-        unsigned int y = (quietZone + board.dimension() - 8) * scale;
-
-        outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                << "\" height=\""<< cellSizeStr.c_str()
-                << "\" x=\"" << to_string(x).c_str()
-                << "\" y=\"" << to_string(y).c_str()
-                << "\"/>\n";
-    }
-    outFile << "    </g>\n";
-    // ErrorCorrection cells
-    outFile << "    <!-- Error correction cells -->\n";
-    outFile << "    <g fill=\"" << ecColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::errorCorrection) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // Remainder cells
-    outFile << "    <!-- Remainder cells -->\n";
-    outFile << "    <g fill=\"" << remainderColor << "\" stroke=\"none\">\n";
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = data[row][column];
-            UnsignedByte high = cell & BoardCell::highMask;
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set && high == BoardCell::remainder) {
-                unsigned int x = (quietZone + column) * scale;
-                unsigned int y = (quietZone + row) * scale;
-
-                outFile << "        <rect width=\"" << cellSizeStr.c_str()
-                        << "\" height=\""<< cellSizeStr.c_str()
-                        << "\" x=\"" << to_string(x).c_str()
-                        << "\" y=\"" << to_string(y).c_str()
-                        << "\"/>\n";
-            }
-        }
-    }
-    outFile << "    </g>\n";
-    // </svg>
-    outFile << "</svg>\n";
+    QRMatrixSvgWriter::writeDetail(board, [&outFile](const char* text, unsigned int length) {
+        outFile.write(text, length);
+    }, scale, quietZone, colors);
     outFile.close();
 }
@@ -25,6 +25,7 @@
 #include <spng.h>
 #include <cstring>
 #include "../../../QRMatrix/qrmatrixencoder.h"
+#include "../../../QRMatrix/Render/qrmatrixrasterrows.h"
 #include "../../../String/utf8string.h"
 
 #if __linux__
@@ -37,21 +38,28 @@ using namespace std;
 using namespace QRMatrix;
 
 /// https://github.com/randy408/libspng/blob/v0.7.3/examples/example.c
-void createPNG(UnsignedByte* image, unsigned int dimension, const char* path) {
+/// Rows are encoded one by one (progressive mode), so the whole image is never in memory.
+void createPNG(QRMatrixRasterRows& rows, const char* path) {
     spng_ctx *context = spng_ctx_new(SPNG_CTX_ENCODER);
     spng_set_option(context, SPNG_ENCODE_TO_BUFFER, 1);
 
     spng_ihdr ihdr = { 0 };
-    ihdr.width = dimension;
-    ihdr.height = dimension;
+    ihdr.width = rows.width();
+    ihdr.height = rows.width();
     ihdr.color_type = SPNG_COLOR_TYPE_GRAYSCALE;
-    ihdr.bit_depth = 8; // 1 byte per pixel: refer to `image`
+    ihdr.bit_depth = 8; // 1 byte per pixel: refer to `rows.style()`
     spng_set_ihdr(context, &ihdr);
 
-    unsigned int length = dimension * dimension;
     int fmt = SPNG_FMT_PNG;
-    int result = spng_encode_image(context, image, length, fmt, SPNG_ENCODE_FINALIZE);
-    if (result != 0) {
+    int result = spng_encode_image(context, NULL, 0, fmt, SPNG_ENCODE_PROGRESSIVE | SPNG_ENCODE_FINALIZE);
+    if (result == 0) {
+        const UnsignedByte* row = rows.next();
+        while (row != nullptr && result == 0) {
+            result = spng_encode_row(context, row, rows.rowBytes());
+            row = rows.next();
+        }
+    }
+    if (result != SPNG_EOI) {
         cout << "Encode PNG ERROR 1: " << path << "\n" << spng_strerror(result) << endl;
         spng_ctx_free(context);
         return;
@@ -74,48 +82,13 @@ void createPNG(UnsignedByte* image, unsigned int dimension, const char* path) {
     spng_ctx_free(context);
 }
 
-void fillCell(
-    UnsignedByte* image,
-    unsigned int dimension,
-    unsigned int row,
-    unsigned int column,
-    UnsignedByte scale,
-    UnsignedByte quiteZone
-) {
-    unsigned int rowOffset = (row + quiteZone) * scale * dimension;
-    unsigned int colOffset = (column + quiteZone) * scale;
-    for (unsigned int index = 0; index < scale; index += 1) {
-        unsigned int pic = rowOffset + index * dimension + colOffset;
-        for (unsigned jndex = 0; jndex < scale; jndex += 1) {
-            image[pic] = 0;
-            pic += 1;
-        }
-    }
-}
-
 void makeQR(QRMatrixBoard board, const char* path, bool isMicro) {
     UnsignedByte quietZone = isMicro ? 2 : 4;
     static UnsignedByte scale = 10;
-    unsigned int dimension = (board.dimension() + 2 * quietZone) * scale;
-    unsigned int length = dimension * dimension;
-    UnsignedByte* image = new UnsignedByte [length]; // each byte is a image pixel
-    // Fill white
-    for (unsigned int index = 0; index < length; index += 1) {
-        image[index] = 0xFF;
-    }
-    // Draw QR board (black cells)
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = board.buffer()[row][column];
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set) {
-                fillCell(image, dimension, row, column, scale, quietZone);
-            }
-        }
-    }
+    QRMatrixRasterStyle style(RasterFormat::gray8, scale, quietZone);
+    QRMatrixRasterRows rows(board, style);
     // Write PNG file
-    createPNG(image, dimension, path);
-    delete[] image;
+    createPNG(rows, path);
 }
 
 void encodeQR(const char* path, const UnsignedByte* raw, EncodingMode mode, unsigned int eci, bool isMicro) {
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <stdexcept>
 #include "../../../QRMatrix/qrmatrixencoder.h"
+#include "../../../QRMatrix/qrmatrixboardruns.h"
 #include <QtConcurrent/QtConcurrent>
 #include "../../../String/utf8string.h"
 
@@ -36,14 +37,11 @@ QPixmap* imageFromBoard(QRMatrixBoard board, int scale, bool isMicro) {
     QPixmap* result = new QPixmap(qrSize, qrSize);
     result->fill(QColorConstants::White);
     QPainter painter(result);
-    for (unsigned int row = 0; row < board.dimension(); row += 1) {
-        for (unsigned int column = 0; column < board.dimension(); column += 1) {
-            UnsignedByte cell = board.buffer()[row][column];
-            UnsignedByte low = cell & BoardCell::lowMask;
-            if (low == BoardCell::set) {
-                painter.fillRect((column + quietZone) * scale, (row + quietZone) * scale, scale, scale, QColorConstants::Black);
-            }
-        }
+    // 1 rectangle per run of black cells
+    QRMatrixBoardRuns runs(board);
+    BoardRun run;
+    while (runs.next(run)) {
+        painter.fillRect((run.column + quietZone) * scale, (run.row + quietZone) * scale, run.length * scale, scale, QColorConstants::Black);
     }
     painter.end();
     return result;
@@ -0,0 +1,292 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cstring>
+#include <string>
+
+#include "../../QRMatrix/qrmatrixencoder.h"
+#include "../../QRMatrix/qrmatrixdecoder.h"
+#include "../../QRMatrix/Polynomial/polynomial.h"
+#include "../../QRMatrix/Render/qrmatrixraster.h"
+#include "../../QRMatrix/Render/qrmatrixpng.h"
+#include "../../QRMatrix/Render/qrmatrixtext.h"
+#include "../../QRMatrix/Render/qrmatrixatlas.h"
+
+using namespace std;
+using namespace QRMatrix;
+
+/// Number of symbols encoded by each test
+#define BENCHMARK_COUNT 4096
+
+double nanosecondsSince(chrono::steady_clock::time_point start, unsigned int count) {
+    chrono::duration<double, nano> duration = chrono::steady_clock::now() - start;
+    return duration.count() / count;
+}
+
+/// Error corrections of `POLYNOMIAL_LANES` blocks: one by one vs all lanes together
+void benchmarkErrorCorrections(unsigned int length, unsigned int count) {
+    vector<UnsignedByte> data(length * POLYNOMIAL_LANES);
+    vector<UnsignedByte> result(count * POLYNOMIAL_LANES);
+    vector<UnsignedByte> block(length);
+    for (unsigned int index = 0; index < data.size(); index += 1) {
+        data[index] = (UnsignedByte)(index * 7 + 3);
+    }
+    unsigned int loops = BENCHMARK_COUNT / POLYNOMIAL_LANES;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        for (unsigned int lane = 0; lane < POLYNOMIAL_LANES; lane += 1) {
+            for (unsigned int index = 0; index < length; index += 1) {
+                block[index] = data[index * POLYNOMIAL_LANES + lane];
+            }
+            Polynomial::getErrorCorrections(block.data(), length, count, &result[lane * count]);
+        }
+    }
+    double single = nanosecondsSince(start, loops * POLYNOMIAL_LANES);
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        Polynomial::getErrorCorrectionsLanes(data.data(), length, count, result.data());
+    }
+    double lanes = nanosecondsSince(start, loops * POLYNOMIAL_LANES);
+    printf("RS block %3u+%2u: %8.0f ns/block single, %8.0f ns/block lanes (x%.2f)\n", length, count, single, lanes, single / lanes);
+}
+
+/// Symbols of the same version: per-symbol `encode` vs `encodeBatch` of fixed layout
+void benchmarkSymbols(UnsignedByte version, ErrorCorrectionLevel level, const char* levelName) {
+    QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(version, level, false, 0);
+    unsigned int length = layout.errorCorrectionInfo().codewords - 3;
+    vector<vector<UnsignedByte>> texts(BENCHMARK_COUNT);
+    vector<QRMatrixSegment> segments(BENCHMARK_COUNT);
+    vector<QRMatrixBatchItem> items(BENCHMARK_COUNT);
+    for (unsigned int index = 0; index < BENCHMARK_COUNT; index += 1) {
+        texts[index].resize(length);
+        for (unsigned int jndex = 0; jndex < length; jndex += 1) {
+            texts[index][jndex] = (UnsignedByte)('A' + (index * 31 + jndex * 7) % 26);
+        }
+        segments[index] = QRMatrixSegment(EncodingMode::byte, texts[index].data(), length);
+        items[index] = QRMatrixBatchItem(&segments[index], 1, level);
+    }
+    vector<QRMatrixBoard> boards(BENCHMARK_COUNT);
+    vector<QRMatrixStatus> statuses(BENCHMARK_COUNT);
+
+    QRMatrixEncoderContext context;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int index = 0; index < BENCHMARK_COUNT; index += 1) {
+        boards[index] = QRMatrixEncoder::encode(context, &segments[index], 1, level, QRMatrixExtraMode(), version, 0);
+    }
+    double single = nanosecondsSince(start, BENCHMARK_COUNT);
+
+    QRMatrixThreadPool pool(1);
+    start = chrono::steady_clock::now();
+    unsigned int succeeded = QRMatrixEncoder::encodeBatch(pool, layout, items.data(), BENCHMARK_COUNT, boards.data(), statuses.data());
+    double batch = nanosecondsSince(start, BENCHMARK_COUNT);
+    if (succeeded != BENCHMARK_COUNT) {
+        cout << "Failed to encode " << (BENCHMARK_COUNT - succeeded) << " symbols" << endl;
+    }
+    printf("Version %2u-%s: %8.0f ns/symbol encode, %8.0f ns/symbol encodeBatch(layout) (x%.2f)\n",
+           version, levelName, single, batch, single / batch);
+}
+
+/// 8 bits image of a symbol: filling `scale × scale` pixels of each black cell vs `QRMatrixRaster::render`
+void benchmarkRaster(UnsignedByte version, unsigned int scale) {
+    UnsignedByte text[] = "https://example.com/label/0123456789";
+    QRMatrixSegment segment(EncodingMode::byte, text, sizeof(text) - 1);
+    QRMatrixBoard board = QRMatrixEncoder::encode(&segment, 1, ErrorCorrectionLevel::medium, QRMatrixExtraMode(), version);
+    QRMatrixRasterStyle style(RasterFormat::gray8, scale, 4);
+    unsigned int width = style.width(board.dimension());
+    vector<UnsignedByte> image(width * width);
+    unsigned int loops = 64;
+    const UnsignedByte* bits = board.packed();
+    unsigned int stride = board.packedStride();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        for (unsigned int index = 0; index < image.size(); index += 1) {
+            image[index] = 0xFF;
+        }
+        for (unsigned int row = 0; row < board.dimension(); row += 1) {
+            for (unsigned int column = 0; column < board.dimension(); column += 1) {
+                if (((bits[row * stride + column / 8] >> (7 - column % 8)) & 1) == 0) {
+                    continue;
+                }
+                for (unsigned int line = 0; line < scale; line += 1) {
+                    UnsignedByte* pixel = &image[((row + 4) * scale + line) * width + (column + 4) * scale];
+                    for (unsigned int index = 0; index < scale; index += 1) {
+                        pixel[index] = 0;
+                    }
+                }
+            }
+        }
+    }
+    double cells = nanosecondsSince(start, loops);
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        QRMatrixRaster::render(board, style, image.data(), width);
+    }
+    double raster = nanosecondsSince(start, loops);
+    printf("Raster %2u x%2u (%5u px): %10.0f ns/image cells, %10.0f ns/image render (x%.2f)\n",
+           version, scale, width, cells, raster, cells / raster);
+}
+
+/// 1 bit PNG file of a symbol: stored vs fixed Huffman deflate
+void benchmarkPng(UnsignedByte version, unsigned int scale) {
+    UnsignedByte text[] = "https://example.com/label/0123456789";
+    QRMatrixSegment segment(EncodingMode::byte, text, sizeof(text) - 1);
+    QRMatrixBoard board = QRMatrixEncoder::encode(&segment, 1, ErrorCorrectionLevel::medium, QRMatrixExtraMode(), version);
+    QRMatrixRasterStyle style(RasterFormat::gray1, scale, 4);
+    unsigned int loops = 16;
+    double times[2];
+    unsigned int sizes[2];
+    PngCompression compressions[2] = { PngCompression::stored, PngCompression::fixedHuffman };
+    for (unsigned int mode = 0; mode < 2; mode += 1) {
+        unsigned int size = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int loop = 0; loop < loops; loop += 1) {
+            size = 0;
+            QRMatrixPng::write(board, style, [&size](const UnsignedByte*, unsigned int length) {
+                size += length;
+            }, compressions[mode]);
+        }
+        times[mode] = nanosecondsSince(start, loops);
+        sizes[mode] = size;
+    }
+    printf("PNG %2u x%2u (%5u px): stored %8u bytes %10.0f ns, fixedHuffman %6u bytes %10.0f ns\n",
+           version, scale, style.width(board.dimension()), sizes[0], times[0], sizes[1], times[1]);
+}
+
+/// Text of a symbol: `description()` vs half blocks
+void benchmarkText(UnsignedByte version) {
+    UnsignedByte text[] = "https://example.com/label/0123456789";
+    QRMatrixSegment segment(EncodingMode::byte, text, sizeof(text) - 1);
+    QRMatrixBoard board = QRMatrixEncoder::encode(&segment, 1, ErrorCorrectionLevel::medium, QRMatrixExtraMode(), version);
+    unsigned int loops = 64;
+    size_t size = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        board.description();
+    }
+    double description = nanosecondsSince(start, loops);
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        size = QRMatrixText::text(board, TextMode::halfBlocks, 4).size();
+    }
+    double halfBlocks = nanosecondsSince(start, loops);
+    printf("Text %2u: %10.0f ns description, %10.0f ns half blocks (%zu bytes)\n",
+           version, description, halfBlocks, size);
+}
+
+/// Sheet of symbols in a grid: render each symbol then copy it into the sheet vs `QRMatrixAtlas` (1 thread & all cores)
+void benchmarkAtlas(unsigned int count, unsigned int columns, unsigned int scale) {
+    vector<QRMatrixBoard> boards(count);
+    for (unsigned int index = 0; index < count; index += 1) {
+        string text = "https://example.com/label/" + to_string(100000 + index);
+        QRMatrixSegment segment(EncodingMode::byte, (UnsignedByte*)text.c_str(), (unsigned int)text.size());
+        boards[index] = QRMatrixEncoder::encode(&segment, 1, ErrorCorrectionLevel::medium, QRMatrixExtraMode(), 4);
+    }
+    QRMatrixRasterStyle style(RasterFormat::gray8, scale, 4);
+    QRMatrixAtlas atlas(boards.data(), count, style, columns, scale * 2, scale * 2);
+    unsigned int stride = (atlas.rowBytes() + 63) / 64 * 64;
+    vector<UnsignedByte> sheet(stride * atlas.height());
+    unsigned int tile = style.width(boards[0].dimension());
+    vector<UnsignedByte> image(tile * tile);
+    unsigned int loops = 4;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        memset(sheet.data(), 0xFF, sheet.size());
+        for (unsigned int index = 0; index < count; index += 1) {
+            QRMatrixRaster::render(boards[index], style, image.data(), tile);
+            unsigned int x = (index % columns) * (tile + scale * 2);
+            unsigned int y = (index / columns) * (tile + scale * 2);
+            for (unsigned int row = 0; row < tile; row += 1) {
+                memcpy(&sheet[(y + row) * stride + x], &image[row * tile], tile);
+            }
+        }
+    }
+    double blit = nanosecondsSince(start, loops);
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        atlas.render(sheet.data(), stride);
+    }
+    double single = nanosecondsSince(start, loops);
+    QRMatrixThreadPool pool;
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        atlas.render(pool, sheet.data(), stride);
+    }
+    double parallel = nanosecondsSince(start, loops);
+    printf("Atlas %4u x%2u (%5u x %5u px): %10.0f ns render & copy, %10.0f ns atlas, %10.0f ns atlas on %u threads\n",
+           count, scale, atlas.width(), atlas.height(), blit, single, parallel, pool.workerCount());
+}
+
+/// Read back a symbol: clean board vs board with wrong codewords to fix
+void benchmarkDecode(UnsignedByte version, ErrorCorrectionLevel level, const char* levelName) {
+    UnsignedByte text[] = "https://example.com/label/0123456789";
+    QRMatrixSegment segment(EncodingMode::byte, text, sizeof(text) - 1);
+    QRMatrixBoard board = QRMatrixEncoder::encode(&segment, 1, level, QRMatrixExtraMode(), version);
+    QRMatrixBoard damaged = board;
+    // Flip a 3 x 3 square of cells at the bottom right corner (the first codewords)
+    UnsignedByte dimension = board.dimension();
+    for (UnsignedByte row = dimension - 3; row < dimension; row += 1) {
+        for (UnsignedByte column = dimension - 3; column < dimension; column += 1) {
+            damaged.buffer()[row][column] ^= 0x0F;
+        }
+    }
+    damaged.invalidatePacked();
+    unsigned int loops = 256;
+    QRMatrixDecodedSymbol symbol;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        QRMatrixDecoder::tryDecode(board, symbol);
+    }
+    double clean = nanosecondsSince(start, loops);
+    start = chrono::steady_clock::now();
+    for (unsigned int loop = 0; loop < loops; loop += 1) {
+        QRMatrixDecoder::tryDecode(damaged, symbol);
+    }
+    double fixed = nanosecondsSince(start, loops);
+    printf("Decode %2u-%s: %10.0f ns clean, %10.0f ns with %u codewords fixed\n",
+           version, levelName, clean, fixed, symbol.correctedCodewords);
+}
+
+int main() {
+    benchmarkErrorCorrections(19, 7);
+    benchmarkErrorCorrections(43, 26);
+    benchmarkErrorCorrections(118, 30);
+    benchmarkSymbols(2, ErrorCorrectionLevel::medium, "M");
+    benchmarkSymbols(10, ErrorCorrectionLevel::quarter, "Q");
+    benchmarkSymbols(25, ErrorCorrectionLevel::high, "H");
+    benchmarkSymbols(40, ErrorCorrectionLevel::low, "L");
+    benchmarkRaster(4, 12);
+    benchmarkRaster(10, 24);
+    benchmarkRaster(40, 40);
+    benchmarkPng(4, 12);
+    benchmarkPng(10, 24);
+    benchmarkPng(40, 40);
+    benchmarkText(10);
+    benchmarkText(40);
+    benchmarkAtlas(600, 20, 8);
+    benchmarkDecode(10, ErrorCorrectionLevel::quarter, "Q");
+    benchmarkDecode(40, ErrorCorrectionLevel::low, "L");
+    return 0;
+}
@@ -0,0 +1,710 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "../../QRMatrix/qrmatrixencoder.h"
+#include "../../QRMatrix/qrmatrixdecoder.h"
+#include "../../QRMatrix/qrmatrixboardruns.h"
+#include "../../QRMatrix/common.h"
+#include "../../QRMatrix/Render/qrmatrixraster.h"
+#include "../../QRMatrix/Render/qrmatrixrasterrows.h"
+#include "../../QRMatrix/Render/qrmatrixpng.h"
+#include "../../QRMatrix/Render/qrmatrixsvgwriter.h"
+#include "../../QRMatrix/Render/qrmatrixtext.h"
+#include "../../QRMatrix/Render/qrmatrixatlas.h"
+
+using namespace std;
+using namespace QRMatrix;
+
+/// ECI Indicator of UTF-8 text
+#define ROUNDTRIP_UTF8_ECI 26
+
+/// UTF-8 text of 1, 2, 3 & 4 bytes characters
+const string ROUNDTRIP_TEXT = "QR Code – mã QR – QRコード – 二维码 – 🙂 ";
+const ErrorCorrectionLevel ROUNDTRIP_LEVELS[4] = {
+    ErrorCorrectionLevel::low,
+    ErrorCorrectionLevel::medium,
+    ErrorCorrectionLevel::quarter,
+    ErrorCorrectionLevel::high
+};
+
+unsigned int checksCount = 0;
+unsigned int failuresCount = 0;
+
+void fail(const string& name, const string& message) {
+    failuresCount += 1;
+    printf("FAILED %s: %s\n", name.c_str(), message.c_str());
+}
+
+/// `pattern` repeated up to `length` bytes
+string repeated(const string& pattern, unsigned int length) {
+    string result;
+    while (result.length() < length) {
+        result += pattern;
+    }
+    return result.substr(0, length);
+}
+
+/// Decoded segments are the (non-empty) given segments
+bool isSame(QRMatrixDecodedSymbol& symbol, QRMatrixSegment* segments, unsigned int count) {
+    unsigned int found = 0;
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixSegment& segment = segments[index];
+        if (segment.length() == 0) {
+            continue;
+        }
+        if (found >= symbol.count) {
+            return false;
+        }
+        QRMatrixSegment& decoded = symbol.segments[found];
+        if (decoded.mode() != segment.mode() || decoded.length() != segment.length() ||
+            memcmp(decoded.data(), segment.data(), segment.length()) != 0 ||
+            (!symbol.isMicro && decoded.eci() != segment.eci())) {
+            return false;
+        }
+        found += 1;
+    }
+    return found == symbol.count;
+}
+
+/// Flip all bits of the codeword starting at bit `module` of `layout` (`end`: end of data or error correction bits)
+void flipCodeword(QRMatrixBoard& board, const QRMatrixLayout& layout, unsigned int module, unsigned int end) {
+    UnsignedByte** buffer = board.buffer();
+    UnsignedByte dimension = board.dimension();
+    unsigned int last = module + 8 < end ? module + 8 : end;
+    for (unsigned int bit = module; bit < last; bit += 1) {
+        Unsigned2Bytes position = layout.position(bit);
+        buffer[position / dimension][position % dimension] ^= BoardCell::lowMask;
+    }
+}
+
+/// Damage as many codewords of each block as its error correction codewords can fix, alternately data
+/// & error correction codewords (from `seed`). MicroQR M1 has error detection only so it is not damaged.
+/// @return Number of damaged codewords.
+unsigned int damage(QRMatrixBoard& board, const QRMatrixLayout& layout, unsigned int seed) {
+    if (layout.isMicro() && layout.version() == 1) {
+        return 0;
+    }
+    const ErrorCorrectionInfo& ecInfo = layout.errorCorrectionInfo();
+    unsigned int blocksCount = ecInfo.group1Blocks + ecInfo.group2Blocks;
+    unsigned int capacity = ecInfo.ecCodewordsPerBlock / 2;
+    unsigned int firstCodeword = 0;
+    unsigned int result = 0;
+    for (unsigned int block = 0; block < blocksCount; block += 1) {
+        unsigned int codewordsCount = block < ecInfo.group1Blocks ? ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords;
+        for (unsigned int index = 0; index < capacity; index += 1) {
+            unsigned int offset = seed + block + index / 2;
+            if (index % 2 == 0) {
+                unsigned int codeword = firstCodeword + offset % codewordsCount;
+                flipCodeword(board, layout, layout.dataModule(codeword), layout.dataModulesCount());
+            } else {
+                unsigned int codeword = block * ecInfo.ecCodewordsPerBlock + offset % ecInfo.ecCodewordsPerBlock;
+                flipCodeword(board, layout, layout.errorCorrectionModule(codeword), layout.modulesCount());
+            }
+            result += 1;
+        }
+        firstCodeword += codewordsCount;
+    }
+    board.invalidatePacked();
+    return result;
+}
+
+/// Decode `board` (symbol of `layout`) as is, then damaged: both must give `segments` back
+void checkBoard(QRMatrixBoard& board, const QRMatrixLayout& layout, QRMatrixSegment* segments, unsigned int count, const string& name, unsigned int seed) {
+    for (unsigned int pass = 0; pass < 2; pass += 1) {
+        string step = pass == 0 ? name : name + " damaged";
+        unsigned int damagedCount = pass == 0 ? 0 : damage(board, layout, seed);
+        QRMatrixDecodedSymbol symbol;
+        QRMatrixStatus status = QRMatrixDecoder::tryDecode(board, symbol);
+        checksCount += 1;
+        if (!status.isSucceeded()) {
+            fail(step, status.message());
+            return;
+        }
+        bool isM1 = layout.isMicro() && layout.version() == 1;
+        if (symbol.version != layout.version() || symbol.isMicro != layout.isMicro() || (!isM1 && symbol.level != layout.level())) {
+            fail(step, "version or level");
+        }
+        if (symbol.correctedCodewords != damagedCount) {
+            fail(step, "corrected " + to_string(symbol.correctedCodewords) + " of " + to_string(damagedCount) + " codewords");
+        }
+        if (!isSame(symbol, segments, count)) {
+            fail(step, "data");
+        }
+    }
+}
+
+/// Symbols of all versions & levels, filled with numeric then alphanumeric or UTF-8 data
+void checkVersions(QRMatrixEncoderContext& context, bool isMicro) {
+    UnsignedByte maxVersion = isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION;
+    QRMatrixExtraMode extraMode = isMicro ? QRMatrixExtraMode(EncodingExtraMode::microQr) : QRMatrixExtraMode();
+    for (UnsignedByte version = 1; version <= maxVersion; version += 1) {
+        for (unsigned int levelIndex = 0; levelIndex < 4; levelIndex += 1) {
+            ErrorCorrectionLevel level = ROUNDTRIP_LEVELS[levelIndex];
+            // Best mask of each symbol or fixed mask (stamped on precomputed cells)
+            UnsignedByte maskId = version % 2 == 1 ? 0xFF : (version / 2 + levelIndex) % (isMicro ? 4 : 8);
+            QRMatrixLayout layout;
+            if (!QRMatrixEncoder::tryPrepareLayout(layout, version, level, isMicro, maskId).isSucceeded()) {
+                // Level not available in this MicroQR version
+                continue;
+            }
+            // M1: numeric only, M2: numeric & alphanumeric
+            EncodingMode secondMode = isMicro && version < 3 ? EncodingMode::alphaNumeric : EncodingMode::byte;
+            unsigned int secondCount = isMicro && version == 1 ? 0 : 2;
+            unsigned int codewords = layout.errorCorrectionInfo().codewords;
+            unsigned int numericLength = codewords;
+            unsigned int secondLength = codewords / 2;
+            string numbers;
+            string text;
+            QRMatrixSegment segments[2];
+            do {
+                // Shrink data until it fits the version
+                numericLength = numericLength * 7 / 8;
+                secondLength = secondLength * 7 / 8;
+                numbers = repeated("3141592653", numericLength + 1);
+                text = secondMode == EncodingMode::byte ? repeated(ROUNDTRIP_TEXT, secondLength) : repeated("ROUND TRIP $%*+-./:", secondLength);
+                segments[0].fill(EncodingMode::numeric, (const UnsignedByte*)numbers.data(), numbers.length());
+                segments[1].fill(secondMode, (const UnsignedByte*)text.data(), text.length(), isMicro ? defaultEciAssigmentValue : ROUNDTRIP_UTF8_ECI);
+            } while (!QRMatrixEncoder::fits(version, segments, secondCount == 0 ? 1 : secondCount, level, extraMode));
+            unsigned int count = secondCount == 0 ? 1 : secondCount;
+            QRMatrixBoard board;
+            string name = string(isMicro ? "M" : "V") + to_string(version) + " level " + to_string(levelIndex);
+            QRMatrixStatus status = QRMatrixEncoder::tryEncode(context, board, layout, segments, count, extraMode);
+            if (!status.isSucceeded()) {
+                checksCount += 1;
+                fail(name, status.message());
+                continue;
+            }
+            checkBoard(board, layout, segments, count, name, version);
+        }
+    }
+}
+
+/// UTF-8 text splitted into Structured Append parts (between characters), decoded & joined back
+void checkStructuredAppend(QRMatrixThreadPool& pool) {
+    string text = repeated(ROUNDTRIP_TEXT, 700);
+    // Keep whole characters at the end
+    while ((text.back() & 0xC0) != 0x00 && (text.back() & 0xC0) != 0x40) {
+        text.pop_back();
+    }
+    QRMatrixSegment segment(EncodingMode::byte, (const UnsignedByte*)text.data(), text.length(), ROUNDTRIP_UTF8_ECI);
+    const UnsignedByte maxVersions[3] = {8, 15, QR_MAX_VERSION};
+    for (unsigned int levelIndex = 0; levelIndex < 4; levelIndex += 1) {
+        for (unsigned int versionIndex = 0; versionIndex < 3; versionIndex += 1) {
+            ErrorCorrectionLevel level = ROUNDTRIP_LEVELS[levelIndex];
+            string name = "Structured Append level " + to_string(levelIndex) + " version <= " + to_string(maxVersions[versionIndex]);
+            QRMatrixStructuredAppend parts[16];
+            unsigned int partsCount = 0;
+            QRMatrixStatus status = QRMatrixEncoder::trySplit(parts, &partsCount, &segment, 1, level, maxVersions[versionIndex]);
+            checksCount += 1;
+            if (!status.isSucceeded()) {
+                fail(name, status.message());
+                continue;
+            }
+            QRMatrixBoard boards[16];
+            status = QRMatrixEncoder::tryEncode(pool, boards, parts, partsCount);
+            if (!status.isSucceeded()) {
+                fail(name, status.message());
+                continue;
+            }
+            string joined;
+            UnsignedByte parity = 0;
+            for (unsigned int index = 0; index < partsCount; index += 1) {
+                QRMatrixSegment& part = parts[index].segments[0];
+                if ((part.data()[0] & 0xC0) == 0x80) {
+                    fail(name, "part " + to_string(index) + " starts inside a UTF-8 character");
+                }
+                QRMatrixDecodedSymbol symbol;
+                status = QRMatrixDecoder::tryDecode(boards[index], symbol);
+                if (!status.isSucceeded()) {
+                    fail(name, status.message());
+                    break;
+                }
+                if (symbol.sequenceIndex != index || symbol.sequenceTotal != partsCount || (index > 0 && symbol.parity != parity)) {
+                    fail(name, "Structured Append header of part " + to_string(index));
+                }
+                parity = symbol.parity;
+                for (unsigned int segmentIndex = 0; segmentIndex < symbol.count; segmentIndex += 1) {
+                    joined.append((const char*)symbol.segments[segmentIndex].data(), symbol.segments[segmentIndex].length());
+                }
+                QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(symbol.version, symbol.level);
+                checkBoard(boards[index], layout, parts[index].segments, parts[index].count, name + " part " + to_string(index), index);
+            }
+            UnsignedByte expectedParity = 0;
+            for (unsigned int index = 0; index < text.length(); index += 1) {
+                expectedParity ^= (UnsignedByte)text[index];
+            }
+            if (joined != text || parity != expectedParity) {
+                fail(name, "joined data");
+            }
+        }
+    }
+}
+
+/// Symbols of a shared prefix template followed by serial numbers
+void checkPrefix(QRMatrixEncoderContext& context) {
+    string url = "https://example.com/item/";
+    QRMatrixSegment prefixSegment(EncodingMode::byte, (const UnsignedByte*)url.data(), url.length());
+    for (unsigned int levelIndex = 0; levelIndex < 4; levelIndex += 1) {
+        ErrorCorrectionLevel level = ROUNDTRIP_LEVELS[levelIndex];
+        UnsignedByte version = 4 + levelIndex;
+        QRMatrixPrefixTemplate prefix = QRMatrixEncoder::preparePrefix(&prefixSegment, 1, level, version);
+        QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(version, level);
+        for (unsigned int serial = 0; serial < 20; serial += 1) {
+            string number = to_string(1000003 * serial + levelIndex);
+            QRMatrixSegment segments[2];
+            segments[0] = prefixSegment;
+            segments[1].fill(EncodingMode::numeric, (const UnsignedByte*)number.data(), number.length());
+            QRMatrixBoard board = QRMatrixEncoder::encode(context, prefix, &segments[1], 1);
+            checkBoard(board, layout, segments, 2, "Prefix level " + to_string(levelIndex) + " #" + number, serial);
+        }
+    }
+}
+
+/// Symbols of a sequence of serial numbers
+void checkSequence(QRMatrixEncoderContext& context) {
+    for (unsigned int maskIndex = 0; maskIndex < 2; maskIndex += 1) {
+        UnsignedByte maskId = maskIndex == 0 ? 0xFF : 5;
+        QRMatrixSequence sequence = QRMatrixEncoder::prepareSequence(3, ErrorCorrectionLevel::quarter, QRMatrixExtraMode(), maskId);
+        QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(3, ErrorCorrectionLevel::quarter);
+        for (unsigned int serial = 0; serial < 50; serial += 1) {
+            string number = "SN-" + to_string(98765 + serial * 37);
+            QRMatrixSegment segment(EncodingMode::alphaNumeric, (const UnsignedByte*)number.data(), number.length());
+            // Copy: the board of sequence is updated in place by the next encoding
+            QRMatrixBoard board = QRMatrixEncoder::encode(context, sequence, &segment, 1);
+            checkBoard(board, layout, &segment, 1, "Sequence mask " + to_string(maskId) + " " + number, serial);
+        }
+    }
+}
+
+/// Boards have the same cells (types & colors)
+bool isSameBoard(QRMatrixBoard& board, QRMatrixBoard& expected) {
+    UnsignedByte dimension = expected.dimension();
+    if (board.dimension() != dimension) {
+        return false;
+    }
+    UnsignedByte** cells = board.buffer();
+    UnsignedByte** expectedCells = expected.buffer();
+    for (unsigned int row = 0; row < dimension; row += 1) {
+        if (memcmp(cells[row], expectedCells[row], dimension) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkSameBoard(const string& name, QRMatrixBoard& board, QRMatrixBoard& expected) {
+    checksCount += 1;
+    if (!isSameBoard(board, expected)) {
+        fail(name, "cells differ from QRMatrixEncoder::encode");
+    }
+}
+
+/// Input of `checkEncodingPaths`
+struct RoundTripSample {
+    const char* name;
+    EncodingMode mode;
+    string data;
+    bool isMicro;
+};
+
+/// Samples of small to big QR symbols & MicroQR symbols
+#define ROUNDTRIP_SAMPLES_COUNT 6
+void makeSamples(RoundTripSample* samples) {
+    samples[0] = { "numeric", EncodingMode::numeric, repeated("0123456789", 300), false };
+    samples[1] = { "alphanumeric", EncodingMode::alphaNumeric, repeated("ROUND TRIP $%*+-./:", 57), false };
+    samples[2] = { "UTF-8", EncodingMode::byte, repeated(ROUNDTRIP_TEXT, 300), false };
+    samples[3] = { "big UTF-8", EncodingMode::byte, repeated(ROUNDTRIP_TEXT, 1200), false };
+    samples[4] = { "MicroQR numeric", EncodingMode::numeric, "31415926", true };
+    samples[5] = { "MicroQR alphanumeric", EncodingMode::alphaNumeric, "QR 2024", true };
+}
+
+/// Every encoding path gives the same cells as `QRMatrixEncoder::encode(context, ...)` for the same input:
+/// cache (miss & hit), compact symbol, caller's buffer, error correction blocks on pool & batch.
+/// Version checks (`fits`, `predictVersion`) agree with the encoded symbol.
+void checkEncodingPaths(QRMatrixEncoderContext& context, QRMatrixThreadPool& pool) {
+    RoundTripSample samples[ROUNDTRIP_SAMPLES_COUNT];
+    makeSamples(samples);
+    QRMatrixCache cache(4 * 1024 * 1024);
+    QRMatrixSegment segments[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    QRMatrixBatchItem items[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    QRMatrixBoard baselines[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    string names[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    unsigned int count = 0;
+    for (unsigned int sampleIndex = 0; sampleIndex < ROUNDTRIP_SAMPLES_COUNT; sampleIndex += 1) {
+        RoundTripSample& sample = samples[sampleIndex];
+        QRMatrixExtraMode extraMode = sample.isMicro ? QRMatrixExtraMode(EncodingExtraMode::microQr) : QRMatrixExtraMode();
+        for (unsigned int levelIndex = 0; levelIndex < 4; levelIndex += 1) {
+            ErrorCorrectionLevel level = ROUNDTRIP_LEVELS[levelIndex];
+            for (unsigned int maskIndex = 0; maskIndex < 2; maskIndex += 1) {
+                UnsignedByte maskId = maskIndex == 0 ? 0xFF : (sample.isMicro ? 2 : 5);
+                string name = string(sample.name) + " level " + to_string(levelIndex) + " mask " + to_string(maskId);
+                QRMatrixSegment& segment = segments[count];
+                segment.fill(sample.mode, (const UnsignedByte*)sample.data.data(), sample.data.length());
+                QRMatrixBoard& baseline = baselines[count];
+                if (!QRMatrixEncoder::tryEncode(context, baseline, &segment, 1, level, extraMode, 0, maskId).isSucceeded()) {
+                    // Level not available in MicroQR
+                    continue;
+                }
+                // Cache: encoded then copied
+                QRMatrixBoard cached = QRMatrixEncoder::encode(cache, context, &segment, 1, level, extraMode, 0, maskId);
+                checkSameBoard(name + " cache miss", cached, baseline);
+                cached = QRMatrixEncoder::encode(cache, context, &segment, 1, level, extraMode, 0, maskId);
+                checkSameBoard(name + " cache hit", cached, baseline);
+                // Compact symbol
+                QRMatrixCompactSymbol symbol = QRMatrixEncoder::encodeCompact(context, &segment, 1, level, extraMode, 0, maskId);
+                QRMatrixBoard compact = symbol.board();
+                checkSameBoard(name + " compact symbol", compact, baseline);
+                // Error correction blocks on pool
+                QRMatrixBoard parallel = QRMatrixEncoder::encode(context, pool, &segment, 1, level, extraMode, 0, maskId);
+                checkSameBoard(name + " pool", parallel, baseline);
+                // Caller's buffer: cells & packed colors
+                UnsignedByte dimension = baseline.dimension();
+                for (unsigned int formatIndex = 0; formatIndex < 2; formatIndex += 1) {
+                    BoardFormat format = formatIndex == 0 ? BoardFormat::cellBytes : BoardFormat::packedBits;
+                    unsigned int rowLength = format == BoardFormat::cellBytes ? dimension : (dimension + 7) / 8;
+                    unsigned int stride = rowLength + 3;
+                    string output(stride * dimension, '\0');
+                    int result = QRMatrixEncoder::encode(
+                        context, (UnsignedByte*)&output[0], stride, output.length(), format, &segment, 1, level, extraMode, 0, maskId
+                    );
+                    checksCount += 1;
+                    if (result != dimension) {
+                        fail(name + " buffer", "dimension " + to_string(result));
+                        continue;
+                    }
+                    for (unsigned int row = 0; row < dimension; row += 1) {
+                        const UnsignedByte* expected = format == BoardFormat::cellBytes ?
+                            baseline.buffer()[row] : baseline.packed() + row * baseline.packedStride();
+                        if (memcmp(&output[row * stride], expected, rowLength) != 0) {
+                            fail(name + " buffer format " + to_string(formatIndex), "row " + to_string(row));
+                            break;
+                        }
+                    }
+                }
+                // Version checks
+                UnsignedByte version = QRMatrixEncoder::getVersion(&segment, 1, level, extraMode);
+                UnsignedByte expectedDimension = sample.isMicro ? Common::microDimensionByVersion(version) : Common::dimensionByVersion(version);
+                EncodingMode mode = sample.mode;
+                unsigned int length = sample.data.length();
+                checksCount += 1;
+                if (dimension != expectedDimension ||
+                    !QRMatrixEncoder::fits(version, &segment, 1, level, extraMode) ||
+                    (version > 1 && QRMatrixEncoder::fits(version - 1, &segment, 1, level, extraMode)) ||
+                    QRMatrixEncoder::predictVersion(&mode, &length, 1, level, extraMode) != version) {
+                    fail(name, "version " + to_string(version));
+                }
+                // Batch (below)
+                items[count] = QRMatrixBatchItem(&segment, 1, level);
+                items[count].extraMode = extraMode;
+                items[count].maskId = maskId;
+                names[count] = name;
+                count += 1;
+            }
+        }
+    }
+    checksCount += 1;
+    if (cache.hitCount() != count || cache.missCount() != count) {
+        fail("Cache", "hits " + to_string(cache.hitCount()) + ", misses " + to_string(cache.missCount()) + " of " + to_string(count));
+    }
+    QRMatrixBoard boards[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    QRMatrixStatus statuses[ROUNDTRIP_SAMPLES_COUNT * 4 * 2];
+    QRMatrixEncoder::encodeBatch(pool, items, count, boards, statuses);
+    for (unsigned int index = 0; index < count; index += 1) {
+        if (!statuses[index].isSucceeded()) {
+            checksCount += 1;
+            fail(names[index] + " batch", statuses[index].message());
+            continue;
+        }
+        checkSameBoard(names[index] + " batch", boards[index], baselines[index]);
+    }
+}
+
+/// Batch of fixed layout (error corrections of `POLYNOMIAL_LANES` symbols at once) gives the same cells
+/// as `QRMatrixEncoder::encode` of each symbol
+void checkLanes(QRMatrixEncoderContext& context, QRMatrixThreadPool& pool) {
+    const UnsignedByte versions[4] = { 2, 7, 22, 2 };
+    for (unsigned int index = 0; index < 4; index += 1) {
+        bool isMicro = index == 3;
+        UnsignedByte version = versions[index];
+        ErrorCorrectionLevel level = ROUNDTRIP_LEVELS[index % 3];
+        QRMatrixExtraMode extraMode = isMicro ? QRMatrixExtraMode(EncodingExtraMode::microQr) : QRMatrixExtraMode();
+        for (unsigned int maskIndex = 0; maskIndex < 2; maskIndex += 1) {
+            UnsignedByte maskId = maskIndex == 0 ? 0xFF : 1;
+            string name = "Lanes " + string(isMicro ? "M" : "V") + to_string(version) + " mask " + to_string(maskId);
+            QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(version, level, isMicro, maskId);
+            // More items than lanes: the last group is not full
+            const unsigned int count = 11;
+            string numbers[count];
+            QRMatrixSegment segments[count];
+            QRMatrixBatchItem items[count];
+            for (unsigned int itemIndex = 0; itemIndex < count; itemIndex += 1) {
+                numbers[itemIndex] = to_string(7919 * (itemIndex + 1) * (index + 3) + maskIndex);
+                segments[itemIndex].fill(EncodingMode::numeric, (const UnsignedByte*)numbers[itemIndex].data(), numbers[itemIndex].length());
+                items[itemIndex] = QRMatrixBatchItem(&segments[itemIndex], 1, level);
+                items[itemIndex].extraMode = extraMode;
+            }
+            QRMatrixBoard boards[count];
+            QRMatrixStatus statuses[count];
+            QRMatrixEncoder::encodeBatch(pool, layout, items, count, boards, statuses);
+            for (unsigned int itemIndex = 0; itemIndex < count; itemIndex += 1) {
+                string itemName = name + " #" + numbers[itemIndex];
+                if (!statuses[itemIndex].isSucceeded()) {
+                    checksCount += 1;
+                    fail(itemName, statuses[itemIndex].message());
+                    continue;
+                }
+                QRMatrixBoard baseline = QRMatrixEncoder::encode(context, &segments[itemIndex], 1, level, extraMode, version, maskId);
+                checkSameBoard(itemName, boards[itemIndex], baseline);
+            }
+        }
+    }
+}
+
+/// Names of outputs of `render`
+#define ROUNDTRIP_RENDERS_COUNT 16
+const char* ROUNDTRIP_RENDER_NAMES[ROUNDTRIP_RENDERS_COUNT] = {
+    "raster gray1", "raster gray8", "raster rgb24", "raster rgba32", "raster rows", "PNG stored", "PNG fixed Huffman",
+    "SVG", "SVG detail", "text half blocks", "text ASCII blocks", "text cell colors", "text cell types",
+    "runs", "runs of finder", "atlas"
+};
+
+/// Raster image of `board` (rows are `style.rowBytes` bytes)
+string raster(QRMatrixBoard& board, const QRMatrixRasterStyle& style) {
+    unsigned int stride = style.rowBytes(board.dimension());
+    string result(stride * style.width(board.dimension()), '\0');
+    QRMatrixRaster::render(board, style, (UnsignedByte*)&result[0], stride);
+    return result;
+}
+
+/// Runs of black cells as bytes (row, column, length)
+string runs(QRMatrixBoardRuns& boardRuns) {
+    string result;
+    BoardRun run;
+    while (boardRuns.next(run)) {
+        result.push_back((char)run.row);
+        result.push_back((char)run.column);
+        result.push_back((char)run.length);
+    }
+    return result;
+}
+
+/// Output of all renderers (`ROUNDTRIP_RENDER_NAMES`) for `board`
+void render(QRMatrixBoard& board, QRMatrixThreadPool& pool, string* outputs) {
+    QRMatrixRasterStyle colored(RasterFormat::rgb24, 1, 2);
+    colored.darkColor = 0x203040FF;
+    colored.lightColor = 0xF0E8D0FF;
+    outputs[0] = raster(board, QRMatrixRasterStyle(RasterFormat::gray1, 3));
+    outputs[1] = raster(board, QRMatrixRasterStyle(RasterFormat::gray8, 2));
+    outputs[2] = raster(board, colored);
+    outputs[3] = raster(board, QRMatrixRasterStyle(RasterFormat::rgba32, 2, 1));
+    QRMatrixRasterRows rows(board, QRMatrixRasterStyle(RasterFormat::gray8, 2));
+    outputs[4].clear();
+    for (const UnsignedByte* row = rows.next(); row != nullptr; row = rows.next()) {
+        outputs[4].append((const char*)row, rows.rowBytes());
+    }
+    for (unsigned int index = 0; index < 2; index += 1) {
+        string& output = outputs[5 + index];
+        output.clear();
+        QRMatrixPng::write(board, index == 0 ? QRMatrixRasterStyle(RasterFormat::gray1, 2) : colored,
+            [&output](const UnsignedByte* data, unsigned int length) {
+                output.append((const char*)data, length);
+            }, index == 0 ? PngCompression::stored : PngCompression::fixedHuffman);
+    }
+    outputs[7] = QRMatrixSvgWriter::svg(board, 4);
+    outputs[8].clear();
+    QRMatrixSvgWriter::writeDetail(board, [&outputs](const char* text, unsigned int length) {
+        outputs[8].append(text, length);
+    });
+    outputs[9] = QRMatrixText::text(board, TextMode::halfBlocks, 2);
+    outputs[10] = QRMatrixText::text(board, TextMode::asciiBlocks);
+    outputs[11] = QRMatrixText::text(board, TextMode::cellColors);
+    outputs[12] = QRMatrixText::text(board, TextMode::cellTypes);
+    QRMatrixBoardRuns allRuns(board);
+    outputs[13] = runs(allRuns);
+    QRMatrixBoardRuns finderRuns(board, BoardCell::finder);
+    outputs[14] = runs(finderRuns);
+    QRMatrixBoard copies[3] = { board, board, board };
+    QRMatrixAtlas atlas(copies, 3, QRMatrixRasterStyle(RasterFormat::gray8, 2), 2, 5, 3);
+    outputs[15] = string(atlas.rowBytes() * atlas.height(), '\0');
+    atlas.render(pool, (UnsignedByte*)&outputs[15][0], atlas.rowBytes());
+}
+
+/// Renderers draw the cells of `board` (reference drawings made cell by cell)
+void checkRenderOutputs(QRMatrixBoard& board, string* outputs) {
+    UnsignedByte dimension = board.dimension();
+    QRMatrixRasterStyle style(RasterFormat::gray8, 2);
+    unsigned int width = style.width(dimension);
+    string image(width * width, '\xFF');
+    string text;
+    string cellRuns;
+    for (unsigned int row = 0; row < dimension; row += 1) {
+        for (unsigned int column = 0; column < dimension; column += 1) {
+            bool isDark = board.isDark(row, column);
+            text += isDark ? "##" : "  ";
+            if (isDark && (column == 0 || !board.isDark(row, column - 1))) {
+                unsigned int end = column;
+                while (end < dimension && board.isDark(row, end)) {
+                    end += 1;
+                }
+                cellRuns.push_back((char)row);
+                cellRuns.push_back((char)column);
+                cellRuns.push_back((char)(end - column));
+            }
+            for (unsigned int pixel = 0; pixel < 4 && isDark; pixel += 1) {
+                unsigned int y = (row + style.quietZone) * 2 + pixel / 2;
+                unsigned int x = (column + style.quietZone) * 2 + pixel % 2;
+                image[y * width + x] = '\0';
+            }
+        }
+        text += "\n";
+    }
+    checksCount += 1;
+    if (outputs[1] != image) {
+        fail("Render", "raster gray8 differs from cells");
+    }
+    checksCount += 1;
+    if (outputs[4] != outputs[1]) {
+        fail("Render", "raster rows differ from raster image");
+    }
+    checksCount += 1;
+    if (outputs[10] != text) {
+        fail("Render", "ASCII text differs from cells");
+    }
+    checksCount += 1;
+    if (outputs[13] != cellRuns) {
+        fail("Render", "runs differ from cells");
+    }
+    // Atlas: symbols at (0, 0), (width + 5, 0), (0, width + 3)
+    const unsigned int lefts[3] = { 0, width + 5, 0 };
+    const unsigned int tops[3] = { 0, 0, width + 3 };
+    unsigned int atlasRowBytes = (width * 2 + 5);
+    checksCount += 1;
+    for (unsigned int index = 0; index < 3; index += 1) {
+        for (unsigned int row = 0; row < width; row += 1) {
+            if (outputs[15].compare((tops[index] + row) * atlasRowBytes + lefts[index], width, image, row * width, width) != 0) {
+                fail("Render", "atlas symbol " + to_string(index) + " row " + to_string(row));
+                index = 3;
+                break;
+            }
+        }
+    }
+    QRMatrixBoard copies[3] = { board, board, board };
+    QRMatrixAtlas atlas(copies, 3, style, 2, 5, 3);
+    string single(atlas.rowBytes() * atlas.height(), '\0');
+    atlas.render((UnsignedByte*)&single[0], atlas.rowBytes());
+    checksCount += 1;
+    if (single != outputs[15]) {
+        fail("Render", "atlas on pool differs from atlas on 1 thread");
+    }
+}
+
+/// Renderers give the same output, byte by byte, for boards of all encoding paths of a fixed input
+void checkRenderers(QRMatrixEncoderContext& context, QRMatrixThreadPool& pool) {
+    for (unsigned int sampleIndex = 0; sampleIndex < 2; sampleIndex += 1) {
+        bool isMicro = sampleIndex == 1;
+        string data = isMicro ? "MICRO QR 42" : repeated(ROUNDTRIP_TEXT, 120);
+        QRMatrixSegment segment(isMicro ? EncodingMode::alphaNumeric : EncodingMode::byte, (const UnsignedByte*)data.data(), data.length());
+        ErrorCorrectionLevel level = ErrorCorrectionLevel::medium;
+        QRMatrixExtraMode extraMode = isMicro ? QRMatrixExtraMode(EncodingExtraMode::microQr) : QRMatrixExtraMode();
+        QRMatrixBoard baseline = QRMatrixEncoder::encode(context, &segment, 1, level, extraMode);
+        string expected[ROUNDTRIP_RENDERS_COUNT];
+        render(baseline, pool, expected);
+        checkRenderOutputs(baseline, expected);
+
+        const unsigned int pathsCount = 6;
+        const char* pathNames[pathsCount] = { "plain", "cache hit", "compact symbol", "pool", "batch", "lanes" };
+        QRMatrixBoard boards[pathsCount];
+        boards[0] = QRMatrixEncoder::encode(&segment, 1, level, extraMode);
+        QRMatrixCache cache(1024 * 1024);
+        QRMatrixEncoder::encode(cache, context, &segment, 1, level, extraMode);
+        boards[1] = QRMatrixEncoder::encode(cache, context, &segment, 1, level, extraMode);
+        boards[2] = QRMatrixEncoder::encodeCompact(context, &segment, 1, level, extraMode).board();
+        boards[3] = QRMatrixEncoder::encode(context, pool, &segment, 1, level, extraMode);
+        QRMatrixBatchItem item(&segment, 1, level);
+        item.extraMode = extraMode;
+        QRMatrixStatus status;
+        QRMatrixEncoder::encodeBatch(pool, &item, 1, &boards[4], &status);
+        UnsignedByte version = QRMatrixEncoder::getVersion(&segment, 1, level, extraMode);
+        QRMatrixLayout layout = QRMatrixEncoder::prepareLayout(version, level, isMicro);
+        QRMatrixEncoder::encodeBatch(pool, layout, &item, 1, &boards[5], &status);
+        for (unsigned int path = 0; path < pathsCount; path += 1) {
+            string name = string(isMicro ? "MicroQR" : "QR") + " render of " + pathNames[path];
+            checkSameBoard(name, boards[path], baseline);
+            string outputs[ROUNDTRIP_RENDERS_COUNT];
+            render(boards[path], pool, outputs);
+            for (unsigned int index = 0; index < ROUNDTRIP_RENDERS_COUNT; index += 1) {
+                checksCount += 1;
+                if (outputs[index] != expected[index]) {
+                    fail(name, string(ROUNDTRIP_RENDER_NAMES[index]) + " differs");
+                }
+            }
+        }
+    }
+}
+
+void checkStatus(const string& name, QRMatrixStatus status, EncodingStatus expected) {
+    checksCount += 1;
+    if (status.code != expected) {
+        fail(name, string("unexpected status: ") + status.message());
+    }
+}
+
+/// Invalid input reports errors instead of being fixed silently
+void checkInvalidInput(QRMatrixEncoderContext& context) {
+    QRMatrixSegment segment(EncodingMode::numeric, (const UnsignedByte*)"12345", 5);
+    QRMatrixStructuredAppend parts[16];
+    unsigned int partsCount = 0;
+    checkStatus("Split of max version 0", QRMatrixEncoder::trySplit(parts, &partsCount, &segment, 1, ErrorCorrectionLevel::low, 0), EncodingStatus::invalidVersion);
+    checkStatus("Split of max version 41", QRMatrixEncoder::trySplit(parts, &partsCount, &segment, 1, ErrorCorrectionLevel::low, 41), EncodingStatus::invalidVersion);
+    QRMatrixSegment empty[2];
+    checkStatus("Split of empty segments", QRMatrixEncoder::trySplit(parts, &partsCount, empty, 2, ErrorCorrectionLevel::low, 40), EncodingStatus::noInput);
+    QRMatrixLayout layout;
+    checkStatus("Layout of mask 9", QRMatrixEncoder::tryPrepareLayout(layout, 5, ErrorCorrectionLevel::low, false, 9), EncodingStatus::invalidMask);
+    checkStatus("MicroQR layout of mask 4", QRMatrixEncoder::tryPrepareLayout(layout, 3, ErrorCorrectionLevel::low, true, 4), EncodingStatus::invalidMask);
+    checkStatus("MicroQR layout of level H", QRMatrixEncoder::tryPrepareLayout(layout, 1, ErrorCorrectionLevel::high, true), EncodingStatus::levelNotAvailable);
+    QRMatrixBoard board;
+    checkStatus("Empty plan", QRMatrixEncoder::tryEncode(context, board, QRMatrixEncodePlan()), EncodingStatus::invalidObject);
+    checkStatus("Empty layout", QRMatrixEncoder::tryEncode(context, board, QRMatrixLayout(), &segment, 1), EncodingStatus::invalidObject);
+    checkStatus("Empty prefix", QRMatrixEncoder::tryEncode(context, board, QRMatrixPrefixTemplate(), &segment, 1), EncodingStatus::invalidObject);
+    QRMatrixSequence sequence;
+    checkStatus("Empty sequence", QRMatrixEncoder::tryEncode(context, sequence, &segment, 1), EncodingStatus::invalidObject);
+}
+
+int main() {
+    QRMatrixEncoderContext context;
+    QRMatrixThreadPool pool;
+    checkVersions(context, false);
+    checkVersions(context, true);
+    checkStructuredAppend(pool);
+    checkPrefix(context);
+    checkSequence(context);
+    checkEncodingPaths(context, pool);
+    checkLanes(context, pool);
+    checkRenderers(context, pool);
+    checkInvalidInput(context);
+    printf("%u checks, %u failed\n", checksCount, failuresCount);
+    return failuresCount == 0 ? 0 : 1;
+}
@@ -22,7 +22,6 @@
 
 #include "numericencoder.h"
 #include "../common.h"
-#include <string>
 
 using namespace QRMatrix;
 
@@ -39,9 +38,11 @@ unsigned int NumericEncoder::encode(const UnsignedByte* text, unsigned int lengt
         } else {
             groupLen = 1;
         }
-        std::string group = std::string((char*)text, index, groupLen);
+        unsigned int value = 0;
+        for (unsigned int digit = 0; digit < groupLen; digit += 1) {
+            value = value * 10 + (text[index + digit] - '0');
+        }
         index += groupLen;
-        unsigned int value = std::stoi(group);
         unsigned int bitLen;
         switch (groupLen) {
         case 3:
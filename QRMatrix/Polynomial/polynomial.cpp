@@ -23,6 +23,7 @@
 #include "polynomial.h"
 #include "../Exception/qrmatrixexception.h"
 #include "../common.h"
+#include <cstring>
 
 using namespace QRMatrix;
 
@@ -54,49 +55,146 @@ UnsignedByte Polynomial_Power(UnsignedByte value, UnsignedByte power) {
     return Polynomial_Exp[(Polynomial_Log[value] * power) % 255];
 }
 
-Polynomial Polynomial_PolyMultiple(Polynomial self, Polynomial other) {
-    Polynomial result(self.length + other.length - 1);
-    for (unsigned int jndex = 0; jndex < other.length; jndex += 1) {
-        for (unsigned int index = 0; index < self.length; index += 1) {
-            result.terms[index + jndex] ^= Polynomial_Multiple(self.terms[index], other.terms[jndex]);
+/// Build generator polynomial of `count` degree into `result` (`count + 1` terms, highest degree first)
+void Polynomial_getGeneratorPoly(unsigned int count, UnsignedByte* result) {
+    result[0] = 1;
+    for (unsigned int index = 0; index < count; index += 1) {
+        // Multiple by (x - 2^index)
+        UnsignedByte factor = Polynomial_Power(2, index);
+        result[index + 1] = Polynomial_Multiple(result[index], factor);
+        for (unsigned int jndex = index; jndex > 0; jndex -= 1) {
+            result[jndex] ^= Polynomial_Multiple(result[jndex - 1], factor);
         }
     }
-    return result;
 }
 
-Polynomial Polynomial_getGeneratorPoly(unsigned int count) {
-    Polynomial result(1);
-    result.terms[0] = 1;
+/// Generator polynomials of degree 0...POLYNOMIAL_CACHED_DEGREE (QR uses 30 EC codewords per block maximum)
+#define POLYNOMIAL_CACHED_DEGREE 30
+UnsignedByte Polynomial_Generators[POLYNOMIAL_CACHED_DEGREE + 1][POLYNOMIAL_CACHED_DEGREE + 1];
+
+bool initGenerators = []() {
+    for (unsigned int count = 0; count <= POLYNOMIAL_CACHED_DEGREE; count += 1) {
+        Polynomial_getGeneratorPoly(count, Polynomial_Generators[count]);
+    }
+    return true;
+} ();
+
+void Polynomial::getErrorCorrections(const UnsignedByte* data, unsigned int length, unsigned int count, UnsignedByte* result) {
     for (unsigned int index = 0; index < count; index += 1) {
-        Polynomial arg(2);
-        arg.terms[0] = 1;
-        arg.terms[1] = Polynomial_Power(2, index);
-        result = Polynomial_PolyMultiple(result, arg);
+        result[index] = 0;
     }
-    return result;
+    Polynomial::continueErrorCorrections(data, length, count, result);
 }
 
-Polynomial Polynomial::getErrorCorrections(unsigned int count) {
+void Polynomial::continueErrorCorrections(const UnsignedByte* data, unsigned int length, unsigned int count, UnsignedByte* result) {
     if (length + count > 255) {
         throw QR_EXCEPTION("Internal error: invalid message length to calculate Error Corrections");
     }
-    Polynomial gen = Polynomial_getGeneratorPoly(count);
-    Polynomial buffer(length + gen.length - 1);
-    for (unsigned int index = 0; index < length; index += 1) {
-        buffer.terms[index] = terms[index];
+    if (count == 0) {
+        return;
     }
+    UnsignedByte buffer[256];
+    const UnsignedByte* gen = nullptr;
+    if (count <= POLYNOMIAL_CACHED_DEGREE) {
+        gen = Polynomial_Generators[count];
+    } else {
+        Polynomial_getGeneratorPoly(count, buffer);
+        gen = buffer;
+    }
+    // Remainder of polynomial division (LFSR)
     for (unsigned int index = 0; index < length; index += 1) {
-        UnsignedByte coef = buffer.terms[index];
+        UnsignedByte coef = data[index] ^ result[0];
+        for (unsigned int jndex = 1; jndex < count; jndex += 1) {
+            result[jndex - 1] = result[jndex];
+        }
+        result[count - 1] = 0;
         if (coef != 0) {
-            for (unsigned int jndex = 1; jndex < gen.length; jndex += 1) {
-                buffer.terms[index + jndex] ^= Polynomial_Multiple(gen.terms[jndex], coef);
+            unsigned int coefLog = Polynomial_Log[coef];
+            for (unsigned int jndex = 0; jndex < count; jndex += 1) {
+                UnsignedByte term = gen[jndex + 1];
+                if (term != 0) {
+                    result[jndex] ^= Polynomial_Exp[(Polynomial_Log[term] + coefLog) % 255];
+                }
             }
         }
     }
-    Polynomial result(buffer.length - length);
-    for (unsigned int index = length; index < buffer.length; index += 1) {
-        result.terms[index - length] = buffer.terms[index];
+}
+
+/// Number of 64 bits words of 1 byte of all lanes
+#define POLYNOMIAL_LANE_WORDS (POLYNOMIAL_LANES / 8)
+
+void Polynomial::getErrorCorrectionsLanes(const UnsignedByte* data, unsigned int length, unsigned int count, UnsignedByte* result) {
+    if (length + count > 255) {
+        throw QR_EXCEPTION("Internal error: invalid message length to calculate Error Corrections");
+    }
+    if (count == 0) {
+        return;
     }
+    UnsignedByte buffer[256];
+    const UnsignedByte* gen = nullptr;
+    if (count <= POLYNOMIAL_CACHED_DEGREE) {
+        gen = Polynomial_Generators[count];
+    } else {
+        Polynomial_getGeneratorPoly(count, buffer);
+        gen = buffer;
+    }
+    // Same LFSR as `continueErrorCorrections` on 8 lanes per 64 bits word. Log/exp lookups (which depend on each lane
+    // value) are replaced by carry-less multiplication: coef * term = XOR of (coef * 2^bit) for each bit of term.
+    // Terms are the same for all lanes, so all lanes of a word are processed by the same instructions.
+    // Remainder is a ring of `count` rows: row `head` is the highest degree term.
+    Unsigned8Bytes remainder[256][POLYNOMIAL_LANE_WORDS];
+    memset(remainder, 0, sizeof(remainder[0]) * count);
+    Unsigned8Bytes powers[8][POLYNOMIAL_LANE_WORDS];
+    const Unsigned8Bytes lowBits = 0x7F7F7F7F7F7F7F7FULL;
+    const Unsigned8Bytes highBits = 0x0101010101010101ULL;
+    unsigned int head = 0;
+    for (unsigned int index = 0; index < length; index += 1) {
+        Unsigned8Bytes message[POLYNOMIAL_LANE_WORDS];
+        memcpy(message, &data[index * POLYNOMIAL_LANES], POLYNOMIAL_LANES);
+        for (unsigned int word = 0; word < POLYNOMIAL_LANE_WORDS; word += 1) {
+            powers[0][word] = message[word] ^ remainder[head][word];
+            remainder[head][word] = 0;
+        }
+        for (unsigned int bit = 1; bit < 8; bit += 1) {
+            for (unsigned int word = 0; word < POLYNOMIAL_LANE_WORDS; word += 1) {
+                // value * 2 of each byte in GF(256) (0x11D reduces to 0x1D)
+                Unsigned8Bytes value = powers[bit - 1][word];
+                powers[bit][word] = ((value & lowBits) << 1) ^ (((value >> 7) & highBits) * 0x1D);
+            }
+        }
+        // Shift: old highest term becomes the lowest (0) term
+        head += 1;
+        if (head == count) {
+            head = 0;
+        }
+        unsigned int row = head;
+        for (unsigned int jndex = 0; jndex < count; jndex += 1) {
+            UnsignedByte term = gen[jndex + 1];
+            Unsigned8Bytes product[POLYNOMIAL_LANE_WORDS] = {};
+            for (unsigned int bit = 0; bit < 8; bit += 1) {
+                if ((term >> bit) & 1) {
+                    for (unsigned int word = 0; word < POLYNOMIAL_LANE_WORDS; word += 1) {
+                        product[word] ^= powers[bit][word];
+                    }
+                }
+            }
+            for (unsigned int word = 0; word < POLYNOMIAL_LANE_WORDS; word += 1) {
+                remainder[row][word] ^= product[word];
+            }
+            row += 1;
+            if (row == count) {
+                row = 0;
+            }
+        }
+    }
+    for (unsigned int jndex = 0; jndex < count; jndex += 1) {
+        memcpy(&result[jndex * POLYNOMIAL_LANES], remainder[(head + jndex) % count], POLYNOMIAL_LANES);
+    }
+}
+
+Polynomial Polynomial::getErrorCorrections(unsigned int count) {
+    Polynomial result(count);
+    Polynomial::getErrorCorrections(terms, length, count, result.terms);
     return result;
 }
 
@@ -127,3 +225,145 @@ void Polynomial::operator=(Polynomial other) {
         terms[index] = other.terms[index];
     }
 }
+
+// ERROR CORRECTING ================================================================================
+
+UnsignedByte Polynomial_Divide(UnsignedByte left, UnsignedByte right) {
+    if (left == 0) {
+        return 0;
+    }
+    return Polynomial_Exp[(Polynomial_Log[left] + 255 - Polynomial_Log[right]) % 255];
+}
+
+/// Value of polynomial (`length` terms, lowest degree first) at `value`
+UnsignedByte Polynomial_Evaluate(const UnsignedByte* terms, unsigned int length, UnsignedByte value) {
+    UnsignedByte result = 0;
+    for (unsigned int index = length; index > 0; index -= 1) {
+        result = Polynomial_Multiple(result, value) ^ terms[index - 1];
+    }
+    return result;
+}
+
+/// Syndromes of block (its values at 2^0...2^(count - 1)).
+/// Terms are added codeword by codeword in log domain: the term of codeword of degree `d` at 2^j is
+/// 2^(log(codeword) + j * d), so each term takes 1 addition & 1 table lookup.
+/// @return false if all syndromes are 0 (no error).
+bool Polynomial_Syndromes(const UnsignedByte* codewords, unsigned int length, unsigned int count, UnsignedByte* result) {
+    for (unsigned int index = 0; index < count; index += 1) {
+        result[index] = 0;
+    }
+    for (unsigned int index = 0; index < length; index += 1) {
+        UnsignedByte codeword = codewords[index];
+        if (codeword == 0) {
+            continue;
+        }
+        unsigned int degree = length - 1 - index;
+        unsigned int exponent = Polynomial_Log[codeword];
+        for (unsigned int jndex = 0; jndex < count; jndex += 1) {
+            result[jndex] ^= Polynomial_Exp[exponent];
+            exponent += degree;
+            if (exponent >= 255) {
+                exponent -= 255;
+            }
+        }
+    }
+    for (unsigned int index = 0; index < count; index += 1) {
+        if (result[index] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int Polynomial::correctErrors(UnsignedByte* codewords, unsigned int length, unsigned int count) {
+    if (length > 255 || count > length) {
+        throw QR_EXCEPTION("Internal error: invalid block length to correct errors");
+    }
+    UnsignedByte syndromes[256];
+    if (!Polynomial_Syndromes(codewords, length, count, syndromes)) {
+        return 0;
+    }
+    // Error locator (Berlekamp-Massey), lowest degree first
+    UnsignedByte locator[256] = { 1 };
+    UnsignedByte previous[256] = { 1 };
+    UnsignedByte saved[256];
+    unsigned int degree = 0;
+    unsigned int shift = 1;
+    UnsignedByte previousDiscrepancy = 1;
+    for (unsigned int index = 0; index < count; index += 1) {
+        UnsignedByte discrepancy = syndromes[index];
+        for (unsigned int jndex = 1; jndex <= degree; jndex += 1) {
+            discrepancy ^= Polynomial_Multiple(locator[jndex], syndromes[index - jndex]);
+        }
+        if (discrepancy == 0) {
+            shift += 1;
+            continue;
+        }
+        UnsignedByte factor = Polynomial_Divide(discrepancy, previousDiscrepancy);
+        bool isGrowing = 2 * degree <= index;
+        if (isGrowing) {
+            memcpy(saved, locator, count + 1);
+        }
+        for (unsigned int jndex = 0; jndex + shift <= count; jndex += 1) {
+            locator[jndex + shift] ^= Polynomial_Multiple(factor, previous[jndex]);
+        }
+        if (isGrowing) {
+            degree = index + 1 - degree;
+            memcpy(previous, saved, count + 1);
+            previousDiscrepancy = discrepancy;
+            shift = 1;
+        } else {
+            shift += 1;
+        }
+    }
+    if (degree == 0 || 2 * degree > count) {
+        return -1;
+    }
+    // Error evaluator: syndromes * locator mod x^count
+    UnsignedByte evaluator[256];
+    for (unsigned int index = 0; index < count; index += 1) {
+        evaluator[index] = 0;
+        for (unsigned int jndex = 0; jndex <= index && jndex <= degree; jndex += 1) {
+            evaluator[index] ^= Polynomial_Multiple(locator[jndex], syndromes[index - jndex]);
+        }
+    }
+    // Formal derivative of locator (odd terms)
+    UnsignedByte derivative[256];
+    for (unsigned int index = 0; index < degree; index += 1) {
+        derivative[index] = (index % 2 == 0) ? locator[index + 1] : 0;
+    }
+    // Error positions (Chien search) & values (Forney)
+    unsigned int positions[128];
+    UnsignedByte values[128];
+    unsigned int found = 0;
+    for (unsigned int index = 0; index < length && found <= degree; index += 1) {
+        // Codeword `index` is the term of degree `length - 1 - index`
+        unsigned int power = length - 1 - index;
+        UnsignedByte inverse = Polynomial_Exp[(255 - power) % 255];
+        if (Polynomial_Evaluate(locator, degree + 1, inverse) != 0) {
+            continue;
+        }
+        UnsignedByte denominator = Polynomial_Evaluate(derivative, degree, inverse);
+        if (denominator == 0 || found == degree) {
+            return -1;
+        }
+        UnsignedByte numerator = Polynomial_Evaluate(evaluator, count, inverse);
+        positions[found] = index;
+        values[found] = Polynomial_Multiple(Polynomial_Exp[power], Polynomial_Divide(numerator, denominator));
+        found += 1;
+    }
+    if (found != degree) {
+        return -1;
+    }
+    for (unsigned int index = 0; index < found; index += 1) {
+        codewords[positions[index]] ^= values[index];
+    }
+    // Fixed block must be a valid code word
+    if (Polynomial_Syndromes(codewords, length, count, syndromes)) {
+        for (unsigned int index = 0; index < found; index += 1) {
+            codewords[positions[index]] ^= values[index];
+        }
+        return -1;
+    }
+    return (int)found;
+}
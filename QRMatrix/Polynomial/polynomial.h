@@ -27,6 +27,9 @@
 
 #include "../constants.h"
 
+/// Number of messages processed together by `Polynomial::getErrorCorrectionsLanes`
+#define POLYNOMIAL_LANES 16
+
 namespace QRMatrix {
 
     struct Polynomial {
@@ -40,6 +43,60 @@ namespace QRMatrix {
 
         Polynomial getErrorCorrections(unsigned int count);
 
+        /// Calculate `count` error correction codewords of `length` bytes `data` into `result`.
+        /// Generator polynomials are cached, so this does not allocate memory.
+        static void getErrorCorrections(
+            /// Message codewords
+            const UnsignedByte* data,
+            /// Number of message codewords
+            unsigned int length,
+            /// Number of error correction codewords
+            unsigned int count,
+            /// Buffer of `count` bytes to write result into
+            UnsignedByte* result
+        );
+
+        /// Continue calculating error correction codewords with `length` more bytes of message.
+        /// `result` holds the remainder of previous message codewords (all 0 for an empty message)
+        /// and is updated in place, so the remainder of a fixed message prefix can be computed once and reused.
+        static void continueErrorCorrections(
+            /// Next message codewords
+            const UnsignedByte* data,
+            /// Number of next message codewords
+            unsigned int length,
+            /// Number of error correction codewords
+            unsigned int count,
+            /// Buffer of `count` bytes: remainder of previous codewords, updated with result
+            UnsignedByte* result
+        );
+
+        /// Calculate `count` error correction codewords of `POLYNOMIAL_LANES` messages of the same `length` at once.
+        /// Messages are interleaved byte by byte (structure of arrays): byte `index` of message `lane` is
+        /// `data[index * POLYNOMIAL_LANES + lane]`, and so is `result`. Every step is the same for all messages,
+        /// so 8 lanes are processed by each 64 bits operation (no table lookup). Unused lanes may hold any bytes.
+        static void getErrorCorrectionsLanes(
+            /// Message codewords (`length * POLYNOMIAL_LANES` bytes)
+            const UnsignedByte* data,
+            /// Number of message codewords of each message
+            unsigned int length,
+            /// Number of error correction codewords
+            unsigned int count,
+            /// Buffer of `count * POLYNOMIAL_LANES` bytes to write result into
+            UnsignedByte* result
+        );
+
+
+        /// Find & fix errors of a block (message codewords followed by `count` error correction codewords) in place.
+        /// Up to `count / 2` wrong codewords are fixed.
+        /// @return Number of fixed codewords, or -1 if errors can not be fixed (block is not changed).
+        static int correctErrors(
+            /// Block codewords
+            UnsignedByte* codewords,
+            /// Number of codewords of block (message & error correction)
+            unsigned int length,
+            /// Number of error correction codewords
+            unsigned int count
+        );
     };
 
 }
@@ -0,0 +1,224 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixatlas.h"
+#include "../Exception/qrmatrixexception.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace QRMatrix;
+
+namespace QRMatrix {
+
+struct QRMatrixAtlas_Symbol {
+    /// Color plane of board
+    const UnsignedByte* bits;
+    unsigned int stride;
+    UnsignedByte dimension;
+    /// Top left pixel of image
+    unsigned int x;
+    unsigned int y;
+    /// Number of pixels of each side of image (0 for empty board)
+    unsigned int width;
+};
+
+}
+
+/// Cells row of `symbol` drawn in row `y` of atlas (-1 for none: outside of symbol or quiet zone)
+int QRMatrixAtlas_cellsRow(const QRMatrixAtlas_Symbol& symbol, const QRMatrixRasterStyle& style, unsigned int y) {
+    if (y < symbol.y || y >= symbol.y + symbol.width) {
+        return -1;
+    }
+    unsigned int row = (y - symbol.y) / style.scale;
+    if (row < style.quietZone || row >= style.quietZone + symbol.dimension) {
+        return -1;
+    }
+    return (int)(row - style.quietZone);
+}
+
+QRMatrixAtlas::~QRMatrixAtlas() {
+    delete[] symbols_;
+}
+
+QRMatrixAtlas::QRMatrixAtlas(
+    QRMatrixBoard* boards,
+    unsigned int count,
+    const QRMatrixRasterStyle& style,
+    unsigned int columns,
+    unsigned int horizontalGutter,
+    unsigned int verticalGutter
+): style_(style) {
+    symbols_ = nullptr;
+    if (columns == 0) {
+        throw QR_EXCEPTION("Number of columns must be > 0.");
+    }
+    prepare(boards, count);
+    unsigned int tile = 0;
+    for (unsigned int index = 0; index < count; index += 1) {
+        tile = std::max(tile, symbols_[index].width);
+    }
+    for (unsigned int index = 0; index < count; index += 1) {
+        symbols_[index].x = (index % columns) * (tile + horizontalGutter);
+        symbols_[index].y = (index / columns) * (tile + verticalGutter);
+    }
+    unsigned int rows = (count + columns - 1) / columns;
+    unsigned int usedColumns = std::min(count, columns);
+    finish(
+        usedColumns > 0 ? usedColumns * tile + (usedColumns - 1) * horizontalGutter : 0,
+        rows > 0 ? rows * tile + (rows - 1) * verticalGutter : 0
+    );
+}
+
+QRMatrixAtlas::QRMatrixAtlas(
+    QRMatrixBoard* boards,
+    unsigned int count,
+    const QRMatrixRasterStyle& style,
+    const AtlasPlacement* placements,
+    unsigned int width,
+    unsigned int height
+): style_(style) {
+    symbols_ = nullptr;
+    prepare(boards, count);
+    for (unsigned int index = 0; index < count; index += 1) {
+        symbols_[index].x = placements[index].x;
+        symbols_[index].y = placements[index].y;
+    }
+    finish(width, height);
+}
+
+void QRMatrixAtlas::prepare(QRMatrixBoard* boards, unsigned int count) {
+    if (style_.scale == 0) {
+        throw QR_EXCEPTION("Scale must be > 0.");
+    }
+    count_ = count;
+    symbols_ = new QRMatrixAtlas_Symbol [count > 0 ? count : 1];
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixAtlas_Symbol& symbol = symbols_[index];
+        QRMatrixBoard& board = boards[index];
+        symbol.dimension = board.dimension();
+        // Make color plane now: workers only read it
+        symbol.bits = symbol.dimension > 0 ? board.packed() : nullptr;
+        symbol.stride = symbol.dimension > 0 ? board.packedStride() : 0;
+        symbol.width = symbol.dimension > 0 ? style_.width(symbol.dimension) : 0;
+        symbol.x = 0;
+        symbol.y = 0;
+    }
+}
+
+void QRMatrixAtlas::finish(unsigned int minWidth, unsigned int minHeight) {
+    std::sort(symbols_, symbols_ + count_, [](const QRMatrixAtlas_Symbol& left, const QRMatrixAtlas_Symbol& right) {
+        return left.y < right.y;
+    });
+    width_ = minWidth;
+    height_ = minHeight;
+    symbolHeight_ = 0;
+    for (unsigned int index = 0; index < count_; index += 1) {
+        const QRMatrixAtlas_Symbol& symbol = symbols_[index];
+        if (symbol.width == 0) {
+            continue;
+        }
+        width_ = std::max(width_, symbol.x + symbol.width);
+        height_ = std::max(height_, symbol.y + symbol.width);
+        symbolHeight_ = std::max(symbolHeight_, symbol.width);
+    }
+}
+
+unsigned int QRMatrixAtlas::rowBytes() {
+    return style_.pixelsBytes(width_);
+}
+
+// RENDER ==========================================================================================
+
+void QRMatrixAtlas::renderRows(unsigned int top, unsigned int count, UnsignedByte* output, unsigned int stride) {
+    unsigned int bytes = rowBytes();
+    if (stride < bytes) {
+        throw QR_EXCEPTION("Stride must be ≥ number of bytes of image row.");
+    }
+    if (count == 0 || width_ == 0) {
+        return;
+    }
+    // Symbols which may be drawn in row `y - 1` or `y`: `first..<last`
+    const QRMatrixAtlas_Symbol* end = symbols_ + count_;
+    const QRMatrixAtlas_Symbol* first = symbols_;
+    const QRMatrixAtlas_Symbol* last = symbols_;
+    for (unsigned int line = 0; line < count; line += 1) {
+        unsigned int y = top + line;
+        UnsignedByte* row = output + (size_t)line * stride;
+        while (first < end && first->y + symbolHeight_ < y) {
+            first += 1;
+        }
+        while (last < end && last->y <= y) {
+            last += 1;
+        }
+        // Same cells rows as previous row: copy it
+        bool isRepeated = line > 0;
+        for (const QRMatrixAtlas_Symbol* symbol = first; isRepeated && symbol < last; symbol += 1) {
+            isRepeated = QRMatrixAtlas_cellsRow(*symbol, style_, y) == QRMatrixAtlas_cellsRow(*symbol, style_, y - 1);
+        }
+        if (isRepeated) {
+            memcpy(row, row - stride, bytes);
+            continue;
+        }
+        if (style_.format == RasterFormat::gray1 && (width_ % 8) > 0) {
+            row[width_ / 8] = 0;
+        }
+        QRMatrixRaster::fill(row, 0, width_, style_.lightColor, style_.format);
+        for (const QRMatrixAtlas_Symbol* symbol = first; symbol < last; symbol += 1) {
+            int cellsRow = QRMatrixAtlas_cellsRow(*symbol, style_, y);
+            if (cellsRow >= 0) {
+                QRMatrixRaster::renderDarkCells(
+                    symbol->bits + cellsRow * symbol->stride, symbol->dimension, style_,
+                    row, symbol->x + style_.quietZone * style_.scale
+                );
+            }
+        }
+    }
+}
+
+void QRMatrixAtlas::render(UnsignedByte* output, unsigned int stride) {
+    renderRows(0, height_, output, stride);
+}
+
+void QRMatrixAtlas::render(QRMatrixThreadPool& pool, UnsignedByte* output, unsigned int stride) {
+    if (stride < rowBytes()) {
+        throw QR_EXCEPTION("Stride must be ≥ number of bytes of image row.");
+    }
+    if (height_ == 0 || width_ == 0) {
+        return;
+    }
+    // Number of rows of band must make a multiple of 64 bytes (cache line)
+    unsigned int divisor = 64;
+    while (stride % divisor > 0) {
+        divisor /= 2;
+    }
+    unsigned int unit = 64 / divisor;
+    // Some bands per worker to balance
+    unsigned int bandsCount = pool.workerCount() * 4;
+    unsigned int bandHeight = (height_ + bandsCount - 1) / bandsCount;
+    bandHeight = (bandHeight + unit - 1) / unit * unit;
+    bandsCount = (height_ + bandHeight - 1) / bandHeight;
+    pool.run(bandsCount, [this, output, stride, bandHeight](unsigned int, unsigned int index) {
+        unsigned int top = index * bandHeight;
+        unsigned int count = std::min(bandHeight, height_ - top);
+        renderRows(top, count, output + (size_t)top * stride, stride);
+    });
+}
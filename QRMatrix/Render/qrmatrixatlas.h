@@ -0,0 +1,145 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXATLAS_H
+#define QRMATRIXATLAS_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+#include "../qrmatrixthreadpool.h"
+#include "qrmatrixraster.h"
+
+namespace QRMatrix {
+
+    /// Position of image of a symbol (quiet zone included) in atlas: pixel of its top left corner
+    struct AtlasPlacement {
+        unsigned int x;
+        unsigned int y;
+    };
+
+    /// Internal data model
+    struct QRMatrixAtlas_Symbol;
+
+    /// Raster image of many `QRMatrixBoard` (eg. sheet of labels to print).
+    /// Symbols are rendered directly into the atlas image, by horizontal bands of rows:
+    /// each band can be rendered by a different thread, or streamed to an image encoder.
+    /// Pixels outside of symbols have `style.lightColor`.
+    /// Colors of cells are read from the color plane of each board (`QRMatrixBoard::packed()`, made by the constructor),
+    /// so boards must be kept alive & unchanged while the atlas is rendered.
+    class QRMatrixAtlas {
+    public:
+        ~QRMatrixAtlas();
+        /// Symbols in a grid, left to right then top to bottom.
+        /// Each tile has the size of the biggest symbol image; a symbol is at the top left corner of its tile.
+        QRMatrixAtlas(
+            /// Array of symbols (boards of dimension 0 are left empty)
+            QRMatrixBoard* boards,
+            /// Number of symbols
+            unsigned int count,
+            /// Size & colors of each symbol
+            const QRMatrixRasterStyle& style,
+            /// Number of tiles of each row of grid
+            unsigned int columns,
+            /// Number of pixels between 2 columns of tiles
+            unsigned int horizontalGutter = 0,
+            /// Number of pixels between 2 rows of tiles
+            unsigned int verticalGutter = 0
+        );
+        /// Symbols at given positions. The image is large enough for all symbols (and at least `width` x `height`).
+        QRMatrixAtlas(
+            /// Array of symbols (boards of dimension 0 are left empty)
+            QRMatrixBoard* boards,
+            /// Number of symbols
+            unsigned int count,
+            /// Size & colors of each symbol
+            const QRMatrixRasterStyle& style,
+            /// Array of `count` positions
+            const AtlasPlacement* placements,
+            /// Minimum number of pixels of each row
+            unsigned int width = 0,
+            /// Minimum number of rows
+            unsigned int height = 0
+        );
+
+        /// Number of pixels of each row
+        inline unsigned int width() { return width_; }
+        /// Number of rows
+        inline unsigned int height() { return height_; }
+        /// Minimum number of bytes of each row
+        unsigned int rowBytes();
+        /// Size & colors of each symbol
+        inline const QRMatrixRasterStyle& style() { return style_; }
+
+        /// Render the whole atlas into `output`: `height()` rows, `stride` bytes apart.
+        void render(
+            /// Image buffer (at least `stride * height()` bytes)
+            UnsignedByte* output,
+            /// Number of bytes between the starts of 2 rows (≥ `rowBytes()`)
+            unsigned int stride
+        );
+        /// Render the whole atlas into `output` by bands of rows on workers of `pool`.
+        /// Bands start at multiple of 64 bytes from `output`, so with `output` aligned to 64 bytes,
+        /// 2 workers never write into the same cache line.
+        void render(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Image buffer (at least `stride * height()` bytes)
+            UnsignedByte* output,
+            /// Number of bytes between the starts of 2 rows (≥ `rowBytes()`)
+            unsigned int stride
+        );
+        /// Render rows `top..<top + count` into `output` (first row of `output` is row `top`), eg. to stream the image by bands.
+        /// Bytes after `rowBytes()` of each row are not changed.
+        /// It does not change the atlas, so different bands can be rendered at the same time.
+        void renderRows(
+            /// First row
+            unsigned int top,
+            /// Number of rows
+            unsigned int count,
+            /// Band buffer (at least `stride * count` bytes)
+            UnsignedByte* output,
+            /// Number of bytes between the starts of 2 rows (≥ `rowBytes()`)
+            unsigned int stride
+        );
+    private:
+        QRMatrixRasterStyle style_;
+        /// Symbols sorted by rows
+        QRMatrixAtlas_Symbol* symbols_;
+        unsigned int count_;
+        /// Biggest number of rows of a symbol image
+        unsigned int symbolHeight_;
+        unsigned int width_;
+        unsigned int height_;
+
+        /// Symbols of boards at (0, 0)
+        void prepare(QRMatrixBoard* boards, unsigned int count);
+        /// Sort symbols & compute size of atlas
+        void finish(unsigned int minWidth, unsigned int minHeight);
+
+        // Not copyable
+        QRMatrixAtlas(QRMatrixAtlas &other);
+        void operator=(QRMatrixAtlas other);
+    };
+
+}
+
+#endif // QRMATRIXATLAS_H
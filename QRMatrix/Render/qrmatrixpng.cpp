@@ -0,0 +1,450 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixpng.h"
+#include "qrmatrixrasterrows.h"
+#include "../Exception/qrmatrixexception.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+/// Maximum size of IDAT chunks
+#define QRMATRIXPNG_CHUNK_SIZE 16384
+/// Maximum size of deflate stored blocks
+#define QRMATRIXPNG_STORED_SIZE 65535
+/// Modulo of Adler-32
+#define QRMATRIXPNG_ADLER_BASE 65521
+/// Maximum number of bytes before Adler-32 sums overflow
+#define QRMATRIXPNG_ADLER_MAX 5552
+/// Maximum length of deflate matches
+#define QRMATRIXPNG_MATCH_MAX 258
+/// Minimum length of deflate matches
+#define QRMATRIXPNG_MATCH_MIN 3
+/// PNG filter: none
+#define QRMATRIXPNG_FILTER_NONE 0
+/// PNG filter: difference with the previous row
+#define QRMATRIXPNG_FILTER_UP 2
+
+namespace QRMatrix {
+
+/// Lookup tables (made at the first use)
+struct QRMatrixPng_Tables {
+    /// Slicing-by-8 CRC-32 tables
+    Unsigned4Bytes crc[8][256];
+    /// Fixed Huffman codes of literals (bits reversed for LSB first writting)
+    Unsigned2Bytes literalCodes[256];
+    UnsignedByte literalLengths[256];
+    /// Fixed Huffman codes of matches of each length with distance 1 (length code, extra bits, distance code)
+    Unsigned4Bytes matchCodes[QRMATRIXPNG_MATCH_MAX + 1];
+    UnsignedByte matchLengths[QRMATRIXPNG_MATCH_MAX + 1];
+
+    QRMatrixPng_Tables() {
+        for (unsigned int index = 0; index < 256; index += 1) {
+            Unsigned4Bytes value = index;
+            for (unsigned int bit = 0; bit < 8; bit += 1) {
+                value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+            }
+            crc[0][index] = value;
+        }
+        for (unsigned int index = 0; index < 256; index += 1) {
+            for (unsigned int slice = 1; slice < 8; slice += 1) {
+                Unsigned4Bytes previous = crc[slice - 1][index];
+                crc[slice][index] = (previous >> 8) ^ crc[0][previous & 0xFF];
+            }
+        }
+        for (unsigned int index = 0; index < 256; index += 1) {
+            if (index < 144) {
+                literalCodes[index] = reverse(0x30 + index, 8);
+                literalLengths[index] = 8;
+            } else {
+                literalCodes[index] = reverse(0x190 + index - 144, 9);
+                literalLengths[index] = 9;
+            }
+        }
+        static const Unsigned2Bytes bases[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+        };
+        static const UnsignedByte extras[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+        };
+        unsigned int code = 0;
+        for (unsigned int length = QRMATRIXPNG_MATCH_MIN; length <= QRMATRIXPNG_MATCH_MAX; length += 1) {
+            while (code < 28 && bases[code + 1] <= length) {
+                code += 1;
+            }
+            // Symbols 257...279 have 7 bits codes, 280...285 have 8 bits codes
+            unsigned int symbol = 257 + code;
+            Unsigned4Bytes bits = symbol < 280 ? reverse(symbol - 256, 7) : reverse(0xC0 + symbol - 280, 8);
+            UnsignedByte bitsCount = symbol < 280 ? 7 : 8;
+            bits |= (length - bases[code]) << bitsCount;
+            bitsCount += extras[code];
+            // Distance 1: code 0 (5 bits), no extra bits
+            matchCodes[length] = bits;
+            matchLengths[length] = bitsCount + 5;
+        }
+    }
+
+    static Unsigned2Bytes reverse(unsigned int code, unsigned int length) {
+        Unsigned2Bytes result = 0;
+        for (unsigned int index = 0; index < length; index += 1) {
+            result = (result << 1) | ((code >> index) & 1);
+        }
+        return result;
+    }
+};
+
+/// Writer of PNG file
+struct QRMatrixPng_State {
+    const std::function<void(const UnsignedByte* data, unsigned int length)>& output;
+    const QRMatrixPng_Tables& tables;
+    PngCompression compression;
+    /// Data of IDAT chunk being filled
+    UnsignedByte* chunk;
+    unsigned int chunkLength;
+    /// Bits not written yet (LSB first)
+    Unsigned8Bytes bits;
+    unsigned int bitsCount;
+    /// Adler-32 of uncompressed data
+    Unsigned4Bytes adler;
+    /// Stored block being filled (`PngCompression::stored`)
+    UnsignedByte* block;
+    unsigned int blockLength;
+    /// Last written byte & number of its repetitions not written yet (`PngCompression::fixedHuffman`)
+    bool hasLast;
+    UnsignedByte lastByte;
+    unsigned int runLength;
+
+    QRMatrixPng_State(
+        const std::function<void(const UnsignedByte* data, unsigned int length)>& writer,
+        const QRMatrixPng_Tables& lookup,
+        PngCompression mode
+    ): output(writer), tables(lookup) {
+        compression = mode;
+        chunk = new UnsignedByte [QRMATRIXPNG_CHUNK_SIZE];
+        chunkLength = 0;
+        bits = 0;
+        bitsCount = 0;
+        adler = 1;
+        block = mode == PngCompression::stored ? new UnsignedByte [QRMATRIXPNG_STORED_SIZE] : nullptr;
+        blockLength = 0;
+        hasLast = false;
+        lastByte = 0;
+        runLength = 0;
+    }
+
+    ~QRMatrixPng_State() {
+        delete[] chunk;
+        if (block != nullptr) {
+            delete[] block;
+        }
+    }
+};
+
+}
+
+/// Static tables are made once (thread safe)
+const QRMatrixPng_Tables& QRMatrixPng_tables() {
+    static const QRMatrixPng_Tables tables;
+    return tables;
+}
+
+void QRMatrixPng_putBigEndian(UnsignedByte* output, Unsigned4Bytes value) {
+    output[0] = (value >> 24) & 0xFF;
+    output[1] = (value >> 16) & 0xFF;
+    output[2] = (value >> 8) & 0xFF;
+    output[3] = value & 0xFF;
+}
+
+Unsigned4Bytes QRMatrixPng_crc32(const QRMatrixPng_Tables& tables, const UnsignedByte* data, unsigned int length, Unsigned4Bytes crc) {
+    crc = ~crc;
+    while (length >= 8) {
+        Unsigned4Bytes first = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((Unsigned4Bytes)data[3] << 24));
+        crc = tables.crc[7][first & 0xFF] ^ tables.crc[6][(first >> 8) & 0xFF] ^
+            tables.crc[5][(first >> 16) & 0xFF] ^ tables.crc[4][first >> 24] ^
+            tables.crc[3][data[4]] ^ tables.crc[2][data[5]] ^
+            tables.crc[1][data[6]] ^ tables.crc[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    for (unsigned int index = 0; index < length; index += 1) {
+        crc = (crc >> 8) ^ tables.crc[0][(crc ^ data[index]) & 0xFF];
+    }
+    return ~crc;
+}
+
+/// Write a chunk of given type (4 chars)
+void QRMatrixPng_writeChunk(QRMatrixPng_State& state, const char* type, const UnsignedByte* data, unsigned int length) {
+    UnsignedByte header[8];
+    QRMatrixPng_putBigEndian(header, length);
+    memcpy(header + 4, type, 4);
+    Unsigned4Bytes crc = QRMatrixPng_crc32(state.tables, header + 4, 4, 0);
+    crc = QRMatrixPng_crc32(state.tables, data, length, crc);
+    UnsignedByte footer[4];
+    QRMatrixPng_putBigEndian(footer, crc);
+    state.output(header, 8);
+    if (length > 0) {
+        state.output(data, length);
+    }
+    state.output(footer, 4);
+}
+
+// DEFLATE -----------------------------------------------------------------------------------------
+
+/// Append a byte to the zlib stream
+void QRMatrixPng_putByte(QRMatrixPng_State& state, UnsignedByte byte) {
+    state.chunk[state.chunkLength] = byte;
+    state.chunkLength += 1;
+    if (state.chunkLength == QRMATRIXPNG_CHUNK_SIZE) {
+        QRMatrixPng_writeChunk(state, "IDAT", state.chunk, state.chunkLength);
+        state.chunkLength = 0;
+    }
+}
+
+/// Append `length` bytes to the zlib stream (which must be at a byte boundary)
+void QRMatrixPng_putBytes(QRMatrixPng_State& state, const UnsignedByte* data, unsigned int length) {
+    while (length > 0) {
+        unsigned int count = QRMATRIXPNG_CHUNK_SIZE - state.chunkLength;
+        count = count < length ? count : length;
+        memcpy(state.chunk + state.chunkLength, data, count);
+        state.chunkLength += count;
+        data += count;
+        length -= count;
+        if (state.chunkLength == QRMATRIXPNG_CHUNK_SIZE) {
+            QRMatrixPng_writeChunk(state, "IDAT", state.chunk, state.chunkLength);
+            state.chunkLength = 0;
+        }
+    }
+}
+
+/// Append `count` (≤ 32) bits to the zlib stream, least significant bit first
+void QRMatrixPng_putBits(QRMatrixPng_State& state, Unsigned4Bytes value, unsigned int count) {
+    state.bits |= (Unsigned8Bytes)value << state.bitsCount;
+    state.bitsCount += count;
+    while (state.bitsCount >= 8) {
+        QRMatrixPng_putByte(state, state.bits & 0xFF);
+        state.bits >>= 8;
+        state.bitsCount -= 8;
+    }
+}
+
+/// Pad the zlib stream to a byte boundary
+void QRMatrixPng_alignBits(QRMatrixPng_State& state) {
+    if (state.bitsCount > 0) {
+        QRMatrixPng_putBits(state, 0, 8 - state.bitsCount);
+    }
+}
+
+void QRMatrixPng_writeStoredBlock(QRMatrixPng_State& state, bool isFinal) {
+    QRMatrixPng_putBits(state, isFinal ? 1 : 0, 3);
+    QRMatrixPng_alignBits(state);
+    Unsigned2Bytes length = (Unsigned2Bytes)state.blockLength;
+    QRMatrixPng_putBits(state, length | ((Unsigned4Bytes)(Unsigned2Bytes)~length << 16), 32);
+    QRMatrixPng_putBytes(state, state.block, state.blockLength);
+    state.blockLength = 0;
+}
+
+/// Write repetitions of last byte as matches of distance 1
+void QRMatrixPng_flushRun(QRMatrixPng_State& state) {
+    const QRMatrixPng_Tables& tables = state.tables;
+    while (state.runLength >= QRMATRIXPNG_MATCH_MIN) {
+        unsigned int length = state.runLength < QRMATRIXPNG_MATCH_MAX ? state.runLength : QRMATRIXPNG_MATCH_MAX;
+        if (state.runLength - length > 0 && state.runLength - length < QRMATRIXPNG_MATCH_MIN) {
+            // Keep enough for the next match
+            length -= QRMATRIXPNG_MATCH_MIN;
+        }
+        QRMatrixPng_putBits(state, tables.matchCodes[length], tables.matchLengths[length]);
+        state.runLength -= length;
+    }
+    while (state.runLength > 0) {
+        QRMatrixPng_putBits(state, tables.literalCodes[state.lastByte], tables.literalLengths[state.lastByte]);
+        state.runLength -= 1;
+    }
+}
+
+/// Append `count` times `byte` to uncompressed data
+void QRMatrixPng_feedRepeat(QRMatrixPng_State& state, UnsignedByte byte, unsigned int count) {
+    if (count == 0) {
+        return;
+    }
+    Unsigned8Bytes sum = state.adler & 0xFFFF;
+    Unsigned8Bytes sums = state.adler >> 16;
+    sums += sum * count + (Unsigned8Bytes)byte * count * (count + 1) / 2;
+    sum += (Unsigned8Bytes)byte * count;
+    state.adler = (Unsigned4Bytes)(((sums % QRMATRIXPNG_ADLER_BASE) << 16) | (sum % QRMATRIXPNG_ADLER_BASE));
+    if (state.compression == PngCompression::stored) {
+        while (count > 0) {
+            unsigned int length = QRMATRIXPNG_STORED_SIZE - state.blockLength;
+            length = length < count ? length : count;
+            memset(state.block + state.blockLength, byte, length);
+            state.blockLength += length;
+            count -= length;
+            if (state.blockLength == QRMATRIXPNG_STORED_SIZE) {
+                QRMatrixPng_writeStoredBlock(state, false);
+            }
+        }
+        return;
+    }
+    if (state.hasLast && state.lastByte == byte) {
+        state.runLength += count;
+        return;
+    }
+    QRMatrixPng_flushRun(state);
+    QRMatrixPng_putBits(state, state.tables.literalCodes[byte], state.tables.literalLengths[byte]);
+    state.hasLast = true;
+    state.lastByte = byte;
+    state.runLength = count - 1;
+}
+
+/// Append `length` bytes of `data` to uncompressed data
+void QRMatrixPng_feed(QRMatrixPng_State& state, const UnsignedByte* data, unsigned int length) {
+    state.adler = QRMatrixPng::adler32(data, length, state.adler);
+    if (state.compression == PngCompression::stored) {
+        while (length > 0) {
+            unsigned int count = QRMATRIXPNG_STORED_SIZE - state.blockLength;
+            count = count < length ? count : length;
+            memcpy(state.block + state.blockLength, data, count);
+            state.blockLength += count;
+            data += count;
+            length -= count;
+            if (state.blockLength == QRMATRIXPNG_STORED_SIZE) {
+                QRMatrixPng_writeStoredBlock(state, false);
+            }
+        }
+        return;
+    }
+    const QRMatrixPng_Tables& tables = state.tables;
+    for (unsigned int index = 0; index < length; index += 1) {
+        UnsignedByte byte = data[index];
+        if (state.hasLast && state.lastByte == byte) {
+            state.runLength += 1;
+            continue;
+        }
+        QRMatrixPng_flushRun(state);
+        QRMatrixPng_putBits(state, tables.literalCodes[byte], tables.literalLengths[byte]);
+        state.hasLast = true;
+        state.lastByte = byte;
+    }
+}
+
+// PUBLIC ==========================================================================================
+
+Unsigned4Bytes QRMatrixPng::crc32(const UnsignedByte* data, unsigned int length, Unsigned4Bytes crc) {
+    return QRMatrixPng_crc32(QRMatrixPng_tables(), data, length, crc);
+}
+
+Unsigned4Bytes QRMatrixPng::adler32(const UnsignedByte* data, unsigned int length, Unsigned4Bytes adler) {
+    Unsigned4Bytes sum = adler & 0xFFFF;
+    Unsigned4Bytes sums = adler >> 16;
+    while (length > 0) {
+        unsigned int count = length < QRMATRIXPNG_ADLER_MAX ? length : QRMATRIXPNG_ADLER_MAX;
+        length -= count;
+        for (unsigned int index = 0; index < count; index += 1) {
+            sum += data[index];
+            sums += sum;
+        }
+        data += count;
+        sum %= QRMATRIXPNG_ADLER_BASE;
+        sums %= QRMATRIXPNG_ADLER_BASE;
+    }
+    return (sums << 16) | sum;
+}
+
+void QRMatrixPng::write(
+    QRMatrixBoard& board,
+    const QRMatrixRasterStyle& style,
+    const std::function<void(const UnsignedByte* data, unsigned int length)>& output,
+    PngCompression compression
+) {
+    if (board.dimension() == 0) {
+        throw QR_EXCEPTION("Board is empty.");
+    }
+    // Bit 0 is dark, 1 is light (gray level or palette index)
+    QRMatrixRasterStyle bitsStyle(RasterFormat::gray1, style.scale, style.quietZone);
+    QRMatrixRasterRows rows(board, bitsStyle);
+    bool isGray = style.darkColor == bitsStyle.darkColor && style.lightColor == bitsStyle.lightColor;
+    QRMatrixPng_State state(output, QRMatrixPng_tables(), compression);
+
+    static const UnsignedByte signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    output(signature, 8);
+    UnsignedByte header[13];
+    QRMatrixPng_putBigEndian(header, rows.width());
+    QRMatrixPng_putBigEndian(header + 4, rows.width());
+    header[8] = 1; // Bit depth
+    header[9] = isGray ? 0 : 3; // Grayscale or palette
+    header[10] = 0; // Deflate
+    header[11] = 0; // Adaptive filtering
+    header[12] = 0; // No interlace
+    QRMatrixPng_writeChunk(state, "IHDR", header, 13);
+    if (!isGray) {
+        UnsignedByte palette[6] = {
+            (UnsignedByte)(style.darkColor >> 24), (UnsignedByte)(style.darkColor >> 16), (UnsignedByte)(style.darkColor >> 8),
+            (UnsignedByte)(style.lightColor >> 24), (UnsignedByte)(style.lightColor >> 16), (UnsignedByte)(style.lightColor >> 8)
+        };
+        QRMatrixPng_writeChunk(state, "PLTE", palette, 6);
+        UnsignedByte alphas[2] = { (UnsignedByte)style.darkColor, (UnsignedByte)style.lightColor };
+        if (alphas[0] != 0xFF || alphas[1] != 0xFF) {
+            QRMatrixPng_writeChunk(state, "tRNS", alphas, 2);
+        }
+    }
+
+    // zlib header: deflate, 32K window, no dictionary
+    QRMatrixPng_putByte(state, 0x78);
+    QRMatrixPng_putByte(state, 0x01);
+    if (compression == PngCompression::fixedHuffman) {
+        // Final block, fixed Huffman codes
+        QRMatrixPng_putBits(state, 0x03, 3);
+    }
+    unsigned int rowBytes = rows.rowBytes();
+    UnsignedByte* previous = new UnsignedByte [rowBytes];
+    const UnsignedByte* row = rows.next();
+    bool hasPrevious = false;
+    while (row != nullptr) {
+        if (hasPrevious && memcmp(row, previous, rowBytes) == 0) {
+            QRMatrixPng_feedRepeat(state, QRMATRIXPNG_FILTER_UP, 1);
+            QRMatrixPng_feedRepeat(state, 0, rowBytes);
+        } else {
+            QRMatrixPng_feedRepeat(state, QRMATRIXPNG_FILTER_NONE, 1);
+            QRMatrixPng_feed(state, row, rowBytes);
+            memcpy(previous, row, rowBytes);
+            hasPrevious = true;
+        }
+        row = rows.next();
+    }
+    delete[] previous;
+    if (compression == PngCompression::fixedHuffman) {
+        QRMatrixPng_flushRun(state);
+        // End of block
+        QRMatrixPng_putBits(state, 0, 7);
+    } else {
+        QRMatrixPng_writeStoredBlock(state, true);
+    }
+    QRMatrixPng_alignBits(state);
+    UnsignedByte adler[4];
+    QRMatrixPng_putBigEndian(adler, state.adler);
+    QRMatrixPng_putBytes(state, adler, 4);
+    if (state.chunkLength > 0) {
+        QRMatrixPng_writeChunk(state, "IDAT", state.chunk, state.chunkLength);
+    }
+    QRMatrixPng_writeChunk(state, "IEND", nullptr, 0);
+}
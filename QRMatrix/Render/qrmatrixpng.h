@@ -0,0 +1,70 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXPNG_H
+#define QRMATRIXPNG_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+#include "qrmatrixraster.h"
+#include <functional>
+
+namespace QRMatrix {
+
+    /// Compression of PNG image data
+    enum PngCompression {
+        /// Not compressed (deflate stored blocks)
+        stored,
+        /// Deflate with fixed Huffman codes; repeated bytes are encoded as matches
+        fixedHuffman
+    };
+
+    /// Write `QRMatrixBoard` as PNG image without external library.
+    /// Image is 1 bit per pixel: grayscale if colors are black & white, else 2 colors palette.
+    /// Pixels rows are made & compressed one by one (see `QRMatrixRasterRows`); each row which is the same as
+    /// the previous one (rows of the same cells, quiet zone) is written with filter "Up" so its data is all 0.
+    class QRMatrixPng {
+    public:
+        /// Write PNG image of `board` to `output` (called many times with parts of the file, in order).
+        /// `style.format` is ignored.
+        static void write(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Size & colors
+            const QRMatrixRasterStyle& style,
+            /// Receiver of file data
+            const std::function<void(const UnsignedByte* data, unsigned int length)>& output,
+            /// Compression of image data
+            PngCompression compression = PngCompression::fixedHuffman
+        );
+
+        /// Internal purpose.
+        /// CRC-32 (ISO-HDLC, as PNG chunks) of `length` bytes of `data`, continued from `crc` (0 for the first part).
+        static Unsigned4Bytes crc32(const UnsignedByte* data, unsigned int length, Unsigned4Bytes crc = 0);
+        /// Internal purpose.
+        /// Adler-32 (as zlib streams) of `length` bytes of `data`, continued from `adler` (1 for the first part).
+        static Unsigned4Bytes adler32(const UnsignedByte* data, unsigned int length, Unsigned4Bytes adler = 1);
+    };
+
+}
+
+#endif // QRMATRIXPNG_H
@@ -0,0 +1,207 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixraster.h"
+#include "../qrmatrixboardruns.h"
+#include "../Exception/qrmatrixexception.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+/// Number of bytes per pixel (0 for `RasterFormat::gray1`)
+unsigned int QRMatrixRaster_bytesPerPixel(RasterFormat format) {
+    switch (format) {
+    case RasterFormat::gray1:
+        return 0;
+    case RasterFormat::gray8:
+        return 1;
+    case RasterFormat::rgb24:
+        return 3;
+    case RasterFormat::rgba32:
+        return 4;
+    }
+    return 1;
+}
+
+/// Write bytes of pixel of given color (0xRRGGBBAA) into `pixel` (up to 4 bytes)
+void QRMatrixRaster_pixel(Unsigned4Bytes color, RasterFormat format, UnsignedByte* pixel) {
+    UnsignedByte red = (color >> 24) & 0xFF;
+    UnsignedByte green = (color >> 16) & 0xFF;
+    UnsignedByte blue = (color >> 8) & 0xFF;
+    UnsignedByte alpha = color & 0xFF;
+    UnsignedByte gray = (UnsignedByte)((red * 299 + green * 587 + blue * 114) / 1000);
+    switch (format) {
+    case RasterFormat::gray1:
+        pixel[0] = gray >= 0x80 ? 1 : 0;
+        break;
+    case RasterFormat::gray8:
+        pixel[0] = gray;
+        break;
+    case RasterFormat::rgb24:
+    case RasterFormat::rgba32:
+        pixel[0] = red;
+        pixel[1] = green;
+        pixel[2] = blue;
+        pixel[3] = alpha;
+        break;
+    }
+}
+
+/// Set `count` bits from bit `start` of `output` to `bit`
+void QRMatrixRaster_fillBits(UnsignedByte* output, unsigned int start, unsigned int count, UnsignedByte bit) {
+    while (count > 0 && (start % 8) > 0) {
+        UnsignedByte mask = 0x80 >> (start % 8);
+        output[start / 8] = bit ? (output[start / 8] | mask) : (output[start / 8] & ~mask);
+        start += 1;
+        count -= 1;
+    }
+    memset(output + start / 8, bit ? 0xFF : 0x00, count / 8);
+    start += count / 8 * 8;
+    count %= 8;
+    if (count > 0) {
+        UnsignedByte mask = (UnsignedByte)(0xFF << (8 - count));
+        output[start / 8] = bit ? (output[start / 8] | mask) : (output[start / 8] & ~mask);
+    }
+}
+
+/// Write `count` pixels from pixel `start` of `output`
+void QRMatrixRaster_fillPixels(UnsignedByte* output, unsigned int start, unsigned int count, const UnsignedByte* pixel, unsigned int bytesPerPixel) {
+    if (count == 0) {
+        return;
+    }
+    UnsignedByte* span = output + start * bytesPerPixel;
+    if (bytesPerPixel == 1) {
+        memset(span, pixel[0], count);
+        return;
+    }
+    // Copy the filled part to double it
+    memcpy(span, pixel, bytesPerPixel);
+    unsigned int filled = 1;
+    while (filled < count) {
+        unsigned int length = filled < count - filled ? filled : count - filled;
+        memcpy(span + filled * bytesPerPixel, span, length * bytesPerPixel);
+        filled += length;
+    }
+}
+
+/// Write `count` pixels of given color from pixel `start` of `output`
+void QRMatrixRaster_fill(UnsignedByte* output, unsigned int start, unsigned int count, const UnsignedByte* pixel, RasterFormat format) {
+    if (format == RasterFormat::gray1) {
+        QRMatrixRaster_fillBits(output, start, count, pixel[0]);
+    } else {
+        QRMatrixRaster_fillPixels(output, start, count, pixel, QRMatrixRaster_bytesPerPixel(format));
+    }
+}
+
+// STYLE ===========================================================================================
+
+QRMatrixRasterStyle::QRMatrixRasterStyle(RasterFormat pixelFormat, unsigned int pixelScale, unsigned int quietZoneSize) {
+    format = pixelFormat;
+    scale = pixelScale;
+    quietZone = quietZoneSize;
+    darkColor = 0x000000FF;
+    lightColor = 0xFFFFFFFF;
+}
+
+unsigned int QRMatrixRasterStyle::width(UnsignedByte dimension) const {
+    return (dimension + 2 * quietZone) * scale;
+}
+
+unsigned int QRMatrixRasterStyle::rowBytes(UnsignedByte dimension) const {
+    return pixelsBytes(width(dimension));
+}
+
+unsigned int QRMatrixRasterStyle::pixelsBytes(unsigned int pixels) const {
+    if (format == RasterFormat::gray1) {
+        return (pixels + 7) / 8;
+    }
+    return pixels * QRMatrixRaster_bytesPerPixel(format);
+}
+
+// RENDER ==========================================================================================
+
+void QRMatrixRaster::fill(UnsignedByte* output, unsigned int start, unsigned int count, Unsigned4Bytes color, RasterFormat format) {
+    UnsignedByte pixel[4] = {};
+    QRMatrixRaster_pixel(color, format, pixel);
+    QRMatrixRaster_fill(output, start, count, pixel, format);
+}
+
+void QRMatrixRaster::renderDarkCells(const UnsignedByte* bits, UnsignedByte dimension, const QRMatrixRasterStyle& style, UnsignedByte* output, unsigned int offset) {
+    UnsignedByte dark[4] = {};
+    QRMatrixRaster_pixel(style.darkColor, style.format, dark);
+    // Black cells by runs
+    unsigned int length = 0;
+    unsigned int start = QRMatrixBoardRuns::find(bits, dimension, 0, &length);
+    while (start < dimension) {
+        QRMatrixRaster_fill(output, offset + start * style.scale, length * style.scale, dark, style.format);
+        start = QRMatrixBoardRuns::find(bits, dimension, start + length, &length);
+    }
+}
+
+void QRMatrixRaster::renderLine(const UnsignedByte* bits, UnsignedByte dimension, const QRMatrixRasterStyle& style, UnsignedByte* output) {
+    unsigned int width = style.width(dimension);
+    if (style.format == RasterFormat::gray1 && (width % 8) > 0) {
+        output[width / 8] = 0;
+    }
+    QRMatrixRaster::fill(output, 0, width, style.lightColor, style.format);
+    if (bits == nullptr) {
+        return;
+    }
+    QRMatrixRaster::renderDarkCells(bits, dimension, style, output, style.quietZone * style.scale);
+}
+
+void QRMatrixRaster::render(QRMatrixBoard& board, const QRMatrixRasterStyle& style, UnsignedByte* output, unsigned int stride) {
+    UnsignedByte dimension = board.dimension();
+    if (dimension == 0) {
+        return;
+    }
+    if (style.scale == 0) {
+        throw QR_EXCEPTION("Scale must be > 0.");
+    }
+    unsigned int rowBytes = style.rowBytes(dimension);
+    if (stride < rowBytes) {
+        throw QR_EXCEPTION("Stride must be ≥ number of bytes of image row.");
+    }
+    const UnsignedByte* bits = board.packed();
+    unsigned int bitsStride = board.packedStride();
+    unsigned int quietLines = style.quietZone * style.scale;
+    unsigned int bottom = quietLines + dimension * style.scale;
+    // Top quiet zone
+    if (quietLines > 0) {
+        QRMatrixRaster::renderLine(nullptr, dimension, style, output);
+        for (unsigned int line = 1; line < quietLines; line += 1) {
+            memcpy(output + line * stride, output, rowBytes);
+        }
+    }
+    // Cells rows
+    for (unsigned int row = 0; row < dimension; row += 1) {
+        UnsignedByte* first = output + (quietLines + row * style.scale) * stride;
+        QRMatrixRaster::renderLine(bits + row * bitsStride, dimension, style, first);
+        for (unsigned int line = 1; line < style.scale; line += 1) {
+            memcpy(first + line * stride, first, rowBytes);
+        }
+    }
+    // Bottom quiet zone
+    for (unsigned int line = 0; line < quietLines; line += 1) {
+        memcpy(output + (bottom + line) * stride, output, rowBytes);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXRASTER_H
+#define QRMATRIXRASTER_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+
+namespace QRMatrix {
+
+    /// Pixels of raster image
+    enum RasterFormat {
+        /// 1 bit per pixel (1 for light, 0 for dark color), most significant bit first. Padding bits are 0.
+        gray1,
+        /// 1 byte per pixel (gray level)
+        gray8,
+        /// 3 bytes per pixel: R, G, B
+        rgb24,
+        /// 4 bytes per pixel: R, G, B, A
+        rgba32
+    };
+
+    /// Size & colors of raster image
+    struct QRMatrixRasterStyle {
+        /// Pixels format
+        RasterFormat format;
+        /// Number of pixels of each side of a cell
+        unsigned int scale;
+        /// Number of cells of quiet zone around symbol (4 for QR, 2 for MicroQR)
+        unsigned int quietZone;
+        /// Color of black cells: 0xRRGGBBAA (gray formats use its luma)
+        Unsigned4Bytes darkColor;
+        /// Color of white cells & quiet zone: 0xRRGGBBAA (gray formats use its luma)
+        Unsigned4Bytes lightColor;
+
+        QRMatrixRasterStyle(RasterFormat pixelFormat = RasterFormat::gray8, unsigned int pixelScale = 1, unsigned int quietZoneSize = 4);
+
+        /// Number of pixels of each side of image of symbol of given dimension
+        unsigned int width(UnsignedByte dimension) const;
+        /// Minimum number of bytes of each row of image of symbol of given dimension
+        unsigned int rowBytes(UnsignedByte dimension) const;
+        /// Minimum number of bytes of row of given number of pixels
+        unsigned int pixelsBytes(unsigned int pixels) const;
+    };
+
+    /// Render `QRMatrixBoard` into raster image
+    class QRMatrixRaster {
+    public:
+        /// Render `board` into `output`: `style.width(dimension)` rows, `stride` bytes apart.
+        /// Each cells row is rendered once then copied to the other rows of its cells.
+        /// Bytes after `style.rowBytes(dimension)` of each row are not changed.
+        static void render(
+            /// Symbol to render
+            QRMatrixBoard& board,
+            /// Size & colors
+            const QRMatrixRasterStyle& style,
+            /// Image buffer (at least `stride * style.width(dimension)` bytes)
+            UnsignedByte* output,
+            /// Number of bytes between the starts of 2 rows (≥ `style.rowBytes(dimension)`)
+            unsigned int stride
+        );
+
+        /// Internal purpose.
+        /// Write `count` pixels of given color (0xRRGGBBAA) from pixel `start` of pixels row `output`.
+        /// Other pixels are not changed.
+        static void fill(UnsignedByte* output, unsigned int start, unsigned int count, Unsigned4Bytes color, RasterFormat format);
+
+        /// Internal purpose.
+        /// Render black cells of a cells row from pixel `offset` of pixels row `output` (white cells are not changed).
+        static void renderDarkCells(
+            /// Colors of cells row (`BoardFormat::packedBits` format)
+            const UnsignedByte* bits,
+            /// Number of cells of row
+            UnsignedByte dimension,
+            /// Size & colors (quiet zone is not used)
+            const QRMatrixRasterStyle& style,
+            /// Pixels row
+            UnsignedByte* output,
+            /// Pixel of first cell
+            unsigned int offset
+        );
+
+        /// Internal purpose.
+        /// Render 1 pixels row of a cells row into `output` (`style.rowBytes(dimension)` bytes).
+        static void renderLine(
+            /// Colors of cells row (`BoardFormat::packedBits` format), `nullptr` for quiet zone rows
+            const UnsignedByte* bits,
+            /// Number of cells of row
+            UnsignedByte dimension,
+            /// Size & colors
+            const QRMatrixRasterStyle& style,
+            /// Row buffer
+            UnsignedByte* output
+        );
+    };
+
+}
+
+#endif // QRMATRIXRASTER_H
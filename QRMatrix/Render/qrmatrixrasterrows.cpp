@@ -0,0 +1,73 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixrasterrows.h"
+#include "../Exception/qrmatrixexception.h"
+
+using namespace QRMatrix;
+
+/// `lineRow_` of quiet zone row
+#define QRMATRIXRASTERROWS_QUIET_ZONE -1
+/// `lineRow_` before rendering
+#define QRMATRIXRASTERROWS_NONE -2
+
+QRMatrixRasterRows::~QRMatrixRasterRows() {
+    if (line_ != nullptr) {
+        delete[] line_;
+    }
+}
+
+QRMatrixRasterRows::QRMatrixRasterRows(QRMatrixBoard& board, const QRMatrixRasterStyle& style): style_(style) {
+    if (style.scale == 0) {
+        throw QR_EXCEPTION("Scale must be > 0.");
+    }
+    dimension_ = board.dimension();
+    bits_ = board.packed();
+    bitsStride_ = board.packedStride();
+    width_ = dimension_ > 0 ? style.width(dimension_) : 0;
+    rowBytes_ = dimension_ > 0 ? style.rowBytes(dimension_) : 0;
+    index_ = 0;
+    line_ = rowBytes_ > 0 ? new UnsignedByte [rowBytes_] : nullptr;
+    lineRow_ = QRMATRIXRASTERROWS_NONE;
+}
+
+const UnsignedByte* QRMatrixRasterRows::next() {
+    if (index_ >= width_) {
+        return nullptr;
+    }
+    unsigned int cellsRow = index_ / style_.scale;
+    int row = QRMATRIXRASTERROWS_QUIET_ZONE;
+    if (cellsRow >= style_.quietZone && cellsRow < style_.quietZone + dimension_) {
+        row = cellsRow - style_.quietZone;
+    }
+    if (row != lineRow_) {
+        const UnsignedByte* bits = row == QRMATRIXRASTERROWS_QUIET_ZONE ? nullptr : bits_ + row * bitsStride_;
+        QRMatrixRaster::renderLine(bits, dimension_, style_, line_);
+        lineRow_ = row;
+    }
+    index_ += 1;
+    return line_;
+}
+
+void QRMatrixRasterRows::reset() {
+    index_ = 0;
+}
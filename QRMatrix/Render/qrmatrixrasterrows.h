@@ -0,0 +1,74 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXRASTERROWS_H
+#define QRMATRIXRASTERROWS_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+#include "qrmatrixraster.h"
+
+namespace QRMatrix {
+
+    /// Rows of raster image of `QRMatrixBoard`, made one by one on request,
+    /// so image encoders (PNG, TIFF, printers) can stream big images with 1 row of memory.
+    /// A cells row is rendered once; the other pixels rows of its cells return the same row.
+    /// Board must be kept alive & unchanged while rows are read.
+    class QRMatrixRasterRows {
+    public:
+        ~QRMatrixRasterRows();
+        QRMatrixRasterRows(QRMatrixBoard& board, const QRMatrixRasterStyle& style);
+
+        /// Number of pixels of each row (= number of rows)
+        inline unsigned int width() { return width_; }
+        /// Number of bytes of each row
+        inline unsigned int rowBytes() { return rowBytes_; }
+        /// Index of the row returned by next call of `next()`
+        inline unsigned int index() { return index_; }
+        /// Size & colors
+        inline const QRMatrixRasterStyle& style() { return style_; }
+
+        /// Pixels of next row (`rowBytes()` bytes, valid until next call), `nullptr` after the last row.
+        const UnsignedByte* next();
+        /// Restart from the first row.
+        void reset();
+    private:
+        QRMatrixRasterStyle style_;
+        UnsignedByte dimension_;
+        const UnsignedByte* bits_;
+        unsigned int bitsStride_;
+        unsigned int width_;
+        unsigned int rowBytes_;
+        unsigned int index_;
+        /// Current row
+        UnsignedByte* line_;
+        /// Cells row rendered in `line_` (-1 for quiet zone, -2 for none)
+        int lineRow_;
+
+        // Not copyable
+        QRMatrixRasterRows(QRMatrixRasterRows &other);
+        void operator=(QRMatrixRasterRows other);
+    };
+
+}
+
+#endif // QRMATRIXRASTERROWS_H
@@ -0,0 +1,307 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixsvgwriter.h"
+#include "../qrmatrixboardruns.h"
+#include "../Exception/qrmatrixexception.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+/// Size of text buffer
+#define QRMATRIXSVGWRITER_BUFFER_SIZE 4096
+/// Maximum number of black runs of a row (dimension ≤ 177)
+#define QRMATRIXSVGWRITER_RUNS_SIZE 96
+
+namespace QRMatrix {
+
+/// Black cells `start...start + length - 1` of rows `top...` (until it is closed)
+struct QRMatrixSvgWriter_Run {
+    UnsignedByte start;
+    UnsignedByte length;
+    UnsignedByte top;
+};
+
+struct QRMatrixSvgWriter_State {
+    const std::function<void(const char* text, unsigned int length)>& output;
+    char buffer[QRMATRIXSVGWRITER_BUFFER_SIZE];
+    unsigned int length;
+    unsigned int quietZone;
+    /// Color of current path (its tag is written at its first rectangle)
+    const char* color;
+    bool isPathStarted;
+    /// Start point of last subpath (path data uses relative moves)
+    int pathX;
+    int pathY;
+    /// Runs of previous row, which may continue in next rows
+    QRMatrixSvgWriter_Run runs[QRMATRIXSVGWRITER_RUNS_SIZE];
+    unsigned int runsCount;
+
+    QRMatrixSvgWriter_State(const std::function<void(const char* text, unsigned int length)>& writer, unsigned int quietZoneSize):
+        output(writer) {
+        length = 0;
+        quietZone = quietZoneSize;
+        color = nullptr;
+        isPathStarted = false;
+        pathX = 0;
+        pathY = 0;
+        runsCount = 0;
+    }
+};
+
+}
+
+void QRMatrixSvgWriter_flush(QRMatrixSvgWriter_State& state) {
+    if (state.length > 0) {
+        state.output(state.buffer, state.length);
+        state.length = 0;
+    }
+}
+
+void QRMatrixSvgWriter_append(QRMatrixSvgWriter_State& state, const char* text, unsigned int length) {
+    if (state.length + length > QRMATRIXSVGWRITER_BUFFER_SIZE) {
+        QRMatrixSvgWriter_flush(state);
+        if (length > QRMATRIXSVGWRITER_BUFFER_SIZE) {
+            state.output(text, length);
+            return;
+        }
+    }
+    memcpy(state.buffer + state.length, text, length);
+    state.length += length;
+}
+
+void QRMatrixSvgWriter_appendText(QRMatrixSvgWriter_State& state, const char* text) {
+    QRMatrixSvgWriter_append(state, text, (unsigned int)strlen(text));
+}
+
+void QRMatrixSvgWriter_appendNumber(QRMatrixSvgWriter_State& state, int value) {
+    char digits[12];
+    unsigned int index = sizeof(digits);
+    unsigned int number = value < 0 ? -value : value;
+    do {
+        index -= 1;
+        digits[index] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0);
+    if (value < 0) {
+        index -= 1;
+        digits[index] = '-';
+    }
+    QRMatrixSvgWriter_append(state, digits + index, sizeof(digits) - index);
+}
+
+/// Add rectangle of cells to current path
+void QRMatrixSvgWriter_rect(QRMatrixSvgWriter_State& state, unsigned int column, unsigned int row, unsigned int width, unsigned int height) {
+    int x = column + state.quietZone;
+    int y = row + state.quietZone;
+    if (!state.isPathStarted) {
+        QRMatrixSvgWriter_appendText(state, "<path fill=\"");
+        QRMatrixSvgWriter_appendText(state, state.color);
+        QRMatrixSvgWriter_appendText(state, "\" d=\"M");
+        QRMatrixSvgWriter_appendNumber(state, x);
+        QRMatrixSvgWriter_append(state, " ", 1);
+        QRMatrixSvgWriter_appendNumber(state, y);
+        state.isPathStarted = true;
+    } else {
+        QRMatrixSvgWriter_append(state, "m", 1);
+        QRMatrixSvgWriter_appendNumber(state, x - state.pathX);
+        QRMatrixSvgWriter_append(state, " ", 1);
+        QRMatrixSvgWriter_appendNumber(state, y - state.pathY);
+    }
+    // After "z", current point is back to start of subpath
+    QRMatrixSvgWriter_append(state, "h", 1);
+    QRMatrixSvgWriter_appendNumber(state, width);
+    QRMatrixSvgWriter_append(state, "v", 1);
+    QRMatrixSvgWriter_appendNumber(state, height);
+    QRMatrixSvgWriter_append(state, "h-", 2);
+    QRMatrixSvgWriter_appendNumber(state, width);
+    QRMatrixSvgWriter_append(state, "z", 1);
+    state.pathX = x;
+    state.pathY = y;
+}
+
+/// Add black runs (sorted by columns) of given row: runs of the same columns as the previous row continue,
+/// other runs of the previous row are closed & drawn
+void QRMatrixSvgWriter_addRow(QRMatrixSvgWriter_State& state, unsigned int row, const QRMatrixSvgWriter_Run* runs, unsigned int count) {
+    QRMatrixSvgWriter_Run next[QRMATRIXSVGWRITER_RUNS_SIZE];
+    unsigned int nextCount = 0;
+    unsigned int index = 0;
+    unsigned int jndex = 0;
+    while (index < state.runsCount || jndex < count) {
+        if (index < state.runsCount && jndex < count &&
+            state.runs[index].start == runs[jndex].start && state.runs[index].length == runs[jndex].length) {
+            next[nextCount] = state.runs[index];
+            nextCount += 1;
+            index += 1;
+            jndex += 1;
+            continue;
+        }
+        if (index < state.runsCount && (jndex >= count || state.runs[index].start <= runs[jndex].start)) {
+            const QRMatrixSvgWriter_Run& run = state.runs[index];
+            QRMatrixSvgWriter_rect(state, run.start, run.top, run.length, row - run.top);
+            index += 1;
+            continue;
+        }
+        next[nextCount] = runs[jndex];
+        next[nextCount].top = row;
+        nextCount += 1;
+        jndex += 1;
+    }
+    memcpy(state.runs, next, nextCount * sizeof(QRMatrixSvgWriter_Run));
+    state.runsCount = nextCount;
+}
+
+void QRMatrixSvgWriter_endPath(QRMatrixSvgWriter_State& state, unsigned int dimension) {
+    QRMatrixSvgWriter_addRow(state, dimension, nullptr, 0);
+    if (state.isPathStarted) {
+        QRMatrixSvgWriter_appendText(state, "\"/>\n");
+        state.isPathStarted = false;
+    }
+}
+
+/// Add all runs of `runs` to current path & close it
+void QRMatrixSvgWriter_path(QRMatrixSvgWriter_State& state, QRMatrixBoardRuns& runs, UnsignedByte dimension) {
+    QRMatrixSvgWriter_Run rowRuns[QRMATRIXSVGWRITER_RUNS_SIZE];
+    unsigned int count = 0;
+    unsigned int row = 0;
+    BoardRun run;
+    while (runs.next(run)) {
+        if (run.row != row) {
+            QRMatrixSvgWriter_addRow(state, row, rowRuns, count);
+            if (run.row > row + 1) {
+                // Rows without runs close all rectangles
+                QRMatrixSvgWriter_addRow(state, row + 1, nullptr, 0);
+            }
+            count = 0;
+            row = run.row;
+        }
+        rowRuns[count].start = run.column;
+        rowRuns[count].length = run.length;
+        count += 1;
+    }
+    if (count > 0) {
+        QRMatrixSvgWriter_addRow(state, row, rowRuns, count);
+        // Rectangles end at last row having runs, not at bottom of board
+        QRMatrixSvgWriter_addRow(state, row + 1, nullptr, 0);
+    }
+    QRMatrixSvgWriter_endPath(state, dimension);
+}
+
+void QRMatrixSvgWriter_begin(QRMatrixSvgWriter_State& state, UnsignedByte dimension, unsigned int scale, const char* background) {
+    if (scale == 0) {
+        throw QR_EXCEPTION("Scale must be > 0.");
+    }
+    unsigned int cells = dimension + 2 * state.quietZone;
+    QRMatrixSvgWriter_appendText(state, "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"");
+    QRMatrixSvgWriter_appendNumber(state, cells * scale);
+    QRMatrixSvgWriter_appendText(state, "\" height=\"");
+    QRMatrixSvgWriter_appendNumber(state, cells * scale);
+    QRMatrixSvgWriter_appendText(state, "\" viewBox=\"0 0 ");
+    QRMatrixSvgWriter_appendNumber(state, cells);
+    QRMatrixSvgWriter_append(state, " ", 1);
+    QRMatrixSvgWriter_appendNumber(state, cells);
+    QRMatrixSvgWriter_appendText(state, "\" shape-rendering=\"crispEdges\">\n<rect width=\"");
+    QRMatrixSvgWriter_appendNumber(state, cells);
+    QRMatrixSvgWriter_appendText(state, "\" height=\"");
+    QRMatrixSvgWriter_appendNumber(state, cells);
+    QRMatrixSvgWriter_appendText(state, "\" fill=\"");
+    QRMatrixSvgWriter_appendText(state, background);
+    QRMatrixSvgWriter_appendText(state, "\"/>\n");
+}
+
+void QRMatrixSvgWriter_end(QRMatrixSvgWriter_State& state) {
+    QRMatrixSvgWriter_appendText(state, "</svg>\n");
+    QRMatrixSvgWriter_flush(state);
+}
+
+// PUBLIC ==========================================================================================
+
+QRMatrixSvgColors::QRMatrixSvgColors() {
+    background = "white";
+    data = "black";
+    finder = "blue";
+    timing = "green";
+    dark = "red";
+    alignment = "purple";
+    version = "orange";
+    format = "magenta";
+    errorCorrection = "darkblue";
+    remainder = "darkgreen";
+}
+
+void QRMatrixSvgWriter::write(
+    QRMatrixBoard& board,
+    const std::function<void(const char* text, unsigned int length)>& output,
+    unsigned int scale,
+    unsigned int quietZone,
+    const char* darkColor,
+    const char* lightColor
+) {
+    QRMatrixSvgWriter_State state(output, quietZone);
+    UnsignedByte dimension = board.dimension();
+    QRMatrixSvgWriter_begin(state, dimension, scale, lightColor);
+    QRMatrixBoardRuns runs(board);
+    state.color = darkColor;
+    QRMatrixSvgWriter_path(state, runs, dimension);
+    QRMatrixSvgWriter_end(state);
+}
+
+void QRMatrixSvgWriter::writeDetail(
+    QRMatrixBoard& board,
+    const std::function<void(const char* text, unsigned int length)>& output,
+    unsigned int scale,
+    unsigned int quietZone,
+    const QRMatrixSvgColors& colors
+) {
+    QRMatrixSvgWriter_State state(output, quietZone);
+    UnsignedByte dimension = board.dimension();
+    QRMatrixSvgWriter_begin(state, dimension, scale, colors.background);
+    const UnsignedByte types[9] = {
+        0x00, BoardCell::finder, BoardCell::timing, BoardCell::alignment, BoardCell::version,
+        BoardCell::format, BoardCell::dark, BoardCell::errorCorrection, BoardCell::remainder
+    };
+    const char* typeColors[9] = {
+        colors.data, colors.finder, colors.timing, colors.alignment, colors.version,
+        colors.format, colors.dark, colors.errorCorrection, colors.remainder
+    };
+    for (unsigned int index = 0; index < 9; index += 1) {
+        QRMatrixBoardRuns runs(board, types[index]);
+        state.color = typeColors[index];
+        QRMatrixSvgWriter_path(state, runs, dimension);
+    }
+    QRMatrixSvgWriter_end(state);
+}
+
+std::string QRMatrixSvgWriter::svg(
+    QRMatrixBoard& board,
+    unsigned int scale,
+    unsigned int quietZone,
+    const char* darkColor,
+    const char* lightColor
+) {
+    std::string result;
+    result.reserve(256 + board.dimension() * board.dimension() * 2);
+    QRMatrixSvgWriter::write(board, [&result](const char* text, unsigned int length) {
+        result.append(text, length);
+    }, scale, quietZone, darkColor, lightColor);
+    return result;
+}
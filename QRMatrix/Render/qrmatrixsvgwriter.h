@@ -0,0 +1,106 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXSVGWRITER_H
+#define QRMATRIXSVGWRITER_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+#include <functional>
+#include <string>
+
+namespace QRMatrix {
+
+    /// Colors of `QRMatrixSvgWriter::writeDetail` (SVG colors: names, "#RRGGBB"...)
+    struct QRMatrixSvgColors {
+        /// Background & white cells
+        const char* background;
+        /// Black data cells
+        const char* data;
+        /// Black finder cells
+        const char* finder;
+        /// Black timing cells
+        const char* timing;
+        /// Dark module
+        const char* dark;
+        /// Black alignment cells
+        const char* alignment;
+        /// Black version cells
+        const char* version;
+        /// Black format cells
+        const char* format;
+        /// Black error correction cells
+        const char* errorCorrection;
+        /// Black remainder cells
+        const char* remainder;
+
+        QRMatrixSvgColors();
+    };
+
+    /// Write `QRMatrixBoard` as SVG image.
+    /// Black cells of each color are drawn by 1 `<path>`: horizontal runs of black cells are merged,
+    /// and runs of the same columns in following rows are merged into 1 rectangle.
+    /// Coordinates are in cells (`viewBox`), the image size is in pixels.
+    /// Text is made in a small buffer and passed to `output` by parts (no `iostream`).
+    class QRMatrixSvgWriter {
+    public:
+        /// Write SVG image of `board` to `output` (called many times with parts of the text, in order).
+        static void write(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Receiver of text (not null terminated)
+            const std::function<void(const char* text, unsigned int length)>& output,
+            /// Number of pixels of each side of a cell
+            unsigned int scale = 1,
+            /// Number of cells of quiet zone around symbol (4 for QR, 2 for MicroQR)
+            unsigned int quietZone = 4,
+            /// Color of black cells
+            const char* darkColor = "black",
+            /// Color of background & white cells
+            const char* lightColor = "white"
+        );
+        /// Write SVG image of `board` to `output`, black cells are colored by their type.
+        static void writeDetail(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Receiver of text (not null terminated)
+            const std::function<void(const char* text, unsigned int length)>& output,
+            /// Number of pixels of each side of a cell
+            unsigned int scale = 1,
+            /// Number of cells of quiet zone around symbol (4 for QR, 2 for MicroQR)
+            unsigned int quietZone = 4,
+            /// Colors of cells types
+            const QRMatrixSvgColors& colors = QRMatrixSvgColors()
+        );
+        /// SVG image of `board` (as `write`) in a string reserved for its estimated size.
+        static std::string svg(
+            QRMatrixBoard& board,
+            unsigned int scale = 1,
+            unsigned int quietZone = 4,
+            const char* darkColor = "black",
+            const char* lightColor = "white"
+        );
+    };
+
+}
+
+#endif // QRMATRIXSVGWRITER_H
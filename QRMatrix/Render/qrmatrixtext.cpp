@@ -0,0 +1,240 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixtext.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+/// Copy `text` (`length` bytes) at `cursor` & move `cursor` after it
+void QRMatrixText_put(char*& cursor, const char* text, unsigned int length) {
+    memcpy(cursor, text, length);
+    cursor += length;
+}
+
+#define QRMatrixText_putText(cursor, text) QRMatrixText_put(cursor, text, sizeof(text) - 1)
+
+/// Write index with at least 2 digits
+void QRMatrixText_index(char*& cursor, unsigned int value) {
+    if (value >= 100) {
+        *cursor = '0' + value / 100;
+        cursor += 1;
+    }
+    cursor[0] = '0' + (value / 10) % 10;
+    cursor[1] = '0' + value % 10;
+    cursor += 2;
+}
+
+/// Packed row of cells at `row` of symbol with quiet zone (`nullptr` for quiet zone rows)
+const UnsignedByte* QRMatrixText_row(const UnsignedByte* bits, unsigned int stride, int dimension, int row) {
+    return row >= 0 && row < dimension ? bits + row * stride : nullptr;
+}
+
+unsigned int QRMatrixText_halfBlocks(QRMatrixBoard& board, char* output, int quietZone, bool isInverted) {
+    // Index: (upper cell is black) * 2 + (lower cell is black); " " is 1 byte, others are 3 bytes
+    static const char glyphs[4][4] = {" ", "▄", "▀", "█"};
+    static const unsigned int lengths[4] = {1, 3, 3, 3};
+    const UnsignedByte* bits = board.packed();
+    unsigned int stride = board.packedStride();
+    int dimension = board.dimension();
+    int width = dimension + quietZone * 2;
+    // Glyph of 2 white cells, of white upper cell & line after last row
+    unsigned int white = isInverted ? 3 : 0;
+    unsigned int whiteEnd = isInverted ? 2 : 0;
+    char* cursor = output;
+    for (int row = 0; row < width; row += 2) {
+        const UnsignedByte* upper = QRMatrixText_row(bits, stride, dimension, row - quietZone);
+        const UnsignedByte* lower = QRMatrixText_row(bits, stride, dimension, row + 1 - quietZone);
+        bool isLast = row + 1 >= width;
+        for (int column = 0; column < width; column += 1) {
+            int cell = column - quietZone;
+            unsigned int glyph = isLast ? whiteEnd : white;
+            if (cell >= 0 && cell < dimension) {
+                UnsignedByte shift = 7 - cell % 8;
+                unsigned int byte = cell / 8;
+                if (upper != nullptr && ((upper[byte] >> shift) & 1)) {
+                    glyph ^= 2;
+                }
+                if (lower != nullptr && ((lower[byte] >> shift) & 1)) {
+                    glyph ^= 1;
+                }
+            }
+            // Copy 3 bytes, only `lengths[glyph]` are kept (capacity allows 3 bytes per glyph)
+            cursor[0] = glyphs[glyph][0];
+            cursor[1] = glyphs[glyph][1];
+            cursor[2] = glyphs[glyph][2];
+            cursor += lengths[glyph];
+        }
+        *cursor = '\n';
+        cursor += 1;
+    }
+    return (unsigned int)(cursor - output);
+}
+
+unsigned int QRMatrixText_asciiBlocks(QRMatrixBoard& board, char* output, int quietZone, bool isInverted) {
+    const UnsignedByte* bits = board.packed();
+    unsigned int stride = board.packedStride();
+    int dimension = board.dimension();
+    int width = dimension + quietZone * 2;
+    char dark = isInverted ? ' ' : '#';
+    char light = isInverted ? '#' : ' ';
+    char* cursor = output;
+    for (int row = 0; row < width; row += 1) {
+        const UnsignedByte* cells = QRMatrixText_row(bits, stride, dimension, row - quietZone);
+        for (int column = 0; column < width; column += 1) {
+            int cell = column - quietZone;
+            char glyph = light;
+            if (cells != nullptr && cell >= 0 && cell < dimension && ((cells[cell / 8] >> (7 - cell % 8)) & 1)) {
+                glyph = dark;
+            }
+            cursor[0] = glyph;
+            cursor[1] = glyph;
+            cursor += 2;
+        }
+        *cursor = '\n';
+        cursor += 1;
+    }
+    return (unsigned int)(cursor - output);
+}
+
+/// Cell of `cellTypes` mode
+void QRMatrixText_typedCell(char*& cursor, UnsignedByte byte) {
+    if (byte == BoardCell::neutral) {
+        QRMatrixText_putText(cursor, " +");
+        return;
+    }
+    UnsignedByte low = byte & BoardCell::lowMask;
+    UnsignedByte high = byte & BoardCell::highMask;
+    bool isInfo = high == BoardCell::format || high == BoardCell::version;
+    if (isInfo) {
+        QRMatrixText_putText(cursor, "®");
+    } else if ((byte & BoardCell::funcMask) > 0) {
+        QRMatrixText_putText(cursor, "•");
+    } else if (high == BoardCell::errorCorrection) {
+        QRMatrixText_putText(cursor, ".");
+    } else {
+        QRMatrixText_putText(cursor, " ");
+    }
+    switch (low) {
+    case BoardCell::unset:
+        QRMatrixText_putText(cursor, "□");
+        break;
+    case BoardCell::set:
+        QRMatrixText_putText(cursor, "■");
+        break;
+    default:
+        if (isInfo) {
+            QRMatrixText_putText(cursor, "®");
+        } else {
+            QRMatrixText_putText(cursor, " ");
+        }
+        break;
+    }
+}
+
+unsigned int QRMatrixText_cells(QRMatrixBoard& board, char* output, bool isTypeVisible) {
+    UnsignedByte** cells = board.buffer();
+    unsigned int dimension = board.dimension();
+    char* cursor = output;
+    QRMatrixText_putText(cursor, "  ");
+    for (unsigned int index = 0; index < dimension; index += 1) {
+        if (index % 2 > 0) {
+            QRMatrixText_putText(cursor, "..");
+        } else {
+            QRMatrixText_index(cursor, index);
+        }
+    }
+    *cursor = '\n';
+    cursor += 1;
+    for (unsigned int index = 0; index < dimension; index += 1) {
+        QRMatrixText_index(cursor, index);
+        const UnsignedByte* row = cells[index];
+        for (unsigned int jndex = 0; jndex < dimension; jndex += 1) {
+            if (isTypeVisible) {
+                QRMatrixText_typedCell(cursor, row[jndex]);
+                continue;
+            }
+            switch (row[jndex] & BoardCell::lowMask) {
+            case BoardCell::unset:
+                QRMatrixText_putText(cursor, " □");
+                break;
+            case BoardCell::set:
+                QRMatrixText_putText(cursor, " ■");
+                break;
+            default:
+                QRMatrixText_putText(cursor, "  ");
+                break;
+            }
+        }
+        *cursor = '\n';
+        cursor += 1;
+    }
+    return (unsigned int)(cursor - output);
+}
+
+unsigned int QRMatrixText::capacity(QRMatrixBoard& board, TextMode mode, unsigned int quietZone) {
+    unsigned int dimension = board.dimension();
+    if (dimension == 0) {
+        return 0;
+    }
+    unsigned int width = dimension + quietZone * 2;
+    switch (mode) {
+    case TextMode::halfBlocks:
+        // Up to 3 bytes per glyph
+        return (width + 1) / 2 * (width * 3 + 1);
+    case TextMode::asciiBlocks:
+        return width * (width * 2 + 1);
+    case TextMode::cellColors:
+        // Indexes take up to 3 characters, cells up to 4 bytes
+        return (2 + dimension * 3 + 1) + dimension * (3 + dimension * 4 + 1);
+    case TextMode::cellTypes:
+        // Cells take up to 6 bytes
+        return (2 + dimension * 3 + 1) + dimension * (3 + dimension * 6 + 1);
+    }
+    return 0;
+}
+
+unsigned int QRMatrixText::write(QRMatrixBoard& board, TextMode mode, char* output, unsigned int quietZone, bool isInverted) {
+    if (board.dimension() == 0) {
+        return 0;
+    }
+    switch (mode) {
+    case TextMode::halfBlocks:
+        return QRMatrixText_halfBlocks(board, output, quietZone, isInverted);
+    case TextMode::asciiBlocks:
+        return QRMatrixText_asciiBlocks(board, output, quietZone, isInverted);
+    case TextMode::cellColors:
+        return QRMatrixText_cells(board, output, false);
+    case TextMode::cellTypes:
+        return QRMatrixText_cells(board, output, true);
+    }
+    return 0;
+}
+
+std::string QRMatrixText::text(QRMatrixBoard& board, TextMode mode, unsigned int quietZone, bool isInverted) {
+    std::string result(QRMatrixText::capacity(board, mode, quietZone), '\0');
+    if (result.empty()) {
+        return result;
+    }
+    result.resize(QRMatrixText::write(board, mode, &result[0], quietZone, isInverted));
+    return result;
+}
@@ -0,0 +1,89 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXTEXT_H
+#define QRMATRIXTEXT_H
+
+#include "../constants.h"
+#include "../qrmatrixboard.h"
+#include <string>
+
+namespace QRMatrix {
+
+    /// Text drawing of `QRMatrixText`
+    enum TextMode {
+        /// 1 character per cell, 2 rows of cells per line: "█", "▀", "▄" & " " (UTF-8). Smallest, for terminals.
+        halfBlocks,
+        /// 2 characters per cell, 1 row of cells per line: "##" for black, "  " for white (ASCII only)
+        asciiBlocks,
+        /// Debug: rows & columns indexes, "■" for black, "□" for white cells (`QRMatrixBoard::description()`)
+        cellColors,
+        /// Debug: as `cellColors` with mark of cell type before each cell (`QRMatrixBoard::description(true)`)
+        cellTypes
+    };
+
+    /// Draw `QRMatrixBoard` as text (eg. to print to console or log).
+    /// Text is written directly into a buffer of `capacity()` bytes, nothing is appended character by character.
+    class QRMatrixText {
+    public:
+        /// Maximum number of bytes written by `write()` (not including null terminator)
+        static unsigned int capacity(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Drawing
+            TextMode mode,
+            /// Number of cells of quiet zone around symbol (`halfBlocks` & `asciiBlocks` only)
+            unsigned int quietZone = 0
+        );
+
+        /// Write text of `board` into `output` (not null terminated). Each line ends with "\n".
+        /// `halfBlocks` & `asciiBlocks` read only the colors (`QRMatrixBoard::packed()`), debug modes read `QRMatrixBoard::buffer()`.
+        /// @return Number of bytes written.
+        static unsigned int write(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Drawing
+            TextMode mode,
+            /// Buffer of at least `capacity(board, mode, quietZone)` bytes
+            char* output,
+            /// Number of cells of quiet zone around symbol (`halfBlocks` & `asciiBlocks` only)
+            unsigned int quietZone = 0,
+            /// Swap black & white (`halfBlocks` & `asciiBlocks` only), eg. for light text on dark terminal
+            bool isInverted = false
+        );
+
+        /// Text of `board`
+        static std::string text(
+            /// Symbol to draw
+            QRMatrixBoard& board,
+            /// Drawing
+            TextMode mode = TextMode::halfBlocks,
+            /// Number of cells of quiet zone around symbol (`halfBlocks` & `asciiBlocks` only)
+            unsigned int quietZone = 0,
+            /// Swap black & white (`halfBlocks` & `asciiBlocks` only), eg. for light text on dark terminal
+            bool isInverted = false
+        );
+    };
+
+}
+
+#endif // QRMATRIXTEXT_H
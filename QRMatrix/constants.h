@@ -32,6 +32,7 @@
 using UnsignedByte      = unsigned char;
 using Unsigned2Bytes    = unsigned short;
 using Unsigned4Bytes    = unsigned int;
+using Unsigned8Bytes    = unsigned long long;
 
 /// Maximum QR version
 #define QR_MAX_VERSION          40
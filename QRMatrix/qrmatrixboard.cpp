@@ -21,9 +21,13 @@
 */
 
 #include "qrmatrixboard.h"
+#include "qrmatrixlayout.h"
+#include "Render/qrmatrixtext.h"
 #include "common.h"
 #include "Exception/qrmatrixexception.h"
 #include <math.h>
+#include <cstring>
+#include <atomic>
 
 #if LOGABLE
 #include "../DevTools/devtools.h"
@@ -32,56 +36,99 @@
 using namespace QRMatrix;
 using namespace std;
 
+/// Allocate rows of board in 1 block
+UnsignedByte** QRMatrixBoard_allocate(UnsignedByte dimension) {
+    UnsignedByte** result = new UnsignedByte* [dimension];
+    UnsignedByte* cells = new UnsignedByte [dimension * dimension];
+    for (UnsignedByte index = 0; index < dimension; index += 1) {
+        result[index] = cells + index * dimension;
+    }
+    return result;
+}
+
+void QRMatrixBoard_deallocate(UnsignedByte** buffer) {
+    delete[] buffer[0];
+    delete[] buffer;
+}
+
 QRMatrixBoard::~QRMatrixBoard() {
-    if (dimension_ == 0) {
-        return;
+    for (UnsignedByte alignment = 0; alignment < 2; alignment += 1) {
+        Unsigned8Bytes* packed = packed_[alignment].load(std::memory_order_relaxed);
+        if (packed != nullptr) {
+            delete[] packed;
+        }
     }
-    for (UnsignedByte index = 0; index < dimension_; index += 1) {
-        delete[] buffer_[index];
+    UnsignedByte** buffer = buffer_.load(std::memory_order_relaxed);
+    if (buffer != nullptr) {
+        QRMatrixBoard_deallocate(buffer);
     }
-    delete[] buffer_;
 }
 
 QRMatrixBoard::QRMatrixBoard(QRMatrixBoard &other) {
     dimension_ = other.dimension_;
-    buffer_ = new UnsignedByte* [dimension_];
-    for (UnsignedByte index = 0; index < dimension_; index += 1) {
-        buffer_[index] = new UnsignedByte [dimension_];
-        for (UnsignedByte jndex = 0; jndex < dimension_; jndex += 1) {
-            buffer_[index][jndex] = other.buffer_[index][jndex];
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    types_ = other.types_;
+    dataModulesCount_ = other.dataModulesCount_;
+    UnsignedByte** buffer = other.buffer_.load(std::memory_order_acquire);
+    if (buffer != nullptr) {
+        UnsignedByte** copy = QRMatrixBoard_allocate(dimension_);
+        memcpy(copy[0], buffer[0], dimension_ * dimension_);
+        buffer_.store(copy, std::memory_order_relaxed);
+    }
+    for (UnsignedByte alignment = 0; alignment < 2; alignment += 1) {
+        packed_[alignment].store(nullptr, std::memory_order_relaxed);
+        Unsigned8Bytes* packed = other.packed_[alignment].load(std::memory_order_acquire);
+        if (packed != nullptr) {
+            unsigned int wordsCount = (packedStride((BoardRowAlignment)alignment) * dimension_ + 7) / 8;
+            Unsigned8Bytes* copy = new Unsigned8Bytes [wordsCount];
+            memcpy(copy, packed, wordsCount * 8);
+            packed_[alignment].store(copy, std::memory_order_relaxed);
         }
     }
 }
 
-void QRMatrixBoard::operator=(QRMatrixBoard other) {
-    if (dimension_ > 0) {
-        for (UnsignedByte index = 0; index < dimension_; index += 1) {
-            delete[] buffer_[index];
-        }
-        delete[] buffer_;
-        buffer_ = nullptr;
+QRMatrixBoard::QRMatrixBoard(QRMatrixBoard &&other) {
+    // Take cells of `other` without copying
+    dimension_ = other.dimension_;
+    buffer_.store(other.buffer_.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_relaxed);
+    for (UnsignedByte alignment = 0; alignment < 2; alignment += 1) {
+        packed_[alignment].store(other.packed_[alignment].exchange(nullptr, std::memory_order_acq_rel), std::memory_order_relaxed);
     }
+    types_ = other.types_;
+    dataModulesCount_ = other.dataModulesCount_;
+    other.dimension_ = 0;
+    other.types_ = nullptr;
+}
+
+void QRMatrixBoard::operator=(QRMatrixBoard other) {
+    // `other` is already a copy, take its cells & let it release ours
+    UnsignedByte dimension = dimension_;
+    const QRMatrixLayout* types = types_;
     dimension_ = other.dimension_;
-    if (dimension_ > 0) {
-        buffer_ = new UnsignedByte* [dimension_];
-        for (UnsignedByte index = 0; index < dimension_; index += 1) {
-            buffer_[index] = new UnsignedByte [dimension_];
-            for (UnsignedByte jndex = 0; jndex < dimension_; jndex += 1) {
-                buffer_[index][jndex] = other.buffer_[index][jndex];
-            }
-        }
+    other.buffer_.store(buffer_.exchange(other.buffer_.load(std::memory_order_relaxed), std::memory_order_acq_rel), std::memory_order_relaxed);
+    for (UnsignedByte alignment = 0; alignment < 2; alignment += 1) {
+        Unsigned8Bytes* packed = other.packed_[alignment].load(std::memory_order_relaxed);
+        other.packed_[alignment].store(packed_[alignment].exchange(packed, std::memory_order_acq_rel), std::memory_order_relaxed);
     }
+    types_ = other.types_;
+    dataModulesCount_ = other.dataModulesCount_;
+    other.dimension_ = dimension;
+    other.types_ = types;
 }
 
 QRMatrixBoard::QRMatrixBoard() {
     dimension_ = 0;
-    buffer_ = nullptr;
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::byteAligned].store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::wordAligned].store(nullptr, std::memory_order_relaxed);
+    types_ = nullptr;
+    dataModulesCount_ = 0;
 }
 
 // Internal ========================================================================================
 
 void QRMatrixBoard_setSquare(
-    QRMatrixBoard* board,
+    UnsignedByte** buffer,
     UnsignedByte row,
     UnsignedByte column,
     UnsignedByte size,
@@ -90,7 +137,6 @@ void QRMatrixBoard_setSquare(
     UnsignedByte prefix
 ) {
     UnsignedByte value = (isSet ? BoardCell::set : BoardCell::unset) | prefix;
-    UnsignedByte** buffer = board->buffer();
     if (isFill) {
         for (UnsignedByte rIndex = row; rIndex < row + size; rIndex += 1) {
             for (UnsignedByte cIndex = column; cIndex < column + size; cIndex += 1) {
@@ -123,21 +169,20 @@ UnsignedByte QRMatrixBoard_remainderBitsLength(UnsignedByte version) {
 
 // Initinalize QR =============================================================================================
 
-void QRMatrixBoard_addFinderPattern(QRMatrixBoard* board, UnsignedByte row, UnsignedByte column) {
-    QRMatrixBoard_setSquare(board, row, column, 7, false, true, BoardCell::finder);
-    QRMatrixBoard_setSquare(board, row + 1, column + 1, 5, false, false, BoardCell::finder);
-    QRMatrixBoard_setSquare(board, row + 2, column + 2, 3, true, true, BoardCell::finder);
+void QRMatrixBoard_addFinderPattern(UnsignedByte** buffer, UnsignedByte row, UnsignedByte column) {
+    QRMatrixBoard_setSquare(buffer, row, column, 7, false, true, BoardCell::finder);
+    QRMatrixBoard_setSquare(buffer, row + 1, column + 1, 5, false, false, BoardCell::finder);
+    QRMatrixBoard_setSquare(buffer, row + 2, column + 2, 3, true, true, BoardCell::finder);
 }
 
-void QRMatrixBoard_addFinderPatterns(QRMatrixBoard* board, bool isMicro) {
-    QRMatrixBoard_addFinderPattern(board, 0, 0);
+void QRMatrixBoard_addFinderPatterns(UnsignedByte** buffer, UnsignedByte dimension, bool isMicro) {
+    QRMatrixBoard_addFinderPattern(buffer, 0, 0);
     if (isMicro) { return; }
-    QRMatrixBoard_addFinderPattern(board, 0, board->dimension() - 7);
-    QRMatrixBoard_addFinderPattern(board, board->dimension() - 7, 0);
+    QRMatrixBoard_addFinderPattern(buffer, 0, dimension - 7);
+    QRMatrixBoard_addFinderPattern(buffer, dimension - 7, 0);
 }
 
-void QRMatrixBoard_addSeparators(QRMatrixBoard* board, bool isMicro) {
-    UnsignedByte** buffer = board->buffer();
+void QRMatrixBoard_addSeparators(UnsignedByte** buffer, UnsignedByte dimension, bool isMicro) {
     UnsignedByte value = BoardCell::unset | BoardCell::separator;
     if (isMicro) {
         for (UnsignedByte index = 0; index < 8; index += 1) {
@@ -149,19 +194,18 @@ void QRMatrixBoard_addSeparators(QRMatrixBoard* board, bool isMicro) {
             buffer[7][index] = value;
             buffer[index][7] = value;
 
-            buffer[7][board->dimension() - index - 1] = value;
-            buffer[index][board->dimension() - 8] = value;
+            buffer[7][dimension - index - 1] = value;
+            buffer[index][dimension - 8] = value;
 
-            buffer[board->dimension() - 8][index] = value;
-            buffer[board->dimension() - index - 1][7] = value;
+            buffer[dimension - 8][index] = value;
+            buffer[dimension - index - 1][7] = value;
         }
     }
 }
 
-void QRMatrixBoard_addAlignmentPattern(QRMatrixBoard* board, UnsignedByte row, UnsignedByte column) {
+void QRMatrixBoard_addAlignmentPattern(UnsignedByte** buffer, UnsignedByte row, UnsignedByte column) {
     UnsignedByte tlRow = row - 2;
     UnsignedByte tlCol = column - 2;
-    UnsignedByte** buffer = board->buffer();
     for (UnsignedByte rIndex = tlRow; rIndex < tlRow + 5; rIndex += 1) {
         for (UnsignedByte cIndex = tlCol; cIndex < tlCol + 5; cIndex += 1) {
             if (buffer[rIndex][cIndex] != BoardCell::neutral) {
@@ -169,38 +213,37 @@ void QRMatrixBoard_addAlignmentPattern(QRMatrixBoard* board, UnsignedByte row, U
             }
         }
     }
-    QRMatrixBoard_setSquare(board, tlRow, tlCol, 5, false, true, BoardCell::alignment);
-    QRMatrixBoard_setSquare(board, tlRow + 1, tlCol + 1, 3, false, false, BoardCell::alignment);
+    QRMatrixBoard_setSquare(buffer, tlRow, tlCol, 5, false, true, BoardCell::alignment);
+    QRMatrixBoard_setSquare(buffer, tlRow + 1, tlCol + 1, 3, false, false, BoardCell::alignment);
     buffer[row][column] = BoardCell::set | BoardCell::alignment;
 }
 
-void QRMatrixBoard_addAlignmentPatterns(QRMatrixBoard* board, ErrorCorrectionInfo ecInfo) {
+void QRMatrixBoard_addAlignmentPatterns(UnsignedByte** buffer, ErrorCorrectionInfo ecInfo) {
     if (ecInfo.version < 2) return;
     const UnsignedByte* array = Common::alignmentLocations(ecInfo.version);
-    QRMatrixBoard_addAlignmentPattern(board, 6, 6);
+    QRMatrixBoard_addAlignmentPattern(buffer, 6, 6);
     for (UnsignedByte index = 0; index < 6; index += 1) {
         UnsignedByte value = array[index];
         if (value > 0) {
-            QRMatrixBoard_addAlignmentPattern(board, 6, value);
-            QRMatrixBoard_addAlignmentPattern(board, value, 6);
-            QRMatrixBoard_addAlignmentPattern(board, value, value);
+            QRMatrixBoard_addAlignmentPattern(buffer, 6, value);
+            QRMatrixBoard_addAlignmentPattern(buffer, value, 6);
+            QRMatrixBoard_addAlignmentPattern(buffer, value, value);
             for (UnsignedByte jndex = 0; jndex < 6; jndex += 1) {
                 UnsignedByte value2 = array[jndex];
                 if (value2 > 0 && value != value2) {
-                    QRMatrixBoard_addAlignmentPattern(board, value, value2);
-                    QRMatrixBoard_addAlignmentPattern(board, value2, value);
+                    QRMatrixBoard_addAlignmentPattern(buffer, value, value2);
+                    QRMatrixBoard_addAlignmentPattern(buffer, value2, value);
                 }
             }
         }
     }
 }
 
-void QRMatrixBoard_addTimingPatterns(QRMatrixBoard* board, bool isMicro) {
-    UnsignedByte** buffer = board->buffer();
+void QRMatrixBoard_addTimingPatterns(UnsignedByte** buffer, UnsignedByte dimension, bool isMicro) {
     UnsignedByte valueSet = BoardCell::timing | BoardCell::set;
     UnsignedByte valueUnset = BoardCell::timing | BoardCell::unset;
     UnsignedByte offset = isMicro ? 0 : 6;
-    for (UnsignedByte index = 6; index < board->dimension() - offset; index += 1) {
+    for (UnsignedByte index = 6; index < dimension - offset; index += 1) {
         if ((index % 2) == 0) {
             buffer[offset][index] = valueSet;
             buffer[index][offset] = valueSet;
@@ -211,10 +254,9 @@ void QRMatrixBoard_addTimingPatterns(QRMatrixBoard* board, bool isMicro) {
     }
 }
 
-void QRMatrixBoard_addDarkAndReservedAreas(QRMatrixBoard* board, ErrorCorrectionInfo ecInfo) {
-    UnsignedByte** buffer = board->buffer();
+void QRMatrixBoard_addDarkAndReservedAreas(UnsignedByte** buffer, UnsignedByte dimension, ErrorCorrectionInfo ecInfo) {
     // Dark cell
-    buffer[board->dimension() - 8][8] = BoardCell::dark | BoardCell::set;
+    buffer[dimension - 8][8] = BoardCell::dark | BoardCell::set;
     // Reseved cells for format
     for (UnsignedByte index = 0; index < 8; index += 1) {
         if (buffer[8][index] == BoardCell::neutral) {
@@ -223,23 +265,22 @@ void QRMatrixBoard_addDarkAndReservedAreas(QRMatrixBoard* board, ErrorCorrection
         if (buffer[index][8] == BoardCell::neutral) {
             buffer[index][8] = BoardCell::format | BoardCell::unset;
         }
-        if (buffer[board->dimension() - index - 1][8] == BoardCell::neutral) {
-            buffer[board->dimension() - index - 1][8] = BoardCell::format | BoardCell::unset;
+        if (buffer[dimension - index - 1][8] == BoardCell::neutral) {
+            buffer[dimension - index - 1][8] = BoardCell::format | BoardCell::unset;
         }
-        buffer[8][board->dimension() - index - 1] = BoardCell::format | BoardCell::unset;
+        buffer[8][dimension - index - 1] = BoardCell::format | BoardCell::unset;
     }
     buffer[8][8] = BoardCell::format | BoardCell::unset;
     if (ecInfo.version < 7) return;
     for (UnsignedByte index = 0; index < 3; index += 1) {
         for (UnsignedByte jndex = 0; jndex < 6; jndex += 1) {
-            buffer[jndex][board->dimension() - 9 - index] = BoardCell::version | BoardCell::unset;
-            buffer[board->dimension() - 9 - index][jndex] = BoardCell::version | BoardCell::unset;
+            buffer[jndex][dimension - 9 - index] = BoardCell::version | BoardCell::unset;
+            buffer[dimension - 9 - index][jndex] = BoardCell::version | BoardCell::unset;
         }
     }
 }
 
-void QRMatrixBoard_addMicroReservedAreas(QRMatrixBoard* board, ErrorCorrectionInfo ecInfo) {
-    UnsignedByte** buffer = board->buffer();
+void QRMatrixBoard_addMicroReservedAreas(UnsignedByte** buffer) {
     for (UnsignedByte index = 0; index < 8; index += 1) {
         if (buffer[8][index] == BoardCell::neutral) {
             buffer[8][index] = BoardCell::format | BoardCell::unset;
@@ -255,7 +296,7 @@ void QRMatrixBoard_addMicroReservedAreas(QRMatrixBoard* board, ErrorCorrectionIn
 
 /// Fill data bit into cell; increase data byte & bit index.
 void QRMatrixBoard_fillDataBit(
-    QRMatrixBoard* board,
+    UnsignedByte** buffer,
     UnsignedByte* data,
     UnsignedByte* errorCorrection,
     UnsignedByte phase,
@@ -264,7 +305,6 @@ void QRMatrixBoard_fillDataBit(
     int row,
     int column
 ) {
-    UnsignedByte** buffer = board->buffer();
     UnsignedByte value = 0;
     UnsignedByte mask = 0b10000000 >> *bitIndex;
     UnsignedByte prefix = 0x00;
@@ -342,7 +382,7 @@ bool QRMatrixBoard_checkFilledBit(
 
 /// Fill content, EC data into QR board
 void QRMatrixBoard_placeData(
-    QRMatrixBoard* board,
+    UnsignedByte** buffer, UnsignedByte dimension,
     UnsignedByte* data,
     UnsignedByte* errorCorrection,
     ErrorCorrectionInfo ecInfo,
@@ -351,8 +391,7 @@ void QRMatrixBoard_placeData(
 ) {
     bool isMicroV13 = isMicro && (ecInfo.version == 1 || ecInfo.version == 3);
     bool isUpward = true;
-    UnsignedByte** buffer = board->buffer();
-    int column = board->dimension() - 1;
+    int column = dimension - 1;
     unsigned int byteIndex = 0;
     UnsignedByte bitIndex = 0;
     unsigned int bitCount = 0;
@@ -366,17 +405,17 @@ void QRMatrixBoard_placeData(
 
     while (column >= 0 && !isCompleted) {
         int startValue = 0;
-        int endValue = board->dimension() - 1;
+        int endValue = dimension - 1;
         int step = 1;
         if (isUpward) {
-            startValue = board->dimension() - 1;
+            startValue = dimension - 1;
             endValue = 0;
             step = -1;
         }
         for (int row = startValue; (isUpward ? row >= endValue : row <= endValue) && !isCompleted; row += step) {
             if (buffer[row][column] == BoardCell::neutral) {
                 QRMatrixBoard_fillDataBit(
-                    board, data, errorCorrection, phase,
+                    buffer, data, errorCorrection, phase,
                     &byteIndex, &bitIndex, row, column
                     );
                 isCompleted = QRMatrixBoard_checkFilledBit(
@@ -386,7 +425,7 @@ void QRMatrixBoard_placeData(
             }
             if (column > 0 && buffer[row][column - 1] == BoardCell::neutral) {
                 QRMatrixBoard_fillDataBit(
-                    board, data, errorCorrection, phase,
+                    buffer, data, errorCorrection, phase,
                     &byteIndex, &bitIndex, row, column - 1
                     );
                 isCompleted = QRMatrixBoard_checkFilledBit(
@@ -405,12 +444,10 @@ void QRMatrixBoard_placeData(
 
 // Masking QR board =============================================================================================
 
-UnsignedByte** QRMatrixBoard_mask(QRMatrixBoard* board, UnsignedByte maskNum) {
-    UnsignedByte** result = new UnsignedByte* [board->dimension()];
-    UnsignedByte** buffer = board->buffer();
-    for (UnsignedByte row = 0; row < board->dimension(); row += 1) {
-        result[row] = new UnsignedByte [board->dimension()];
-        for (UnsignedByte column = 0; column < board->dimension(); column += 1) {
+/// Apply mask `maskNum` on `buffer` cells, write result into `result` (can be `buffer` itself).
+void QRMatrixBoard_mask(UnsignedByte** buffer, UnsignedByte dimension, UnsignedByte maskNum, UnsignedByte** result) {
+    for (UnsignedByte row = 0; row < dimension; row += 1) {
+        for (UnsignedByte column = 0; column < dimension; column += 1) {
             UnsignedByte byte = buffer[row][column];
             UnsignedByte low = byte & BoardCell::lowMask;
             UnsignedByte high = byte & BoardCell::highMask;
@@ -425,67 +462,36 @@ UnsignedByte** QRMatrixBoard_mask(QRMatrixBoard* board, UnsignedByte maskNum) {
                 low = BoardCell::set;
             }
             UnsignedByte maskedByte = low | high;
+            bool isMasked = false;
             switch (maskNum) {
             case 0:
-                if (((row + column) % 2) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = ((row + column) % 2) == 0;
                 break;
             case 1:
-                if ((row % 2) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = (row % 2) == 0;
                 break;
             case 2:
-                if ((column % 3) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = (column % 3) == 0;
                 break;
             case 3:
-                if (((row + column) % 3) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = ((row + column) % 3) == 0;
                 break;
             case 4:
-                if (((UnsignedByte)(floor((double)row / 2) + floor((double)column / 3)) % 2) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = ((row / 2 + column / 3) % 2) == 0;
                 break;
             case 5:
-                if (((row * column) % 2 + (row * column) % 3) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = ((row * column) % 2 + (row * column) % 3) == 0;
                 break;
             case 6:
-                if ((((row * column) % 2 + (row * column) % 3) % 2) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = (((row * column) % 2 + (row * column) % 3) % 2) == 0;
                 break;
             case 7:
-                if ((((row + column) % 2 + (row * column) % 3) % 2) == 0) {
-                    result[row][column] = maskedByte;
-                } else {
-                    result[row][column] = byte;
-                }
+                isMasked = (((row + column) % 2 + (row * column) % 3) % 2) == 0;
                 break;
             }
+            result[row][column] = isMasked ? maskedByte : byte;
         }
     }
-    return result;
 }
 
 // Evaluate masked boards to choose the best =============================================================================================
@@ -664,7 +670,7 @@ unsigned int QRMatrixBoard_evaluateMicro(UnsignedByte dimension, UnsignedByte**
     return sum2 * 16 + sum1;
 }
 
-UnsignedByte QRMatrixBoard_evaluate(QRMatrixBoard* board, UnsignedByte maskId, bool isMicro) {
+UnsignedByte QRMatrixBoard_evaluate(UnsignedByte** buffer, UnsignedByte dimension, UnsignedByte maskId, bool isMicro, UnsignedByte* maskBuffer) {
     static UnsignedByte microMaskIdMap[4] = {1, 4, 6, 7};
     bool isCustomMask = isMicro ? (maskId < 4) : (maskId < 8);
     if (isCustomMask) {
@@ -674,22 +680,21 @@ UnsignedByte QRMatrixBoard_evaluate(QRMatrixBoard* board, UnsignedByte maskId, b
     );
 #endif
         UnsignedByte mId = isMicro ? microMaskIdMap[maskId] : maskId;
-        UnsignedByte** mBoard = QRMatrixBoard_mask(board, mId);
-        UnsignedByte** buffer = board->buffer();
-        for (UnsignedByte row = 0; row < board->dimension(); row += 1) {
-            for (UnsignedByte column = 0; column < board->dimension(); column += 1) {
-                buffer[row][column] = mBoard[row][column];
-            }
-        }
-        for (UnsignedByte row = 0; row < board->dimension(); row += 1) {
-            delete[] mBoard[row];
-        }
-        delete[] mBoard;
+        QRMatrixBoard_mask(buffer, dimension, mId, buffer);
         return maskId;
     }
 
+    // Each mask is evaluated on the same scratch plane
+    UnsignedByte* plane = maskBuffer;
+    if (plane == nullptr) {
+        plane = new UnsignedByte [dimension * dimension];
+    }
+    UnsignedByte* maskedBoard[dimension];
+    for (UnsignedByte row = 0; row < dimension; row += 1) {
+        maskedBoard[row] = plane + row * dimension;
+    }
+
     UnsignedByte numMasks = isMicro ? 4 : 8;
-    UnsignedByte** maskedBoard[numMasks];
     unsigned int minScore = 0;
     UnsignedByte minId = 0;
     unsigned int maxScore = 0;
@@ -699,13 +704,13 @@ UnsignedByte QRMatrixBoard_evaluate(QRMatrixBoard* board, UnsignedByte maskId, b
 #endif
     for (UnsignedByte index = 0; index < numMasks; index += 1) {
         UnsignedByte mId = isMicro ? microMaskIdMap[index] : index;
-        maskedBoard[index] = QRMatrixBoard_mask(board, mId);
+        QRMatrixBoard_mask(buffer, dimension, mId, maskedBoard);
         unsigned int score = isMicro ?
-            QRMatrixBoard_evaluateMicro(board->dimension(), maskedBoard[index]) :
-            QRMatrixBoard_evaluateCondition1(board->dimension(), maskedBoard[index]) +
-            QRMatrixBoard_evaluateCondition2(board->dimension(), maskedBoard[index]) +
-            QRMatrixBoard_evaluateCondition3(board->dimension(), maskedBoard[index]) +
-            QRMatrixBoard_evaluateCondition4(board->dimension(), maskedBoard[index]);
+            QRMatrixBoard_evaluateMicro(dimension, maskedBoard) :
+            QRMatrixBoard_evaluateCondition1(dimension, maskedBoard) +
+            QRMatrixBoard_evaluateCondition2(dimension, maskedBoard) +
+            QRMatrixBoard_evaluateCondition3(dimension, maskedBoard) +
+            QRMatrixBoard_evaluateCondition4(dimension, maskedBoard);
 #if LOGABLE
     cout << "MASK [" << to_string(index).c_str() << "]: " << to_string(score).c_str() << endl;
 #endif
@@ -718,6 +723,9 @@ UnsignedByte QRMatrixBoard_evaluate(QRMatrixBoard* board, UnsignedByte maskId, b
             maxId = index;
         }
     }
+    if (maskBuffer == nullptr) {
+        delete[] plane;
+    }
 
     UnsignedByte lasId = isMicro ? maxId : minId;
 
@@ -727,20 +735,7 @@ UnsignedByte QRMatrixBoard_evaluate(QRMatrixBoard* board, UnsignedByte maskId, b
     );
 #endif
 
-    UnsignedByte** buffer = board->buffer();
-    for (UnsignedByte row = 0; row < board->dimension(); row += 1) {
-        for (UnsignedByte column = 0; column < board->dimension(); column += 1) {
-            buffer[row][column] = maskedBoard[lasId][row][column];
-        }
-    }
-
-    for (UnsignedByte index = 0; index < numMasks; index += 1) {
-        for (UnsignedByte row = 0; row < board->dimension(); row += 1) {
-            delete[] maskedBoard[index][row];
-        }
-        delete[] maskedBoard[index];
-    }
-
+    QRMatrixBoard_mask(buffer, dimension, isMicro ? microMaskIdMap[lasId] : lasId, buffer);
     return lasId;
 }
 
@@ -868,10 +863,9 @@ void QRMatrixBoard_setReservedCell(UnsignedByte row, UnsignedByte column, Unsign
     buffer[row][column] = high | (value & 0x0F);
 }
 
-void QRMatrixBoard_placeMicroFormat(QRMatrixBoard* board, UnsignedByte maskId, ErrorCorrectionInfo ecInfo) {
+void QRMatrixBoard_placeMicroFormat(UnsignedByte** buffer, UnsignedByte maskId, ErrorCorrectionInfo ecInfo) {
     UnsignedByte formatBits[2]; // Use first 15bits only
     QRMatrixBoard_getMicroFormatBits(ecInfo.level, ecInfo.version, maskId, formatBits);
-    UnsignedByte** buffer = board->buffer();
 
     for (UnsignedByte index = 0; index < 15; index += 1) {
         UnsignedByte byteIndex = index < 8 ? 0 : 1;
@@ -887,10 +881,9 @@ void QRMatrixBoard_placeMicroFormat(QRMatrixBoard* board, UnsignedByte maskId, E
     }
 }
 
-void QRMatrixBoard_placeFormatAndVersion(QRMatrixBoard* board, UnsignedByte maskId, ErrorCorrectionInfo ecInfo) {
+void QRMatrixBoard_placeFormatAndVersion(UnsignedByte** buffer, UnsignedByte dimension, UnsignedByte maskId, ErrorCorrectionInfo ecInfo) {
     UnsignedByte formatBits[2]; // Use first 15bits only
     QRMatrixBoard_getFormatBits(ecInfo.level, maskId, formatBits);
-    UnsignedByte** buffer = board->buffer();
 
     for (UnsignedByte index = 0; index < 15; index += 1) {
         UnsignedByte byteIndex = index < 8 ? 0 : 1;
@@ -900,23 +893,23 @@ void QRMatrixBoard_placeFormatAndVersion(QRMatrixBoard* board, UnsignedByte mask
         UnsignedByte cell = curByte > 0 ? BoardCell::set : BoardCell::unset;
         if (index < 6) {
             QRMatrixBoard_setReservedCell(8, index, buffer, cell);
-            QRMatrixBoard_setReservedCell(board->dimension() - index - 1, 8, buffer, cell);
+            QRMatrixBoard_setReservedCell(dimension - index - 1, 8, buffer, cell);
         } else if (index > 8) {
-            QRMatrixBoard_setReservedCell(8, board->dimension() - (15 - index), buffer, cell);
+            QRMatrixBoard_setReservedCell(8, dimension - (15 - index), buffer, cell);
             QRMatrixBoard_setReservedCell(14 - index, 8, buffer, cell);
         } else {
             switch (index) {
             case 6:
                 QRMatrixBoard_setReservedCell(8, index + 1, buffer, cell);
-                QRMatrixBoard_setReservedCell(board->dimension() - index - 1, 8, buffer, cell);
+                QRMatrixBoard_setReservedCell(dimension - index - 1, 8, buffer, cell);
                 break;
             case 7:
                 QRMatrixBoard_setReservedCell(8, index + 1, buffer, cell);
-                QRMatrixBoard_setReservedCell(8, board->dimension() - (15 - index), buffer, cell);
+                QRMatrixBoard_setReservedCell(8, dimension - (15 - index), buffer, cell);
                 break;
             case 8:
                 QRMatrixBoard_setReservedCell(14 - index + 1, 8, buffer, cell);
-                QRMatrixBoard_setReservedCell(8, board->dimension() - (15 - index), buffer, cell);
+                QRMatrixBoard_setReservedCell(8, dimension - (15 - index), buffer, cell);
                 break;
             default:
                 break;
@@ -928,10 +921,10 @@ void QRMatrixBoard_placeFormatAndVersion(QRMatrixBoard* board, UnsignedByte mask
 
     UnsignedByte version[3];
     QRMatrixBoard_getVersionBits(ecInfo.version, version);
-    UnsignedByte row1 = board->dimension() - 9;
+    UnsignedByte row1 = dimension - 9;
     UnsignedByte col1 = 5;
     UnsignedByte row2 = 5;
-    UnsignedByte col2 = board->dimension() - 9;
+    UnsignedByte col2 = dimension - 9;
 
     for (UnsignedByte index = 0; index < 18; index += 1) {
         UnsignedByte byteIndex = index / 8;
@@ -941,16 +934,16 @@ void QRMatrixBoard_placeFormatAndVersion(QRMatrixBoard* board, UnsignedByte mask
         UnsignedByte cell = curByte > 0 ? BoardCell::set : BoardCell::unset;
 
         QRMatrixBoard_setReservedCell(row1, col1, buffer, cell);
-        if (row1 == (board->dimension() - 11)) {
-            row1 = board->dimension() - 9;
+        if (row1 == (dimension - 11)) {
+            row1 = dimension - 9;
             col1 -= 1;
         } else {
             row1 -= 1;
         }
 
         QRMatrixBoard_setReservedCell(row2, col2, buffer, cell);
-        if (col2 == (board->dimension() - 11)) {
-            col2 = board->dimension() - 9;
+        if (col2 == (dimension - 11)) {
+            col2 = dimension - 9;
             row2 -= 1;
         } else {
             col2 -= 1;
@@ -960,116 +953,361 @@ void QRMatrixBoard_placeFormatAndVersion(QRMatrixBoard* board, UnsignedByte mask
 
 // INIT =============================================================================================
 
-QRMatrixBoard::QRMatrixBoard(
-    UnsignedByte* data,
-    UnsignedByte* errorCorrection,
-    ErrorCorrectionInfo ecInfo,
-    UnsignedByte maskId,
+void QRMatrixBoard::initialize(
+    UnsignedByte** buffer,
+    UnsignedByte dimension,
+    ErrorCorrectionInfo& ecInfo,
     bool isMicro
 ) {
-    dimension_ = isMicro ?
-        Common::microDimensionByVersion(ecInfo.version) :
-        Common::dimensionByVersion(ecInfo.version);
-    buffer_ = new UnsignedByte* [dimension_];
-    for (UnsignedByte index = 0; index < dimension_; index += 1) {
-        buffer_[index] = new UnsignedByte [dimension_];
-        for (UnsignedByte jndex = 0; jndex < dimension_; jndex += 1) {
-            buffer_[index][jndex] = BoardCell::neutral;
-        }
+    for (UnsignedByte row = 0; row < dimension; row += 1) {
+        memset(buffer[row], BoardCell::neutral, dimension);
     }
-    QRMatrixBoard_addFinderPatterns(this, isMicro);
-    QRMatrixBoard_addSeparators(this, isMicro);
+    QRMatrixBoard_addFinderPatterns(buffer, dimension, isMicro);
+    QRMatrixBoard_addSeparators(buffer, dimension, isMicro);
     if (!isMicro) {
-        QRMatrixBoard_addAlignmentPatterns(this, ecInfo);
+        QRMatrixBoard_addAlignmentPatterns(buffer, ecInfo);
+    }
+    QRMatrixBoard_addTimingPatterns(buffer, dimension, isMicro);
+    if (isMicro) {
+        QRMatrixBoard_addMicroReservedAreas(buffer);
+    } else {
+        QRMatrixBoard_addDarkAndReservedAreas(buffer, dimension, ecInfo);
     }
-    QRMatrixBoard_addTimingPatterns(this, isMicro);
+}
+
+UnsignedByte QRMatrixBoard::finish(
+    UnsignedByte** buffer,
+    UnsignedByte dimension,
+    ErrorCorrectionInfo& ecInfo,
+    UnsignedByte maskId,
+    bool isMicro,
+    UnsignedByte* maskBuffer
+) {
+    UnsignedByte lastMaskId = QRMatrixBoard_evaluate(buffer, dimension, maskId, isMicro, maskBuffer);
     if (isMicro) {
-        QRMatrixBoard_addMicroReservedAreas(this, ecInfo);
+        QRMatrixBoard_placeMicroFormat(buffer, lastMaskId, ecInfo);
     } else {
-        QRMatrixBoard_addDarkAndReservedAreas(this, ecInfo);
+        QRMatrixBoard_placeFormatAndVersion(buffer, dimension, lastMaskId, ecInfo);
     }
+    return lastMaskId;
+}
+
+void QRMatrixBoard::build(
+    UnsignedByte** buffer,
+    UnsignedByte dimension,
+    UnsignedByte* data,
+    UnsignedByte* errorCorrection,
+    ErrorCorrectionInfo& ecInfo,
+    UnsignedByte maskId,
+    bool isMicro,
+    UnsignedByte* maskBuffer
+) {
+    QRMatrixBoard::initialize(buffer, dimension, ecInfo, isMicro);
     QRMatrixBoard_placeData(
-        this, data, errorCorrection, ecInfo,
+        buffer, dimension, data, errorCorrection, ecInfo,
         isMicro ? 0 : QRMatrixBoard_remainderBitsLength(ecInfo.version),
         isMicro
     );
-    UnsignedByte lastMaskId = QRMatrixBoard_evaluate(this, maskId, isMicro);
+    QRMatrixBoard::finish(buffer, dimension, ecInfo, maskId, isMicro, maskBuffer);
+}
+
+unsigned int QRMatrixBoard::dataModules(
+    UnsignedByte** buffer,
+    UnsignedByte dimension,
+    bool isMicro,
+    Unsigned2Bytes* positions,
+    unsigned int count
+) {
+    // Same order as `QRMatrixBoard_placeData`: 2-column strips from the right, alternately upward & downward
+    bool isUpward = true;
+    int column = dimension - 1;
+    unsigned int found = 0;
+    while (column >= 0 && found < count) {
+        for (int index = 0; index < dimension && found < count; index += 1) {
+            int row = isUpward ? dimension - 1 - index : index;
+            if (buffer[row][column] == BoardCell::neutral) {
+                positions[found] = row * dimension + column;
+                found += 1;
+            }
+            if (column > 0 && found < count && buffer[row][column - 1] == BoardCell::neutral) {
+                positions[found] = row * dimension + column - 1;
+                found += 1;
+            }
+        }
+        column -= 2;
+        if (!isMicro && column == 6) {
+            column -= 1;
+        }
+        isUpward = !isUpward;
+    }
+    return found;
+}
+
+UnsignedByte QRMatrixBoard::remainderBitsCount(UnsignedByte version, bool isMicro) {
+    return isMicro ? 0 : QRMatrixBoard_remainderBitsLength(version);
+}
+
+Unsigned2Bytes QRMatrixBoard::formatBits(ErrorCorrectionLevel level, UnsignedByte version, UnsignedByte maskId, bool isMicro) {
+    UnsignedByte buffer[2];
     if (isMicro) {
-        QRMatrixBoard_placeMicroFormat(this, lastMaskId, ecInfo);
+        QRMatrixBoard_getMicroFormatBits(level, version, maskId, buffer);
     } else {
-        QRMatrixBoard_placeFormatAndVersion(this, lastMaskId, ecInfo);
+        QRMatrixBoard_getFormatBits(level, maskId, buffer);
     }
+    return (Unsigned2Bytes)(((buffer[0] << 8) | buffer[1]) >> 1);
 }
 
-// PRINT =============================================================================================
+Unsigned4Bytes QRMatrixBoard::versionBits(UnsignedByte version) {
+    UnsignedByte buffer[3];
+    QRMatrixBoard_getVersionBits(version, buffer);
+    return ((buffer[0] << 16) | (buffer[1] << 8) | buffer[2]) >> 6;
+}
 
-string QRMatrixBoard::description(bool isTypeVisible) {
-    if (dimension_ == 0) {
-        return "";
+/// Cells types of each version (QR 1...40 then MicroQR 1...4), made at the first use & never released.
+/// Function patterns & codewords placement do not depend on error correction level
+/// (boards keep their number of data codewords cells), so boards of all levels share 1 layout without lock.
+static std::atomic<const QRMatrixLayout*> QRMatrixBoard_typesLayouts[QR_MAX_VERSION + MICROQR_MAX_VERSION];
+
+const QRMatrixLayout* QRMatrixBoard_types(UnsignedByte version, bool isMicro) {
+    std::atomic<const QRMatrixLayout*>& slot = QRMatrixBoard_typesLayouts[isMicro ? QR_MAX_VERSION + version - 1 : version - 1];
+    const QRMatrixLayout* result = slot.load(std::memory_order_acquire);
+    if (result != nullptr) {
+        return result;
+    }
+    ErrorCorrectionInfo ecInfo = isMicro ?
+        ErrorCorrectionInfo::microErrorCorrectionInfo(version, ErrorCorrectionLevel::low) :
+        ErrorCorrectionInfo::errorCorrectionInfo(version, ErrorCorrectionLevel::low);
+    const QRMatrixLayout* layout = new QRMatrixLayout(ecInfo, isMicro, 0xFF);
+    if (slot.compare_exchange_strong(result, layout, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return layout;
+    }
+    // Made by another thread meanwhile
+    delete layout;
+    return result;
+}
+
+QRMatrixBoard::QRMatrixBoard(UnsignedByte dimension) {
+    dimension_ = dimension;
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::byteAligned].store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::wordAligned].store(nullptr, std::memory_order_relaxed);
+    types_ = nullptr;
+    dataModulesCount_ = 0;
+    if (dimension_ > 0) {
+        UnsignedByte** buffer = QRMatrixBoard_allocate(dimension_);
+        memset(buffer[0], BoardCell::neutral, dimension_ * dimension_);
+        buffer_.store(buffer, std::memory_order_relaxed);
+    }
+}
+
+QRMatrixBoard::QRMatrixBoard(const QRMatrixLayout& types, const UnsignedByte* colors, unsigned int stride) {
+    dimension_ = types.dimension();
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::wordAligned].store(nullptr, std::memory_order_relaxed);
+    types_ = &types;
+    dataModulesCount_ = types.dataModulesCount();
+    unsigned int packedStride = QRMatrixBoard::packedStride(BoardRowAlignment::byteAligned);
+    unsigned int wordsCount = (packedStride * dimension_ + 7) / 8;
+    Unsigned8Bytes* packed = new Unsigned8Bytes [wordsCount];
+    memset(packed, 0, wordsCount * 8);
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        memcpy((UnsignedByte*)packed + row * packedStride, colors + row * stride, packedStride);
+    }
+    packed_[BoardRowAlignment::byteAligned].store(packed, std::memory_order_relaxed);
+}
+
+QRMatrixBoard::QRMatrixBoard(
+    UnsignedByte* data,
+    UnsignedByte* errorCorrection,
+    ErrorCorrectionInfo ecInfo,
+    UnsignedByte maskId,
+    bool isMicro,
+    UnsignedByte* maskBuffer,
+    UnsignedByte* cells
+) {
+    dimension_ = isMicro ?
+        Common::microDimensionByVersion(ecInfo.version) :
+        Common::dimensionByVersion(ecInfo.version);
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::byteAligned].store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::wordAligned].store(nullptr, std::memory_order_relaxed);
+    UnsignedByte* scratch = cells != nullptr ? cells : new UnsignedByte [dimension_ * dimension_];
+    UnsignedByte* rows[dimension_];
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        rows[row] = scratch + row * dimension_;
     }
-    string result = "  ";
-    for (UnsignedByte index = 0; index < dimension_; index += 1) {
-        if (index % 2 > 0) {
-            result.append("..");
-            continue;
+    QRMatrixBoard::build(rows, dimension_, data, errorCorrection, ecInfo, maskId, isMicro, maskBuffer);
+    keepColors(rows, ecInfo, isMicro);
+    if (cells == nullptr) {
+        delete[] scratch;
+    }
+}
+
+QRMatrixBoard::QRMatrixBoard(const UnsignedByte* cells, const ErrorCorrectionInfo& ecInfo, bool isMicro) {
+    dimension_ = isMicro ?
+        Common::microDimensionByVersion(ecInfo.version) :
+        Common::dimensionByVersion(ecInfo.version);
+    buffer_.store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::byteAligned].store(nullptr, std::memory_order_relaxed);
+    packed_[BoardRowAlignment::wordAligned].store(nullptr, std::memory_order_relaxed);
+    const UnsignedByte* rows[dimension_];
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        rows[row] = cells + row * dimension_;
+    }
+    keepColors(rows, ecInfo, isMicro);
+}
+
+/// Pack colors of cells (of a symbol of given version) into the color plane, cells types are taken from shared layout
+void QRMatrixBoard::keepColors(const UnsignedByte* const* rows, const ErrorCorrectionInfo& ecInfo, bool isMicro) {
+    unsigned int stride = packedStride(BoardRowAlignment::byteAligned);
+    unsigned int wordsCount = (stride * dimension_ + 7) / 8;
+    Unsigned8Bytes* packed = new Unsigned8Bytes [wordsCount];
+    memset(packed, 0, wordsCount * 8);
+    QRMatrixBoard::pack(rows, dimension_, (UnsignedByte*)packed, stride);
+    packed_[BoardRowAlignment::byteAligned].store(packed, std::memory_order_relaxed);
+    types_ = QRMatrixBoard_types(ecInfo.version, isMicro);
+    dataModulesCount_ = ecInfo.codewords * 8;
+    if (isMicro && (ecInfo.version == 1 || ecInfo.version == 3)) {
+        // Last data codeword of M1 & M3 has 4 bits
+        dataModulesCount_ -= 4;
+    }
+}
+
+void QRMatrixBoard::pack(const UnsignedByte* const* buffer, UnsignedByte dimension, UnsignedByte* output, unsigned int stride) {
+    for (UnsignedByte row = 0; row < dimension; row += 1) {
+        const UnsignedByte* cells = buffer[row];
+        UnsignedByte* bits = output + row * stride;
+        UnsignedByte byte = 0;
+        for (UnsignedByte column = 0; column < dimension; column += 1) {
+            byte <<= 1;
+            if ((cells[column] & BoardCell::lowMask) == BoardCell::set) {
+                byte |= 1;
+            }
+            if ((column % 8) == 7) {
+                bits[column / 8] = byte;
+                byte = 0;
+            }
         }
-        if (index < 10) {
-            result.append("0");
+        if ((dimension % 8) > 0) {
+            bits[dimension / 8] = byte << (8 - (dimension % 8));
         }
-        result.append(to_string(index));
     }
-    result.append("\n");
-    for (UnsignedByte index = 0; index < dimension_; index += 1) {
-        if (index < 10) {
-            result.append("0");
+}
+
+unsigned int QRMatrixBoard::packedStride(BoardRowAlignment alignment) {
+    if (alignment == BoardRowAlignment::wordAligned) {
+        return (dimension_ + 63) / 64 * 8;
+    }
+    return (dimension_ + 7) / 8;
+}
+
+const UnsignedByte* QRMatrixBoard::packed(BoardRowAlignment alignment) {
+    if (dimension_ == 0) {
+        return nullptr;
+    }
+    Unsigned8Bytes* result = packed_[alignment].load(std::memory_order_acquire);
+    if (result != nullptr) {
+        return (const UnsignedByte*)result;
+    }
+    Unsigned8Bytes* packed = makePacked(alignment);
+    if (packed_[alignment].compare_exchange_strong(result, packed, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return (const UnsignedByte*)packed;
+    }
+    // Made by another thread meanwhile
+    delete[] packed;
+    return (const UnsignedByte*)result;
+}
+
+void QRMatrixBoard::invalidatePacked() {
+    if (buffer_.load(std::memory_order_acquire) == nullptr) {
+        return;
+    }
+    for (UnsignedByte alignment = 0; alignment < 2; alignment += 1) {
+        Unsigned8Bytes* packed = packed_[alignment].exchange(nullptr, std::memory_order_acq_rel);
+        if (packed != nullptr) {
+            delete[] packed;
         }
-        result.append(to_string(index));
-        for (UnsignedByte jndex = 0; jndex < dimension_; jndex += 1) {
-            UnsignedByte byte = buffer_[index][jndex];
-            if (!isTypeVisible) {
-                UnsignedByte low = byte & BoardCell::lowMask;
-                if (low == BoardCell::unset) {
-                    result.append(" □");
-                } else if (low == BoardCell::set) {
-                    result.append(" ■");
-                } else {
-                    result.append("  ");
-                }
-            } else {
-                if (byte == BoardCell::neutral) {
-                    result.append(" +");
-                } else {
-                    UnsignedByte low = byte & BoardCell::lowMask;
-                    UnsignedByte high = byte & BoardCell::highMask;
-                    bool isFunc = (byte & BoardCell::funcMask) > 0;
-                    if (high == BoardCell::format || high == BoardCell::version) {
-                        result.append("®");
-                    } else if (isFunc) {
-                        result.append("•");
-                    } else if (high == BoardCell::errorCorrection) {
-                        result.append(".");
-                    } else {
-                        result.append(" ");
-                    }
-                    switch (low) {
-                    case BoardCell::unset:
-                        result.append("□");
-                        break;
-                    case BoardCell::set:
-                        result.append("■");
-                        break;
-                    default:
-                        if (high == BoardCell::format || high == BoardCell::version) {
-                            result.append("®");
-                        } else {
-                            result.append(" ");
-                        }
-                        break;
-                    }
-                }
+    }
+}
+
+/// Make color plane of given padding from cells or from the `byteAligned` plane
+Unsigned8Bytes* QRMatrixBoard::makePacked(BoardRowAlignment alignment) {
+    unsigned int newStride = packedStride(alignment);
+    unsigned int wordsCount = (newStride * dimension_ + 7) / 8;
+    Unsigned8Bytes* words = new Unsigned8Bytes [wordsCount];
+    memset(words, 0, wordsCount * 8);
+    UnsignedByte** buffer = buffer_.load(std::memory_order_acquire);
+    if (buffer != nullptr) {
+        QRMatrixBoard::pack(buffer, dimension_, (UnsignedByte*)words, newStride);
+        return words;
+    }
+    // `byteAligned` plane is the cells so it exists here
+    const UnsignedByte* colors = (const UnsignedByte*)packed_[BoardRowAlignment::byteAligned].load(std::memory_order_acquire);
+    unsigned int stride = packedStride(BoardRowAlignment::byteAligned);
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        // Padding bits are 0 so the shorter row is enough
+        memcpy((UnsignedByte*)words + row * newStride, colors + row * stride, stride < newStride ? stride : newStride);
+    }
+    return words;
+}
+
+/// Make cells from color plane & types of layout
+UnsignedByte** QRMatrixBoard::expand() {
+    UnsignedByte** buffer = QRMatrixBoard_allocate(dimension_);
+    const UnsignedByte* types = types_->cells();
+    const UnsignedByte* colors = (const UnsignedByte*)packed_[BoardRowAlignment::byteAligned].load(std::memory_order_acquire);
+    unsigned int stride = packedStride(BoardRowAlignment::byteAligned);
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        UnsignedByte* cells = buffer[row];
+        const UnsignedByte* rowTypes = types + row * dimension_;
+        const UnsignedByte* bits = colors + row * stride;
+        for (UnsignedByte column = 0; column < dimension_; column += 1) {
+            // Codewords cells are filled below; cells out of codewords (if any) stay neutral
+            if (rowTypes[column] == BoardCell::neutral) {
+                cells[column] = BoardCell::neutral;
+                continue;
             }
+            bool isDark = (bits[column / 8] >> (7 - column % 8)) & 1;
+            cells[column] = (rowTypes[column] & BoardCell::highMask) | (isDark ? BoardCell::set : BoardCell::unset);
         }
-        result.append("\n");
     }
+    for (unsigned int index = 0; index < types_->modulesCount(); index += 1) {
+        Unsigned2Bytes position = types_->position(index);
+        UnsignedByte row = position / dimension_;
+        UnsignedByte column = position % dimension_;
+        bool isDark = (colors[row * stride + column / 8] >> (7 - column % 8)) & 1;
+        buffer[row][column] = (index < dataModulesCount_ ? 0x00 : BoardCell::errorCorrection) |
+            (isDark ? BoardCell::set : BoardCell::unset);
+    }
+    return buffer;
+}
+
+UnsignedByte** QRMatrixBoard::buffer() {
+    UnsignedByte** result = buffer_.load(std::memory_order_acquire);
+    if (result != nullptr || dimension_ == 0) {
+        return result;
+    }
+    UnsignedByte** buffer = expand();
+    if (buffer_.compare_exchange_strong(result, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return buffer;
+    }
+    // Made by another thread meanwhile
+    QRMatrixBoard_deallocate(buffer);
     return result;
 }
+
+bool QRMatrixBoard::isDark(UnsignedByte row, UnsignedByte column) {
+    UnsignedByte** buffer = buffer_.load(std::memory_order_acquire);
+    if (buffer != nullptr) {
+        return (buffer[row][column] & BoardCell::lowMask) == BoardCell::set;
+    }
+    const UnsignedByte* bits = (const UnsignedByte*)packed_[BoardRowAlignment::byteAligned].load(std::memory_order_acquire) +
+        row * packedStride(BoardRowAlignment::byteAligned);
+    return (bits[column / 8] >> (7 - column % 8)) & 1;
+}
+
+// PRINT =============================================================================================
+
+string QRMatrixBoard::description(bool isTypeVisible) {
+    return QRMatrixText::text(*this, isTypeVisible ? TextMode::cellTypes : TextMode::cellColors);
+}
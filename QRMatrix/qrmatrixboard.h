@@ -25,11 +25,13 @@
 
 #include "constants.h"
 #include <string>
+#include <atomic>
 
 namespace QRMatrix {
 
     /// Internal data model
     struct ErrorCorrectionInfo;
+    class QRMatrixLayout;
 
     /// Value of QR board cell
     enum BoardCell {
@@ -66,31 +68,156 @@ namespace QRMatrix {
         funcMask        = 0x70
     };
 
-    /// QR cells (modules) (not inclues quiet zone)
+    /// Layout of QR cells written into a buffer
+    enum BoardFormat {
+        /// 1 byte per cell (`BoardCell` value)
+        cellBytes,
+        /// 1 bit per cell (1 for black, 0 for white), most significant bit first.
+        /// Each row takes (dimension + 7) / 8 bytes, last bits are padded with 0.
+        packedBits
+    };
+
+    /// Padding of rows of `QRMatrixBoard::packed`
+    enum BoardRowAlignment {
+        /// Each row takes (dimension + 7) / 8 bytes
+        byteAligned,
+        /// Each row takes a multiple of 8 bytes (64 bits words), rows start at 8 bytes aligned addresses
+        wordAligned
+    };
+
+    /// QR cells (modules) (not inclues quiet zone).
+    /// Boards made by `QRMatrixEncoder` keep only their color plane (1 bit per cell, see `packed()`);
+    /// cells types are restored from the shared layout of their version when `buffer()` is called.
     class QRMatrixBoard {
     public:
         ~QRMatrixBoard();
         QRMatrixBoard(QRMatrixBoard &other);
+        QRMatrixBoard(QRMatrixBoard &&other);
         void operator=(QRMatrixBoard other);
         /// Place holder. Internal purpose. Do not use.
         QRMatrixBoard();
         /// To create QR board, refer `QRMatrixEncoder`.
         /// This constructor is for internal purpose.
-        QRMatrixBoard(UnsignedByte* data, UnsignedByte* errorCorrection, ErrorCorrectionInfo ecInfo, UnsignedByte maskId, bool isMicro);
+        /// `maskBuffer`: optional scratch memory of `dimension * dimension` bytes for masks evaluation.
+        /// `cells`: optional scratch memory of `dimension * dimension` bytes to build cells before keeping their colors.
+        QRMatrixBoard(
+            UnsignedByte* data,
+            UnsignedByte* errorCorrection,
+            ErrorCorrectionInfo ecInfo,
+            UnsignedByte maskId,
+            bool isMicro,
+            UnsignedByte* maskBuffer = nullptr,
+            UnsignedByte* cells = nullptr
+        );
+        /// Internal purpose.
+        /// Board of colors of `dimension * dimension` final `cells` (`BoardCell` values, not kept) of a symbol of given version.
+        QRMatrixBoard(const UnsignedByte* cells, const ErrorCorrectionInfo& ecInfo, bool isMicro);
+        /// Internal purpose.
+        /// Board of given dimension, all cells are `BoardCell::neutral`.
+        QRMatrixBoard(UnsignedByte dimension);
+        /// Internal purpose.
+        /// Board of cells types of `types` (which must be kept alive) and colors of `dimension` rows of `colors`
+        /// (`BoardFormat::packedBits` format, rows are `stride` bytes apart).
+        QRMatrixBoard(const QRMatrixLayout& types, const UnsignedByte* colors, unsigned int stride);
 
         /// Size (dimension - number of cells on each side)
         inline UnsignedByte dimension() { return dimension_; }
-        /// UnsignedByte[row][column]: 1 byte per cell.
+        /// UnsignedByte[row][column]: 1 byte per cell (rows are stored contiguously).
         /// High word (left 4 bits) is cell type.
         /// Low word (right 4 bits) is black or white.
         /// See `BoardCell` for values.
-        inline UnsignedByte** buffer() { return buffer_; }
+        /// If the board keeps only its color plane, this view is made at the first call & kept
+        /// (concurrent first calls get the same view); after that, changes of cells must be done via this view.
+        UnsignedByte** buffer();
+        /// True if cell at given position is black.
+        bool isDark(UnsignedByte row, UnsignedByte column);
 
-        /// To print to Console
+        /// Color plane of cells: 1 bit per cell (1 for black), most significant bit first, padding bits are 0.
+        /// Row `r` starts at `packed() + r * packedStride()`.
+        /// It is made at the first call (concurrent first calls get the same plane) & kept until the board is changed
+        /// or `invalidatePacked()` is called.
+        const UnsignedByte* packed(BoardRowAlignment alignment = BoardRowAlignment::byteAligned);
+        /// Number of bytes of each row of `packed(alignment)`
+        unsigned int packedStride(BoardRowAlignment alignment = BoardRowAlignment::byteAligned);
+        /// Forget the color planes made by `packed()`. Call this after changing cells via `buffer()`.
+        /// Does nothing if `buffer()` is not made (the color plane is then the cells).
+        /// Like changing cells, it must not run while other threads read the board.
+        void invalidatePacked();
+
+        /// To print to Console (see `QRMatrixText` for other drawings)
         std::string description(bool isTypeVisible = false);
+
+        /// Internal purpose.
+        /// Fill QR cells into `dimension` rows of `buffer` (each row has `dimension` bytes).
+        static void build(
+            UnsignedByte** buffer,
+            UnsignedByte dimension,
+            UnsignedByte* data,
+            UnsignedByte* errorCorrection,
+            ErrorCorrectionInfo& ecInfo,
+            UnsignedByte maskId,
+            bool isMicro,
+            UnsignedByte* maskBuffer
+        );
+        /// Internal purpose.
+        /// Fill function patterns & reserve format (and version) cells of `dimension` rows of `buffer`.
+        /// Data cells are left `BoardCell::neutral`.
+        static void initialize(
+            UnsignedByte** buffer,
+            UnsignedByte dimension,
+            ErrorCorrectionInfo& ecInfo,
+            bool isMicro
+        );
+        /// Internal purpose.
+        /// Mask data cells of `buffer` (the best mask if `maskId` is not valid) and fill format (and version) cells.
+        /// @return Applied mask.
+        static UnsignedByte finish(
+            UnsignedByte** buffer,
+            UnsignedByte dimension,
+            ErrorCorrectionInfo& ecInfo,
+            UnsignedByte maskId,
+            bool isMicro,
+            UnsignedByte* maskBuffer
+        );
+        /// Internal purpose.
+        /// Write positions (`row * dimension + column`) of the first `count` data cells of initialized `buffer`
+        /// into `positions`, in the order codewords bits are placed.
+        /// @return Number of found cells.
+        static unsigned int dataModules(
+            UnsignedByte** buffer,
+            UnsignedByte dimension,
+            bool isMicro,
+            Unsigned2Bytes* positions,
+            unsigned int count
+        );
+        /// Internal purpose.
+        /// Number of remainder cells after codewords of given version.
+        static UnsignedByte remainderBitsCount(UnsignedByte version, bool isMicro);
+        /// Internal purpose.
+        /// Format information of symbol: 15 bits, the first placed bit is bit 14.
+        static Unsigned2Bytes formatBits(ErrorCorrectionLevel level, UnsignedByte version, UnsignedByte maskId, bool isMicro);
+        /// Internal purpose.
+        /// Version information of QR version 7...40: 18 bits, the first placed bit is bit 17.
+        static Unsigned4Bytes versionBits(UnsignedByte version);
+        /// Internal purpose.
+        /// Write QR cells of `buffer` into `output` in `BoardFormat::packedBits` format,
+        /// rows are `stride` bytes apart.
+        static void pack(const UnsignedByte* const* buffer, UnsignedByte dimension, UnsignedByte* output, unsigned int stride);
     private:
         UnsignedByte dimension_;
-        UnsignedByte** buffer_;
+        /// Cells (`nullptr` if the board keeps only its color plane), published once by `buffer()`
+        std::atomic<UnsignedByte**> buffer_;
+        /// Color planes by `BoardRowAlignment` (64 bits words for alignment), published once by `packed()`.
+        /// The `byteAligned` plane is the cells if `buffer_` is not made.
+        std::atomic<Unsigned8Bytes*> packed_[2];
+        /// Source of cells types if `buffer_` is not made
+        const QRMatrixLayout* types_;
+        /// Number of data codewords cells (the first cells of `types_` positions), others are error correction cells
+        unsigned int dataModulesCount_;
+
+        UnsignedByte** expand();
+        Unsigned8Bytes* makePacked(BoardRowAlignment alignment);
+        void keepColors(const UnsignedByte* const* rows, const ErrorCorrectionInfo& ecInfo, bool isMicro);
     };
 
 }
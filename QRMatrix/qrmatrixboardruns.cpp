@@ -0,0 +1,160 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixboardruns.h"
+
+using namespace QRMatrix;
+
+/// Number of leading 0 bits of non zero word
+#if defined(__GNUC__) || defined(__clang__)
+#define QRMatrixBoardRuns_leadingZeros(word) ((unsigned int)__builtin_clzll(word))
+#else
+unsigned int QRMatrixBoardRuns_leadingZeros(Unsigned8Bytes word) {
+    unsigned int result = 0;
+    while ((word & 0x8000000000000000ULL) == 0) {
+        word <<= 1;
+        result += 1;
+    }
+    return result;
+}
+#endif
+
+/// 64 bits from bit `position` of row (first bit is the highest bit), bits after row are 0.
+/// `count` is set to the number of bits of row in result.
+Unsigned8Bytes QRMatrixBoardRuns_word(const UnsignedByte* bits, unsigned int bytesCount, unsigned int position, unsigned int* count) {
+    unsigned int byteIndex = position / 8;
+    Unsigned8Bytes word = 0;
+    if (byteIndex + 8 <= bytesCount) {
+        for (unsigned int index = 0; index < 8; index += 1) {
+            word = (word << 8) | bits[byteIndex + index];
+        }
+    } else {
+        for (unsigned int index = 0; index < 8; index += 1) {
+            word = (word << 8) | (byteIndex + index < bytesCount ? bits[byteIndex + index] : 0);
+        }
+    }
+    *count = 64 - position % 8;
+    return word << (position % 8);
+}
+
+unsigned int QRMatrixBoardRuns::find(const UnsignedByte* bits, UnsignedByte dimension, unsigned int column, unsigned int* length) {
+    unsigned int bytesCount = (dimension + 7) / 8;
+    unsigned int count = 0;
+    // First black cell
+    unsigned int start = column;
+    while (start < dimension) {
+        Unsigned8Bytes word = QRMatrixBoardRuns_word(bits, bytesCount, start, &count);
+        if (word != 0) {
+            start += QRMatrixBoardRuns_leadingZeros(word);
+            break;
+        }
+        start += count;
+    }
+    if (start >= dimension) {
+        *length = 0;
+        return dimension;
+    }
+    // First white cell after it (padding bits are 0)
+    unsigned int end = start;
+    while (end < dimension) {
+        Unsigned8Bytes word = ~QRMatrixBoardRuns_word(bits, bytesCount, end, &count);
+        // Ignore bits shifted in
+        word &= ~0ULL << (64 - count);
+        if (word != 0) {
+            end += QRMatrixBoardRuns_leadingZeros(word);
+            break;
+        }
+        end += count;
+    }
+    end = end < dimension ? end : dimension;
+    *length = end - start;
+    return start;
+}
+
+QRMatrixBoardRuns::QRMatrixBoardRuns(QRMatrixBoard& board) {
+    dimension_ = board.dimension();
+    bits_ = board.packed();
+    stride_ = board.packedStride();
+    cells_ = nullptr;
+    value_ = BoardCell::set;
+    row_ = 0;
+    column_ = 0;
+    runEnd_ = 0;
+}
+
+QRMatrixBoardRuns::QRMatrixBoardRuns(QRMatrixBoard& board, UnsignedByte type) {
+    dimension_ = board.dimension();
+    cells_ = board.buffer();
+    bits_ = board.packed();
+    stride_ = board.packedStride();
+    value_ = (type & BoardCell::highMask) | BoardCell::set;
+    row_ = 0;
+    column_ = 0;
+    runEnd_ = 0;
+}
+
+bool QRMatrixBoardRuns::next(BoardRun& run) {
+    while (row_ < dimension_) {
+        if (column_ < runEnd_) {
+            // Cells of given type in current run of black cells
+            const UnsignedByte* cells = cells_[row_];
+            while (column_ < runEnd_ && cells[column_] != value_) {
+                column_ += 1;
+            }
+            if (column_ < runEnd_) {
+                unsigned int start = column_;
+                while (column_ < runEnd_ && cells[column_] == value_) {
+                    column_ += 1;
+                }
+                run.row = row_;
+                run.column = start;
+                run.length = column_ - start;
+                return true;
+            }
+        }
+        unsigned int length = 0;
+        unsigned int start = QRMatrixBoardRuns::find(bits_ + row_ * stride_, dimension_, column_, &length);
+        if (start >= dimension_) {
+            row_ += 1;
+            column_ = 0;
+            runEnd_ = 0;
+            continue;
+        }
+        if (cells_ != nullptr) {
+            column_ = start;
+            runEnd_ = start + length;
+            continue;
+        }
+        column_ = start + length;
+        run.row = row_;
+        run.column = start;
+        run.length = length;
+        return true;
+    }
+    return false;
+}
+
+void QRMatrixBoardRuns::reset() {
+    row_ = 0;
+    column_ = 0;
+    runEnd_ = 0;
+}
@@ -0,0 +1,86 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXBOARDRUNS_H
+#define QRMATRIXBOARDRUNS_H
+
+#include "constants.h"
+#include "qrmatrixboard.h"
+
+namespace QRMatrix {
+
+    /// Horizontal run of black cells
+    struct BoardRun {
+        /// Row of cells
+        UnsignedByte row;
+        /// First cell
+        UnsignedByte column;
+        /// Number of cells
+        UnsignedByte length;
+    };
+
+    /// Runs of black cells of `QRMatrixBoard`, row by row, left to right.
+    /// Runs are found in the color plane (`QRMatrixBoard::packed()`) 64 cells at a time, not cell by cell.
+    /// Runs of all black cells allocate nothing. Runs filtered by type read cells types from `QRMatrixBoard::buffer()`,
+    /// so the first use may build the cells of board.
+    /// Board must be kept alive & unchanged while runs are read.
+    /// ```
+    /// QRMatrixBoardRuns runs(board);
+    /// BoardRun run;
+    /// while (runs.next(run)) {
+    ///     // Draw rectangle (run.column, run.row, run.length, 1)
+    /// }
+    /// ```
+    class QRMatrixBoardRuns {
+    public:
+        /// Runs of all black cells
+        QRMatrixBoardRuns(QRMatrixBoard& board);
+        /// Runs of black cells of given type (`BoardCell` higher 4 bits, 0 for data cells, see `QRMatrixBoard::buffer()`)
+        QRMatrixBoardRuns(QRMatrixBoard& board, UnsignedByte type);
+
+        /// Write next run into `run`.
+        /// @return false if there is no more run.
+        bool next(BoardRun& run);
+        /// Restart from the first row.
+        void reset();
+
+        /// Internal purpose.
+        /// Find the first run of black cells from `column` in packed row `bits` (`BoardFormat::packedBits` format,
+        /// only `(dimension + 7) / 8` bytes are read).
+        /// @return First cell of run (`dimension` if there is no run), its number of cells is written into `length`.
+        static unsigned int find(const UnsignedByte* bits, UnsignedByte dimension, unsigned int column, unsigned int* length);
+    private:
+        UnsignedByte dimension_;
+        const UnsignedByte* bits_;
+        unsigned int stride_;
+        /// Cells to filter by type (`nullptr` for all black cells)
+        UnsignedByte** cells_;
+        UnsignedByte value_;
+        unsigned int row_;
+        unsigned int column_;
+        /// End of current run of black cells, which is splitted by type
+        unsigned int runEnd_;
+    };
+
+}
+
+#endif // QRMATRIXBOARDRUNS_H
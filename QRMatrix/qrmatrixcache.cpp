@@ -0,0 +1,295 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixcache.h"
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+using namespace QRMatrix;
+
+namespace QRMatrix {
+
+struct QRMatrixCache_Entry {
+    /// Serialized encoding inputs
+    std::string key;
+    /// Hash of `key`
+    Unsigned8Bytes hash = 0;
+    QRMatrixCompactSymbol symbol;
+    /// Counted size in bytes
+    Unsigned8Bytes size = 0;
+};
+
+struct QRMatrixCache_Shard {
+    /// Guard all below properties
+    std::mutex mutex;
+    /// Most recently used first
+    std::list<QRMatrixCache_Entry> entries;
+    /// Entries by hash of their key
+    std::unordered_multimap<Unsigned8Bytes, std::list<QRMatrixCache_Entry>::iterator> index;
+    Unsigned8Bytes capacity = 0;
+    Unsigned8Bytes size = 0;
+    Unsigned8Bytes hitCount = 0;
+    Unsigned8Bytes missCount = 0;
+    Unsigned8Bytes evictionCount = 0;
+};
+
+}
+
+/// Write `length` bytes of `value` into `bytes` (little endian)
+void QRMatrixCache_append(UnsignedByte* bytes, Unsigned8Bytes value, unsigned int length) {
+    for (unsigned int index = 0; index < length; index += 1) {
+        bytes[index] = (UnsignedByte)((value >> (index * 8)) & 0xFF);
+    }
+}
+
+/// All encoding inputs, read in key order without copying them
+struct QRMatrixCache_Input {
+    QRMatrixSegment* segments;
+    unsigned int count;
+    ErrorCorrectionLevel level;
+    const QRMatrixExtraMode& extraMode;
+    UnsignedByte minVersion;
+    UnsignedByte maskId;
+
+    /// Call `visitor(bytes, length)` for each piece of the key
+    template <typename Visitor>
+    void visit(Visitor& visitor) const {
+        UnsignedByte header[9];
+        QRMatrixCache_append(&header[0], level, 1);
+        QRMatrixCache_append(&header[1], extraMode.mode, 1);
+        QRMatrixCache_append(&header[2], minVersion, 1);
+        QRMatrixCache_append(&header[3], maskId, 1);
+        QRMatrixCache_append(&header[4], extraMode.appIndicatorLength, 1);
+        QRMatrixCache_append(&header[5], count, 4);
+        visitor(header, 5);
+        if (extraMode.appIndicatorLength > 0) {
+            visitor(extraMode.appIndicator, extraMode.appIndicatorLength);
+        }
+        visitor(&header[5], 4);
+        for (unsigned int index = 0; index < count; index += 1) {
+            QRMatrixSegment& segment = segments[index];
+            QRMatrixCache_append(&header[0], segment.mode(), 1);
+            QRMatrixCache_append(&header[1], segment.eci(), 4);
+            QRMatrixCache_append(&header[5], segment.length(), 4);
+            visitor(header, 9);
+            visitor(segment.data(), segment.length());
+        }
+    }
+};
+
+/// Hash key bytes (FNV-1a)
+struct QRMatrixCache_Hasher {
+    Unsigned8Bytes hash = 0xCBF29CE484222325ULL;
+
+    void operator()(const UnsignedByte* bytes, unsigned int length) {
+        for (unsigned int index = 0; index < length; index += 1) {
+            hash ^= bytes[index];
+            hash *= 0x100000001B3ULL;
+        }
+    }
+};
+
+/// Serialize key bytes (only for new entries)
+struct QRMatrixCache_Writer {
+    std::string& bytes;
+
+    void operator()(const UnsignedByte* data, unsigned int length) {
+        bytes.append((const char*)data, length);
+    }
+};
+
+/// Compare key bytes with a serialized key
+struct QRMatrixCache_Matcher {
+    const std::string& bytes;
+    unsigned int offset = 0;
+    bool isMatched = true;
+
+    void operator()(const UnsignedByte* data, unsigned int length) {
+        if (isMatched && (offset + length > bytes.length() || memcmp(bytes.data() + offset, data, length) != 0)) {
+            isMatched = false;
+        }
+        offset += length;
+    }
+};
+
+/// Entry of given input in `shard` (`shard.entries.end()` if not found). Nothing is allocated.
+std::list<QRMatrixCache_Entry>::iterator QRMatrixCache_find(
+    QRMatrixCache_Shard& shard,
+    const QRMatrixCache_Input& input,
+    Unsigned8Bytes hash
+) {
+    auto range = shard.index.equal_range(hash);
+    for (auto found = range.first; found != range.second; ++found) {
+        QRMatrixCache_Matcher matcher { found->second->key };
+        input.visit(matcher);
+        if (matcher.isMatched && matcher.offset == found->second->key.length()) {
+            return found->second;
+        }
+    }
+    return shard.entries.end();
+}
+
+/// Approximate memory of an entry: codewords, key and containers nodes
+Unsigned8Bytes QRMatrixCache_entrySize(QRMatrixCache_Entry& entry) {
+    return entry.symbol.size() + entry.key.capacity() + sizeof(QRMatrixCache_Entry) + sizeof(void*) * 8;
+}
+
+QRMatrixCache::~QRMatrixCache() {
+    delete[] shards_;
+}
+
+QRMatrixCache::QRMatrixCache(Unsigned8Bytes capacity, unsigned int shardCount) {
+    capacity_ = capacity;
+    shardCount_ = shardCount > 0 ? shardCount : 1;
+    shards_ = new QRMatrixCache_Shard[shardCount_];
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        shards_[index].capacity = capacity_ / shardCount_;
+    }
+}
+
+Unsigned8Bytes QRMatrixCache::hitCount() {
+    Unsigned8Bytes result = 0;
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        std::lock_guard<std::mutex> lock(shards_[index].mutex);
+        result += shards_[index].hitCount;
+    }
+    return result;
+}
+
+Unsigned8Bytes QRMatrixCache::missCount() {
+    Unsigned8Bytes result = 0;
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        std::lock_guard<std::mutex> lock(shards_[index].mutex);
+        result += shards_[index].missCount;
+    }
+    return result;
+}
+
+Unsigned8Bytes QRMatrixCache::evictionCount() {
+    Unsigned8Bytes result = 0;
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        std::lock_guard<std::mutex> lock(shards_[index].mutex);
+        result += shards_[index].evictionCount;
+    }
+    return result;
+}
+
+unsigned int QRMatrixCache::count() {
+    unsigned int result = 0;
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        std::lock_guard<std::mutex> lock(shards_[index].mutex);
+        result += (unsigned int)shards_[index].entries.size();
+    }
+    return result;
+}
+
+Unsigned8Bytes QRMatrixCache::size() {
+    Unsigned8Bytes result = 0;
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        std::lock_guard<std::mutex> lock(shards_[index].mutex);
+        result += shards_[index].size;
+    }
+    return result;
+}
+
+void QRMatrixCache::clear() {
+    for (unsigned int index = 0; index < shardCount_; index += 1) {
+        QRMatrixCache_Shard& shard = shards_[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.size = 0;
+    }
+}
+
+QRMatrixStatus QRMatrixCache::fetch(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId,
+    QRMatrixBoard& board,
+    const std::function<QRMatrixStatus(QRMatrixCompactSymbol& symbol)>& encode
+) {
+    QRMatrixCache_Input input { segments, count, level, extraMode, minVersion, maskId };
+    QRMatrixCache_Hasher hasher;
+    input.visit(hasher);
+    Unsigned8Bytes hash = hasher.hash;
+    QRMatrixCache_Shard& shard = shards_[(hash >> 32) % shardCount_];
+    QRMatrixCompactSymbol symbol;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = QRMatrixCache_find(shard, input, hash);
+        if (found != shard.entries.end()) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, found);
+            shard.hitCount += 1;
+            symbol = found->symbol;
+        } else {
+            shard.missCount += 1;
+        }
+    }
+    if (symbol.isValid()) {
+        // Synthesize board out of lock
+        board = symbol.board();
+        return QRMatrixStatus();
+    }
+    QRMatrixCache_Entry entry;
+    QRMatrixStatus status = encode(entry.symbol);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    board = entry.symbol.board();
+    QRMatrixCache_Writer writer { entry.key };
+    input.visit(writer);
+    entry.hash = hash;
+    entry.size = QRMatrixCache_entrySize(entry);
+    if (entry.size > shard.capacity) {
+        return status;
+    }
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (QRMatrixCache_find(shard, input, hash) != shard.entries.end()) {
+        // Encoded by other worker meanwhile
+        return status;
+    }
+    while (shard.size + entry.size > shard.capacity) {
+        auto last = std::prev(shard.entries.end());
+        auto range = shard.index.equal_range(last->hash);
+        for (auto found = range.first; found != range.second; ++found) {
+            if (found->second == last) {
+                shard.index.erase(found);
+                break;
+            }
+        }
+        shard.size -= last->size;
+        shard.entries.erase(last);
+        shard.evictionCount += 1;
+    }
+    shard.size += entry.size;
+    shard.entries.push_front(std::move(entry));
+    shard.index.emplace(hash, shard.entries.begin());
+    return status;
+}
@@ -0,0 +1,94 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXCACHE_H
+#define QRMATRIXCACHE_H
+
+#include "constants.h"
+#include "qrmatrixboard.h"
+#include "qrmatrixcompactsymbol.h"
+#include "qrmatrixsegment.h"
+#include "qrmatrixextramode.h"
+#include "qrmatrixstatus.h"
+#include <functional>
+
+namespace QRMatrix {
+
+    /// Internal data model
+    struct QRMatrixCache_Shard;
+
+    /// Results of `QRMatrixEncoder::encode(cache, context, ...)` kept for repeated inputs (eg. same URLs, product codes).
+    /// Entries are keyed by all encoding inputs (segments modes, ECI, data, level, extra mode, minimum version, mask).
+    /// Results are kept as `QRMatrixCompactSymbol` (about 1/8 of a board) and the board is synthesized for each hit.
+    /// Memory is bounded by bytes: the least recently used entries are evicted first.
+    /// The cache is split into shards (each has its own lock) by hash of the key,
+    /// so workers using the same cache rarely wait for each other.
+    class QRMatrixCache {
+    public:
+        ~QRMatrixCache();
+        /// Create cache holding about `capacity` bytes of results, split into `shardCount` shards
+        /// (each shard holds `capacity / shardCount` bytes).
+        QRMatrixCache(Unsigned8Bytes capacity, unsigned int shardCount = 16);
+
+        /// Maximum size in bytes of all entries
+        inline Unsigned8Bytes capacity() { return capacity_; }
+        /// Number of shards
+        inline unsigned int shardCount() { return shardCount_; }
+        /// Number of encodings found in cache
+        Unsigned8Bytes hitCount();
+        /// Number of encodings not found in cache
+        Unsigned8Bytes missCount();
+        /// Number of entries removed to keep size under capacity
+        Unsigned8Bytes evictionCount();
+        /// Number of entries
+        unsigned int count();
+        /// Size in bytes of all entries (compact symbols, keys & bookkeeping)
+        Unsigned8Bytes size();
+        /// Remove all entries (counters are kept)
+        void clear();
+
+        /// Internal purpose.
+        /// Write board of given input into `board` if it is cached (board is synthesized out of lock),
+        /// otherwise call `encode(symbol)` (out of lock) and keep the result if succeeded.
+        QRMatrixStatus fetch(
+            QRMatrixSegment* segments,
+            unsigned int count,
+            ErrorCorrectionLevel level,
+            const QRMatrixExtraMode& extraMode,
+            UnsignedByte minVersion,
+            UnsignedByte maskId,
+            QRMatrixBoard& board,
+            const std::function<QRMatrixStatus(QRMatrixCompactSymbol& symbol)>& encode
+        );
+    private:
+        Unsigned8Bytes capacity_;
+        unsigned int shardCount_;
+        QRMatrixCache_Shard* shards_;
+
+        // Not copyable
+        QRMatrixCache(QRMatrixCache &other);
+        void operator=(QRMatrixCache other);
+    };
+
+}
+
+#endif // QRMATRIXCACHE_H
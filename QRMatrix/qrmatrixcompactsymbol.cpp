@@ -0,0 +1,238 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixcompactsymbol.h"
+#include <atomic>
+#include <cstring>
+
+using namespace QRMatrix;
+
+/// Cell is not a codeword bit
+#define QRMATRIXCOMPACTSYMBOL_NONE 0xFFFF
+/// XOR to change color of cell
+#define QRMATRIXCOMPACTSYMBOL_FLIP (BoardCell::set ^ BoardCell::unset)
+
+namespace QRMatrix {
+
+struct QRMatrixCompactSymbol_Template {
+    QRMatrixLayout layout;
+    /// Codewords bit index of each cell (`QRMATRIXCOMPACTSYMBOL_NONE` for other cells), if mask is fixed
+    Unsigned2Bytes* indexes;
+
+    QRMatrixCompactSymbol_Template(const ErrorCorrectionInfo& ecInfo, bool isMicro, UnsignedByte maskId):
+        layout(ecInfo, isMicro, maskId) {
+        indexes = nullptr;
+        if (!layout.isMaskFixed()) {
+            return;
+        }
+        unsigned int cellsCount = layout.dimension() * layout.dimension();
+        indexes = new Unsigned2Bytes [cellsCount];
+        for (unsigned int index = 0; index < cellsCount; index += 1) {
+            indexes[index] = QRMATRIXCOMPACTSYMBOL_NONE;
+        }
+        for (unsigned int index = 0; index < layout.modulesCount(); index += 1) {
+            indexes[layout.position(index)] = (Unsigned2Bytes)index;
+        }
+    }
+
+    ~QRMatrixCompactSymbol_Template() {
+        if (indexes != nullptr) {
+            delete[] indexes;
+        }
+    }
+};
+
+}
+
+/// Number of mask slots of each version & level: masks 0...7, then 1 slot for not fixed mask (mask evaluated for each symbol)
+#define QRMATRIXCOMPACTSYMBOL_MASK_SLOTS 9
+
+/// Templates of each version (QR 1...40 then MicroQR 1...4), level & mask, made at the first use & never released.
+/// Slots are published without lock: the thread losing the race releases its own template.
+static std::atomic<const QRMatrixCompactSymbol_Template*> QRMatrixCompactSymbol_templates[
+    (QR_MAX_VERSION + MICROQR_MAX_VERSION) * 4 * QRMATRIXCOMPACTSYMBOL_MASK_SLOTS
+];
+
+const QRMatrixCompactSymbol_Template* QRMatrixCompactSymbol_template(const ErrorCorrectionInfo& ecInfo, bool isMicro, UnsignedByte maskId) {
+    bool isMaskFixed = maskId < (isMicro ? 4 : 8);
+    unsigned int versionIndex = isMicro ? QR_MAX_VERSION + ecInfo.version - 1 : ecInfo.version - 1;
+    unsigned int maskIndex = isMaskFixed ? maskId : QRMATRIXCOMPACTSYMBOL_MASK_SLOTS - 1;
+    std::atomic<const QRMatrixCompactSymbol_Template*>& slot = QRMatrixCompactSymbol_templates[
+        (versionIndex * 4 + ecInfo.level) * QRMATRIXCOMPACTSYMBOL_MASK_SLOTS + maskIndex
+    ];
+    const QRMatrixCompactSymbol_Template* result = slot.load(std::memory_order_acquire);
+    if (result != nullptr) {
+        return result;
+    }
+    const QRMatrixCompactSymbol_Template* made = new QRMatrixCompactSymbol_Template(ecInfo, isMicro, isMaskFixed ? maskId : 0xFF);
+    if (slot.compare_exchange_strong(result, made, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return made;
+    }
+    // Made by another thread meanwhile
+    delete made;
+    return result;
+}
+
+const QRMatrixLayout& QRMatrixCompactSymbol::sharedLayout(const ErrorCorrectionInfo& ecInfo, bool isMicro, UnsignedByte maskId) {
+    return QRMatrixCompactSymbol_template(ecInfo, isMicro, maskId)->layout;
+}
+
+QRMatrixCompactSymbol::~QRMatrixCompactSymbol() {
+    if (bits_ != nullptr) {
+        delete[] bits_;
+    }
+}
+
+QRMatrixCompactSymbol::QRMatrixCompactSymbol() {
+    layout_ = nullptr;
+    bits_ = nullptr;
+}
+
+QRMatrixCompactSymbol::QRMatrixCompactSymbol(const QRMatrixCompactSymbol &other) {
+    layout_ = other.layout_;
+    bits_ = nullptr;
+    if (other.bits_ != nullptr) {
+        bits_ = new UnsignedByte [other.size()];
+        memcpy(bits_, other.bits_, other.size());
+    }
+}
+
+QRMatrixCompactSymbol::QRMatrixCompactSymbol(QRMatrixCompactSymbol &&other) {
+    layout_ = other.layout_;
+    bits_ = other.bits_;
+    other.layout_ = nullptr;
+    other.bits_ = nullptr;
+}
+
+void QRMatrixCompactSymbol::operator=(QRMatrixCompactSymbol other) {
+    if (bits_ != nullptr) {
+        delete[] bits_;
+    }
+    layout_ = other.layout_;
+    bits_ = other.bits_;
+    other.layout_ = nullptr;
+    other.bits_ = nullptr;
+}
+
+QRMatrixCompactSymbol::QRMatrixCompactSymbol(
+    const ErrorCorrectionInfo& ecInfo,
+    bool isMicro,
+    UnsignedByte maskId,
+    const UnsignedByte* data,
+    const UnsignedByte* errorCorrection
+) {
+    layout_ = QRMatrixCompactSymbol_template(ecInfo, isMicro, maskId);
+    const QRMatrixLayout& layout = layout_->layout;
+    unsigned int dataModulesCount = layout.dataModulesCount();
+    unsigned int ecModulesCount = layout.modulesCount() - dataModulesCount;
+    bits_ = new UnsignedByte [size()];
+    if (dataModulesCount % 8 == 0) {
+        memcpy(bits_, data, dataModulesCount / 8);
+        memcpy(&bits_[dataModulesCount / 8], errorCorrection, ecModulesCount / 8);
+        return;
+    }
+    // MicroQR M1, M3: error correction bits start in the middle of a byte
+    memset(bits_, 0, size());
+    for (unsigned int index = 0; index < layout.modulesCount(); index += 1) {
+        const UnsignedByte* source = data;
+        unsigned int bit = index;
+        if (index >= dataModulesCount) {
+            source = errorCorrection;
+            bit = index - dataModulesCount;
+        }
+        if ((source[bit / 8] >> (7 - bit % 8)) & 1) {
+            bits_[index / 8] |= (UnsignedByte)(0x80 >> (index % 8));
+        }
+    }
+}
+
+ErrorCorrectionLevel QRMatrixCompactSymbol::level() const {
+    return layout_ != nullptr ? layout_->layout.level() : ErrorCorrectionLevel::low;
+}
+
+UnsignedByte QRMatrixCompactSymbol::version() const {
+    return layout_ != nullptr ? layout_->layout.version() : 0;
+}
+
+bool QRMatrixCompactSymbol::isMicro() const {
+    return layout_ != nullptr && layout_->layout.isMicro();
+}
+
+UnsignedByte QRMatrixCompactSymbol::maskId() const {
+    return layout_ != nullptr ? layout_->layout.maskId() : 0xFF;
+}
+
+UnsignedByte QRMatrixCompactSymbol::dimension() const {
+    return layout_ != nullptr ? layout_->layout.dimension() : 0;
+}
+
+unsigned int QRMatrixCompactSymbol::size() const {
+    return layout_ != nullptr ? (layout_->layout.modulesCount() + 7) / 8 : 0;
+}
+
+UnsignedByte QRMatrixCompactSymbol::cell(UnsignedByte row, UnsignedByte column) const {
+    unsigned int position = row * layout_->layout.dimension() + column;
+    UnsignedByte result = layout_->layout.maskedCells()[position];
+    Unsigned2Bytes index = layout_->indexes[position];
+    if (index != QRMATRIXCOMPACTSYMBOL_NONE && ((bits_[index / 8] >> (7 - index % 8)) & 1)) {
+        result ^= QRMATRIXCOMPACTSYMBOL_FLIP;
+    }
+    return result;
+}
+
+bool QRMatrixCompactSymbol::isDark(UnsignedByte row, UnsignedByte column) const {
+    return (cell(row, column) & BoardCell::lowMask) == BoardCell::set;
+}
+
+void QRMatrixCompactSymbol::row(UnsignedByte row, UnsignedByte* output) const {
+    UnsignedByte dimension = layout_->layout.dimension();
+    unsigned int offset = row * dimension;
+    memcpy(output, &layout_->layout.maskedCells()[offset], dimension);
+    const Unsigned2Bytes* indexes = &layout_->indexes[offset];
+    for (unsigned int column = 0; column < dimension; column += 1) {
+        Unsigned2Bytes index = indexes[column];
+        if (index != QRMATRIXCOMPACTSYMBOL_NONE && ((bits_[index / 8] >> (7 - index % 8)) & 1)) {
+            output[column] ^= QRMATRIXCOMPACTSYMBOL_FLIP;
+        }
+    }
+}
+
+QRMatrixBoard QRMatrixCompactSymbol::board() const {
+    if (layout_ == nullptr) {
+        return QRMatrixBoard();
+    }
+    UnsignedByte dimension = layout_->layout.dimension();
+    unsigned int stride = (dimension + 7) / 8;
+    UnsignedByte cells[dimension];
+    UnsignedByte colors[stride * dimension];
+    memset(colors, 0, stride * dimension);
+    for (unsigned int row = 0; row < dimension; row += 1) {
+        QRMatrixCompactSymbol::row(row, cells);
+        UnsignedByte* bits = colors + row * stride;
+        for (unsigned int column = 0; column < dimension; column += 1) {
+            if ((cells[column] & BoardCell::lowMask) == BoardCell::set) {
+                bits[column / 8] |= 0x80 >> (column % 8);
+            }
+        }
+    }
+    return QRMatrixBoard(layout_->layout, colors, stride);
+}
@@ -0,0 +1,93 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXCOMPACTSYMBOL_H
+#define QRMATRIXCOMPACTSYMBOL_H
+
+#include "constants.h"
+#include "common.h"
+#include "qrmatrixboard.h"
+#include "qrmatrixlayout.h"
+
+namespace QRMatrix {
+
+    /// Internal data model
+    struct QRMatrixCompactSymbol_Template;
+
+    /// QR symbol kept as its version, level, mask & codewords only (at most 3,706 bytes at version 40,
+    /// about 1/8 of a `QRMatrixBoard`). Cells are synthesized on demand from the function patterns template
+    /// & the codewords placement of its layout, which are shared by all symbols of the same version, level & mask.
+    /// To create compact symbol, refer `QRMatrixEncoder::encodeCompact`.
+    class QRMatrixCompactSymbol {
+    public:
+        ~QRMatrixCompactSymbol();
+        QRMatrixCompactSymbol(const QRMatrixCompactSymbol &other);
+        QRMatrixCompactSymbol(QRMatrixCompactSymbol &&other);
+        void operator=(QRMatrixCompactSymbol other);
+        /// Empty symbol (not valid). Result of `QRMatrixEncoder::encodeCompact` will be assigned later.
+        QRMatrixCompactSymbol();
+        /// Internal purpose. Symbol of given interleaved codewords & applied mask.
+        QRMatrixCompactSymbol(
+            const ErrorCorrectionInfo& ecInfo,
+            bool isMicro,
+            UnsignedByte maskId,
+            const UnsignedByte* data,
+            const UnsignedByte* errorCorrection
+        );
+
+        /// Symbol is encoded successfully
+        inline bool isValid() const { return layout_ != nullptr; }
+        /// Error correction level
+        ErrorCorrectionLevel level() const;
+        /// QR Version (MicroQR version if `isMicro()`)
+        UnsignedByte version() const;
+        /// Is MicroQR symbol
+        bool isMicro() const;
+        /// Applied mask
+        UnsignedByte maskId() const;
+        /// Size (dimension - number of cells on each side)
+        UnsignedByte dimension() const;
+        /// Codewords bits in placement order: interleaved data then interleaved error correction codewords,
+        /// most significant bit first (the 4 bits data codeword of MicroQR M1 & M3 takes 4 bits only).
+        inline const UnsignedByte* codewords() const { return bits_; }
+        /// Size in bytes of `codewords()`
+        unsigned int size() const;
+
+        /// Value of cell at given position (same as `QRMatrixBoard::buffer()[row][column]`, see `BoardCell`)
+        UnsignedByte cell(UnsignedByte row, UnsignedByte column) const;
+        /// Cell at given position is black
+        bool isDark(UnsignedByte row, UnsignedByte column) const;
+        /// Write `dimension()` cells of given row into `output` (same values as `QRMatrixBoard::buffer()[row]`)
+        void row(UnsignedByte row, UnsignedByte* output) const;
+        /// Create full board of this symbol
+        QRMatrixBoard board() const;
+
+        /// Internal purpose. Layout of given version, level & mask shared by all symbols (created at the first use).
+        static const QRMatrixLayout& sharedLayout(const ErrorCorrectionInfo& ecInfo, bool isMicro, UnsignedByte maskId);
+    private:
+        const QRMatrixCompactSymbol_Template* layout_;
+        UnsignedByte* bits_;
+    };
+
+}
+
+#endif // QRMATRIXCOMPACTSYMBOL_H
@@ -0,0 +1,694 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixdecoder.h"
+#include "qrmatrixcompactsymbol.h"
+#include "qrmatrixlayout.h"
+#include "common.h"
+#include "Polynomial/polynomial.h"
+#include "Encoder/numericencoder.h"
+#include "Exception/qrmatrixexception.h"
+
+using namespace QRMatrix;
+
+/// Maximum number of wrong bits of readable format (or version) information
+#define QRMATRIXDECODER_MAX_INFO_ERRORS 3
+
+namespace QRMatrix {
+
+    /// Reader of codewords bits (most significant bit first)
+    struct QRMatrixDecoder_Bits {
+        const UnsignedByte* bytes;
+        /// Number of bits to read
+        unsigned int length;
+        /// Index of next bit
+        unsigned int index;
+        /// Attempted to read after the last bit
+        bool isOverflow;
+
+        QRMatrixDecoder_Bits(const UnsignedByte* data, unsigned int bitsCount) {
+            bytes = data;
+            length = bitsCount;
+            index = 0;
+            isOverflow = false;
+        }
+
+        inline unsigned int remaining() const { return length - index; }
+
+        /// Read next `count` bits (32 maximum), 0 if there are not enough bits.
+        Unsigned4Bytes read(unsigned int count) {
+            if (count > remaining()) {
+                index = length;
+                isOverflow = true;
+                return 0;
+            }
+            Unsigned4Bytes result = 0;
+            for (unsigned int bit = 0; bit < count; bit += 1) {
+                result = (result << 1) | ((bytes[index / 8] >> (7 - index % 8)) & 1);
+                index += 1;
+            }
+            return result;
+        }
+
+        /// Next `count` bits (or all remaining bits) are 0.
+        bool isZero(unsigned int count) const {
+            unsigned int end = index + (count < remaining() ? count : remaining());
+            for (unsigned int bit = index; bit < end; bit += 1) {
+                if (((bytes[bit / 8] >> (7 - bit % 8)) & 1) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /// Segment found in data codewords, its content is `length` bytes at `offset` of decoded bytes.
+    struct QRMatrixDecoder_Segment {
+        EncodingMode mode;
+        unsigned int eci;
+        unsigned int offset;
+        unsigned int length;
+    };
+
+}
+
+/// Color of cell (`true` for dark) from color plane
+inline bool QRMatrixDecoder_isDark(const UnsignedByte* bits, unsigned int stride, unsigned int row, unsigned int column) {
+    return ((bits[row * stride + column / 8] >> (7 - column % 8)) & 1) != 0;
+}
+
+/// Number of bits 1 of `value`
+unsigned int QRMatrixDecoder_bitsCount(Unsigned4Bytes value) {
+    unsigned int result = 0;
+    while (value != 0) {
+        value &= value - 1;
+        result += 1;
+    }
+    return result;
+}
+
+// FORMAT & VERSION ---------------------------------------------------------------------------------------------------------------------------------
+
+/// Read format information (2 copies for QR, 1 for MicroQR; first placed bit is bit 14 of results)
+void QRMatrixDecoder_readFormat(
+    const UnsignedByte* bits,
+    unsigned int stride,
+    UnsignedByte dimension,
+    bool isMicro,
+    Unsigned2Bytes* first,
+    Unsigned2Bytes* second
+) {
+    *first = 0;
+    *second = 0;
+    for (unsigned int index = 0; index < 15; index += 1) {
+        unsigned int row1 = 0, column1 = 0, row2 = 0, column2 = 0;
+        if (isMicro) {
+            if (index < 8) {
+                row1 = 8;
+                column1 = index + 1;
+            } else {
+                row1 = 15 - index;
+                column1 = 8;
+            }
+        } else if (index < 6) {
+            row1 = 8;
+            column1 = index;
+            row2 = dimension - 1 - index;
+            column2 = 8;
+        } else if (index == 6) {
+            row1 = 8;
+            column1 = 7;
+            row2 = dimension - 7;
+            column2 = 8;
+        } else if (index == 7) {
+            row1 = 8;
+            column1 = 8;
+            row2 = 8;
+            column2 = dimension - 8;
+        } else if (index == 8) {
+            row1 = 7;
+            column1 = 8;
+            row2 = 8;
+            column2 = dimension - 7;
+        } else {
+            row1 = 14 - index;
+            column1 = 8;
+            row2 = 8;
+            column2 = dimension - 15 + index;
+        }
+        *first = (*first << 1) | (QRMatrixDecoder_isDark(bits, stride, row1, column1) ? 1 : 0);
+        if (!isMicro) {
+            *second = (*second << 1) | (QRMatrixDecoder_isDark(bits, stride, row2, column2) ? 1 : 0);
+        }
+    }
+}
+
+/// Find error correction level & mask of the format information nearest to read copies.
+/// @return `false` if there is no format information having less than `QRMATRIXDECODER_MAX_INFO_ERRORS` wrong bits.
+bool QRMatrixDecoder_matchFormat(
+    Unsigned2Bytes first,
+    Unsigned2Bytes second,
+    UnsignedByte version,
+    bool isMicro,
+    ErrorCorrectionLevel* level,
+    UnsignedByte* maskId
+) {
+    static const ErrorCorrectionLevel levels[4] = { low, medium, quarter, high };
+    unsigned int minDistance = 16;
+    for (unsigned int levelIndex = 0; levelIndex < 4; levelIndex += 1) {
+        ErrorCorrectionLevel curLevel = levels[levelIndex];
+        if (isMicro) {
+            // M1 has 1 symbol (error detection only)
+            bool isValid = version == 1 ?
+                curLevel == low :
+                ErrorCorrectionInfo::microErrorCorrectionInfo(version, curLevel).codewords > 0;
+            if (!isValid) {
+                continue;
+            }
+        }
+        UnsignedByte masksCount = isMicro ? 4 : 8;
+        for (UnsignedByte mask = 0; mask < masksCount; mask += 1) {
+            Unsigned2Bytes expected = QRMatrixBoard::formatBits(curLevel, version, mask, isMicro);
+            unsigned int distance = QRMatrixDecoder_bitsCount(first ^ expected);
+            if (!isMicro) {
+                unsigned int distance2 = QRMatrixDecoder_bitsCount(second ^ expected);
+                if (distance2 < distance) {
+                    distance = distance2;
+                }
+            }
+            if (distance < minDistance) {
+                minDistance = distance;
+                *level = curLevel;
+                *maskId = mask;
+            }
+        }
+    }
+    return minDistance <= QRMATRIXDECODER_MAX_INFO_ERRORS;
+}
+
+/// Read version information of QR version 7...40 & check if it matches `version` (given by dimension)
+bool QRMatrixDecoder_matchVersion(const UnsignedByte* bits, unsigned int stride, UnsignedByte dimension, UnsignedByte version) {
+    Unsigned4Bytes first = 0;
+    Unsigned4Bytes second = 0;
+    unsigned int row1 = dimension - 9;
+    unsigned int column1 = 5;
+    unsigned int row2 = 5;
+    unsigned int column2 = dimension - 9;
+    for (unsigned int index = 0; index < 18; index += 1) {
+        first = (first << 1) | (QRMatrixDecoder_isDark(bits, stride, row1, column1) ? 1 : 0);
+        second = (second << 1) | (QRMatrixDecoder_isDark(bits, stride, row2, column2) ? 1 : 0);
+        if (row1 == (unsigned int)dimension - 11) {
+            row1 = dimension - 9;
+            column1 -= 1;
+        } else {
+            row1 -= 1;
+        }
+        if (column2 == (unsigned int)dimension - 11) {
+            column2 = dimension - 9;
+            row2 -= 1;
+        } else {
+            column2 -= 1;
+        }
+    }
+    unsigned int minDistance = 19;
+    UnsignedByte result = 0;
+    for (UnsignedByte curVersion = 7; curVersion <= QR_MAX_VERSION; curVersion += 1) {
+        Unsigned4Bytes expected = QRMatrixBoard::versionBits(curVersion);
+        unsigned int distance = QRMatrixDecoder_bitsCount(first ^ expected);
+        unsigned int distance2 = QRMatrixDecoder_bitsCount(second ^ expected);
+        if (distance2 < distance) {
+            distance = distance2;
+        }
+        if (distance < minDistance) {
+            minDistance = distance;
+            result = curVersion;
+        }
+    }
+    return minDistance <= QRMATRIXDECODER_MAX_INFO_ERRORS && result == version;
+}
+
+// CODEWORDS ----------------------------------------------------------------------------------------------------------------------------------------
+
+/// Read unmasked codewords bits of symbol in placement order into interleaved `data` & `errorCorrection`.
+/// Mask of `layout` must be fixed: its masked cells are the mask bits of codewords cells.
+/// `cells`: scratch memory of `dimension * dimension` bytes.
+void QRMatrixDecoder_readCodewords(
+    const UnsignedByte* bits,
+    unsigned int stride,
+    const QRMatrixLayout& layout,
+    UnsignedByte dimension,
+    UnsignedByte* cells,
+    UnsignedByte* data,
+    UnsignedByte* errorCorrection
+) {
+    // Unmasked bits of all cells (by position), so codewords bits are read without dividing positions
+    const UnsignedByte* maskedCells = layout.maskedCells();
+    for (unsigned int row = 0; row < dimension; row += 1) {
+        const UnsignedByte* rowBits = &bits[row * stride];
+        const UnsignedByte* rowMask = &maskedCells[row * dimension];
+        UnsignedByte* rowCells = &cells[row * dimension];
+        for (unsigned int column = 0; column < dimension; column += 1) {
+            UnsignedByte color = (rowBits[column / 8] >> (7 - column % 8)) & 1;
+            UnsignedByte mask = (rowMask[column] & 0x0F) == BoardCell::set ? 1 : 0;
+            rowCells[column] = color ^ mask;
+        }
+    }
+    unsigned int dataModules = layout.dataModulesCount();
+    unsigned int modules = layout.modulesCount();
+    UnsignedByte value = 0;
+    for (unsigned int index = 0; index < dataModules; index += 1) {
+        value = (value << 1) | cells[layout.position(index)];
+        if (index % 8 == 7) {
+            data[index / 8] = value;
+            value = 0;
+        }
+    }
+    // Last data codeword of MicroQR M1 & M3 has 4 bits (high bits)
+    if (dataModules % 8 != 0) {
+        data[dataModules / 8] = value << (8 - dataModules % 8);
+        value = 0;
+    }
+    for (unsigned int index = dataModules; index < modules; index += 1) {
+        unsigned int ecIndex = index - dataModules;
+        value = (value << 1) | cells[layout.position(index)];
+        if (ecIndex % 8 == 7) {
+            errorCorrection[ecIndex / 8] = value;
+            value = 0;
+        }
+    }
+}
+
+/// De-interleave codewords into blocks, fix errors of each block & write data codewords of blocks in order into `result`.
+/// @return Number of fixed codewords or -1 if a block has too many errors.
+int QRMatrixDecoder_correctBlocks(
+    const ErrorCorrectionInfo& ecInfo,
+    bool isMicro,
+    const UnsignedByte* data,
+    const UnsignedByte* errorCorrection,
+    UnsignedByte* result
+) {
+    unsigned int blocksCount = ecInfo.group1Blocks + ecInfo.group2Blocks;
+    unsigned int ecCount = ecInfo.ecCodewordsPerBlock;
+    unsigned int maxLength = ecInfo.group2Blocks > 0 ? ecInfo.group2BlockCodewords : ecInfo.group1BlockCodewords;
+    UnsignedByte block[256];
+    int corrected = 0;
+    unsigned int resultIndex = 0;
+    for (unsigned int blockIndex = 0; blockIndex < blocksCount; blockIndex += 1) {
+        bool isGroup1 = blockIndex < ecInfo.group1Blocks;
+        unsigned int length = isGroup1 ? ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords;
+        // Data codewords are interleaved round-robin (shorter blocks of group 1 first)
+        for (unsigned int index = 0; index < length; index += 1) {
+            unsigned int interleavedIndex = index * blocksCount + blockIndex;
+            if (index == maxLength - 1 && ecInfo.group2Blocks > 0) {
+                // The last column only has codewords of group 2 blocks
+                interleavedIndex = index * blocksCount + (blockIndex - ecInfo.group1Blocks);
+            }
+            block[index] = data[interleavedIndex];
+        }
+        for (unsigned int index = 0; index < ecCount; index += 1) {
+            block[length + index] = errorCorrection[index * blocksCount + blockIndex];
+        }
+        int fixed = Polynomial::correctErrors(block, length + ecCount, ecCount);
+        // M1 has error detection only
+        if (fixed < 0 || (fixed > 0 && isMicro && ecInfo.version == 1)) {
+            return -1;
+        }
+        corrected += fixed;
+        for (unsigned int index = 0; index < length; index += 1) {
+            result[resultIndex] = block[index];
+            resultIndex += 1;
+        }
+    }
+    return corrected;
+}
+
+// BITS STREAM --------------------------------------------------------------------------------------------------------------------------------------
+
+/// Decode data bits of segment of `mode` with `count` characters into `output`.
+/// @return Number of written bytes, or -1 if bits are invalid.
+int QRMatrixDecoder_readSegmentData(QRMatrixDecoder_Bits& bits, EncodingMode mode, unsigned int count, UnsignedByte* output) {
+    static const char* alphaNumericTable = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+    unsigned int length = 0;
+    switch (mode) {
+    case numeric:
+        while (length < count && !bits.isOverflow) {
+            unsigned int digits = count - length;
+            unsigned int bitsLen = NUM_TRIPLE_DIGITS_BITS_LEN;
+            unsigned int limit = 1000;
+            if (digits == 2) {
+                bitsLen = NUM_DOUBLE_DIGITS_BITS_LEN;
+                limit = 100;
+            } else if (digits == 1) {
+                bitsLen = NUM_SINGLE_DIGIT_BITS_LEN;
+                limit = 10;
+            } else {
+                digits = 3;
+            }
+            Unsigned4Bytes value = bits.read(bitsLen);
+            if (value >= limit) {
+                return -1;
+            }
+            for (unsigned int index = digits; index > 0; index -= 1) {
+                output[length + index - 1] = '0' + value % 10;
+                value /= 10;
+            }
+            length += digits;
+        }
+        break;
+    case alphaNumeric:
+        while (length < count && !bits.isOverflow) {
+            if (count - length >= 2) {
+                Unsigned4Bytes value = bits.read(11);
+                if (value >= 45 * 45) {
+                    return -1;
+                }
+                output[length] = alphaNumericTable[value / 45];
+                output[length + 1] = alphaNumericTable[value % 45];
+                length += 2;
+            } else {
+                Unsigned4Bytes value = bits.read(6);
+                if (value >= 45) {
+                    return -1;
+                }
+                output[length] = alphaNumericTable[value];
+                length += 1;
+            }
+        }
+        break;
+    case byte:
+        for (unsigned int index = 0; index < count && !bits.isOverflow; index += 1) {
+            output[length] = (UnsignedByte)bits.read(8);
+            length += 1;
+        }
+        break;
+    case kanji:
+        for (unsigned int index = 0; index < count && !bits.isOverflow; index += 1) {
+            Unsigned4Bytes value = bits.read(13);
+            Unsigned4Bytes character = ((value / 0xC0) << 8) | (value % 0xC0);
+            character += (character + 0x8140 <= 0x9FFC) ? 0x8140 : 0xC140;
+            output[length] = (UnsignedByte)(character >> 8);
+            output[length + 1] = (UnsignedByte)(character & 0xFF);
+            length += 2;
+        }
+        break;
+    }
+    return bits.isOverflow ? -1 : (int)length;
+}
+
+/// Read Mode Indicator (4 bits, `version - 1` bits for MicroQR)
+/// @return Mode value (0 for terminator of QR) or -1 if invalid.
+int QRMatrixDecoder_readMode(QRMatrixDecoder_Bits& bits, UnsignedByte version, bool isMicro) {
+    if (!isMicro) {
+        return (int)bits.read(4);
+    }
+    // MicroQR: `version - 1` bits of numeric, alphanumeric, byte, kanji
+    static const EncodingMode microModes[4] = { numeric, alphaNumeric, byte, kanji };
+    Unsigned4Bytes value = bits.read(version - 1);
+    if (value >= 4 || (version == 2 && value >= 2)) {
+        return -1;
+    }
+    return microModes[value];
+}
+
+/// Parse data codewords into `count` segments & decoded bytes into `output`, set Structured Append & FNC1 info of `result`.
+QRMatrixStatus QRMatrixDecoder_parse(
+    QRMatrixDecoder_Bits& bits,
+    UnsignedByte version,
+    bool isMicro,
+    QRMatrixDecoder_Segment* segments,
+    unsigned int* count,
+    UnsignedByte* output,
+    QRMatrixDecodedSymbol& result
+) {
+    unsigned int eci = defaultEciAssigmentValue;
+    unsigned int outputLength = 0;
+    *count = 0;
+    while (true) {
+        // Terminator (which may be truncated at the end of data codewords)
+        if (isMicro) {
+            unsigned int modeLength = version - 1;
+            if (bits.remaining() <= modeLength || bits.isZero(Common::microTerminatorLength(version))) {
+                break;
+            }
+        } else if (bits.remaining() < 4) {
+            break;
+        }
+        int mode = QRMatrixDecoder_readMode(bits, version, isMicro);
+        if (mode == 0 && !isMicro) {
+            break;
+        }
+        switch (mode) {
+        case numeric:
+        case alphaNumeric:
+        case byte:
+        case kanji: {
+            EncodingMode curMode = (EncodingMode)mode;
+            unsigned int countBits = isMicro ?
+                Common::microCharactersCountIndicatorLength(version, curMode) :
+                Common::charactersCountIndicatorLength(version, curMode);
+            unsigned int charCount = bits.read(countBits);
+            int length = QRMatrixDecoder_readSegmentData(bits, curMode, charCount, &output[outputLength]);
+            if (length < 0) {
+                return QRMatrixStatus(EncodingStatus::invalidBitStream, *count);
+            }
+            if (length > 0) {
+                QRMatrixDecoder_Segment& segment = segments[*count];
+                segment.mode = curMode;
+                segment.eci = eci;
+                segment.offset = outputLength;
+                segment.length = length;
+                outputLength += length;
+                *count += 1;
+            }
+        }
+            break;
+        case 0b0111: {
+            // ECI: 1, 2 or 3 bytes Indicator
+            Unsigned4Bytes value = bits.read(8);
+            if ((value & 0x80) == 0) {
+                eci = value;
+            } else if ((value & 0xC0) == 0x80) {
+                eci = ((value & 0x3F) << 8) | bits.read(8);
+            } else if ((value & 0xE0) == 0xC0) {
+                eci = ((value & 0x1F) << 16) | bits.read(16);
+            } else {
+                return QRMatrixStatus(EncodingStatus::invalidBitStream, *count);
+            }
+        }
+            break;
+        case 0b0101:
+            result.extraMode = QRMatrixExtraMode(EncodingExtraMode::fnc1First);
+            break;
+        case 0b1001: {
+            Unsigned4Bytes value = bits.read(8);
+            UnsignedByte appId[2];
+            UnsignedByte appIdLen = 0;
+            if (value >= 100) {
+                appId[0] = (UnsignedByte)(value - 100);
+                appIdLen = 1;
+            } else {
+                appId[0] = '0' + value / 10;
+                appId[1] = '0' + value % 10;
+                appIdLen = 2;
+            }
+            result.extraMode = QRMatrixExtraMode(appId, appIdLen);
+        }
+            break;
+        case 0b0011:
+            result.sequenceIndex = bits.read(4);
+            result.sequenceTotal = bits.read(4) + 1;
+            result.parity = bits.read(8);
+            break;
+        default:
+            return QRMatrixStatus(EncodingStatus::invalidBitStream, *count);
+        }
+        if (bits.isOverflow) {
+            return QRMatrixStatus(EncodingStatus::invalidBitStream, *count);
+        }
+    }
+    return QRMatrixStatus();
+}
+
+// PUBLIC -------------------------------------------------------------------------------------------------------------------------------------------
+
+QRMatrixDecodedSymbol::QRMatrixDecodedSymbol() {
+    version = 0;
+    isMicro = false;
+    level = ErrorCorrectionLevel::low;
+    maskId = 0;
+    count = 0;
+    segments = new QRMatrixSegment [count];
+    extraMode = QRMatrixExtraMode();
+    sequenceIndex = 0;
+    sequenceTotal = 0;
+    parity = 0;
+    correctedCodewords = 0;
+}
+
+QRMatrixDecodedSymbol::QRMatrixDecodedSymbol(QRMatrixDecodedSymbol &other) {
+    version = other.version;
+    isMicro = other.isMicro;
+    level = other.level;
+    maskId = other.maskId;
+    count = other.count;
+    segments = new QRMatrixSegment [count];
+    for (unsigned int index = 0; index < count; index += 1) {
+        segments[index] = other.segments[index];
+    }
+    extraMode = other.extraMode;
+    sequenceIndex = other.sequenceIndex;
+    sequenceTotal = other.sequenceTotal;
+    parity = other.parity;
+    correctedCodewords = other.correctedCodewords;
+}
+
+QRMatrixDecodedSymbol::~QRMatrixDecodedSymbol() {
+    delete[] segments;
+}
+
+void QRMatrixDecodedSymbol::operator=(QRMatrixDecodedSymbol other) {
+    // `other` is already a copy, take its segments & let it release ours
+    QRMatrixSegment* released = segments;
+    version = other.version;
+    isMicro = other.isMicro;
+    level = other.level;
+    maskId = other.maskId;
+    count = other.count;
+    segments = other.segments;
+    other.segments = released;
+    extraMode = other.extraMode;
+    sequenceIndex = other.sequenceIndex;
+    sequenceTotal = other.sequenceTotal;
+    parity = other.parity;
+    correctedCodewords = other.correctedCodewords;
+}
+
+QRMatrixDecodedSymbol QRMatrixDecoder::decode(QRMatrixBoard& board) {
+    QRMatrixDecodedSymbol result;
+    QRMatrixStatus status = tryDecode(board, result);
+    if (!status.isSucceeded()) {
+        throw QR_EXCEPTION(status.message());
+    }
+    return result;
+}
+
+QRMatrixStatus QRMatrixDecoder::tryDecode(QRMatrixBoard& board, QRMatrixDecodedSymbol& result) noexcept {
+    try {
+        // Version by dimension
+        UnsignedByte dimension = board.dimension();
+        bool isMicro = dimension < QR_MIN_DIMENSION;
+        UnsignedByte version = 0;
+        if (isMicro) {
+            if (dimension >= MICROQR_MIN_DIMENSION && (dimension - MICROQR_MIN_DIMENSION) % MICROQR_VERSION_OFFSET == 0) {
+                version = (dimension - MICROQR_MIN_DIMENSION) / MICROQR_VERSION_OFFSET + 1;
+            }
+        } else if ((dimension - QR_MIN_DIMENSION) % QR_VERSION_OFFSET == 0) {
+            version = (dimension - QR_MIN_DIMENSION) / QR_VERSION_OFFSET + 1;
+        }
+        if (version == 0 || version > (isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION)) {
+            return QRMatrixStatus(EncodingStatus::invalidVersion);
+        }
+        const UnsignedByte* bits = board.packed();
+        unsigned int stride = board.packedStride();
+        // Format & version information
+        Unsigned2Bytes format1 = 0;
+        Unsigned2Bytes format2 = 0;
+        QRMatrixDecoder_readFormat(bits, stride, dimension, isMicro, &format1, &format2);
+        ErrorCorrectionLevel level = ErrorCorrectionLevel::low;
+        UnsignedByte maskId = 0;
+        if (!QRMatrixDecoder_matchFormat(format1, format2, version, isMicro, &level, &maskId)) {
+            return QRMatrixStatus(EncodingStatus::invalidFormat);
+        }
+        if (!isMicro && version >= 7 && !QRMatrixDecoder_matchVersion(bits, stride, dimension, version)) {
+            return QRMatrixStatus(EncodingStatus::invalidFormat);
+        }
+        // Codewords
+        ErrorCorrectionInfo ecInfo = isMicro ?
+            ErrorCorrectionInfo::microErrorCorrectionInfo(version, level) :
+            ErrorCorrectionInfo::errorCorrectionInfo(version, level);
+        const QRMatrixLayout* layout = nullptr;
+        try {
+            layout = &QRMatrixCompactSymbol::sharedLayout(ecInfo, isMicro, maskId);
+        } catch (const QRMatrixException&) {
+            return QRMatrixStatus(EncodingStatus::invalidFormat);
+        }
+        unsigned int ecTotal = ecInfo.ecCodewordsTotalCount();
+        // Interleaved data, error correction, data of blocks, decoded bytes
+        // (3 bytes per codeword at most, and the last group of numeric digits read before detecting overflow) & unmasked cells
+        unsigned int bufferSize = ecInfo.codewords * 5 + ecTotal + 4;
+        UnsignedByte* buffer = new UnsignedByte [bufferSize + dimension * dimension];
+        QRMatrixDecoder_Segment* segments = nullptr;
+        QRMatrixStatus status;
+        // Catch failures here to release buffers
+        try {
+            UnsignedByte* interleaved = buffer;
+            UnsignedByte* errorCorrection = interleaved + ecInfo.codewords;
+            UnsignedByte* data = errorCorrection + ecTotal;
+            UnsignedByte* output = data + ecInfo.codewords;
+            QRMatrixDecoder_readCodewords(bits, stride, *layout, dimension, &buffer[bufferSize], interleaved, errorCorrection);
+            int corrected = QRMatrixDecoder_correctBlocks(ecInfo, isMicro, interleaved, errorCorrection, data);
+            if (corrected < 0) {
+                delete[] buffer;
+                return QRMatrixStatus(EncodingStatus::tooManyErrors);
+            }
+            // Segments
+            QRMatrixDecodedSymbol decoded;
+            decoded.version = version;
+            decoded.isMicro = isMicro;
+            decoded.level = level;
+            decoded.maskId = maskId;
+            decoded.correctedCodewords = corrected;
+            if (isMicro) {
+                decoded.extraMode = QRMatrixExtraMode(EncodingExtraMode::microQr);
+            }
+            // Each segment takes 3 bits at least (MicroQR M1)
+            unsigned int dataBitsCount = layout->dataModulesCount();
+            segments = new QRMatrixDecoder_Segment [dataBitsCount / 3 + 1];
+            unsigned int count = 0;
+            QRMatrixDecoder_Bits reader(data, dataBitsCount);
+            status = QRMatrixDecoder_parse(reader, version, isMicro, segments, &count, output, decoded);
+            if (status.isSucceeded()) {
+                delete[] decoded.segments;
+                decoded.segments = nullptr;
+                decoded.segments = new QRMatrixSegment [count];
+                decoded.count = count;
+                for (unsigned int index = 0; index < count && status.isSucceeded(); index += 1) {
+                    QRMatrixDecoder_Segment& segment = segments[index];
+                    status = decoded.segments[index].tryFill(segment.mode, &output[segment.offset], segment.length, segment.eci);
+                    if (!status.isSucceeded() && status.code != EncodingStatus::internalError) {
+                        status = QRMatrixStatus(EncodingStatus::invalidBitStream, index, status.byteOffset);
+                    }
+                }
+            }
+            if (status.isSucceeded()) {
+                result = decoded;
+            }
+        } catch (...) {
+            status = QRMatrixStatus(EncodingStatus::internalError);
+        }
+        delete[] segments;
+        delete[] buffer;
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXDECODER_H
+#define QRMATRIXDECODER_H
+
+#include "constants.h"
+#include "qrmatrixboard.h"
+#include "qrmatrixsegment.h"
+#include "qrmatrixextramode.h"
+#include "qrmatrixstatus.h"
+
+namespace QRMatrix {
+
+    /// Content of QR symbol read by `QRMatrixDecoder`
+    struct QRMatrixDecodedSymbol {
+        /// QR Version (MicroQR version if `isMicro`)
+        UnsignedByte version;
+        /// Is MicroQR symbol
+        bool isMicro;
+        /// Error correction level (`low` for MicroQR M1, which has error detection only)
+        ErrorCorrectionLevel level;
+        /// Applied mask
+        UnsignedByte maskId;
+        /// Data segments. ECI Indicator of a segment is the one of the last ECI header before it
+        /// (`defaultEciAssigmentValue` if there is none).
+        QRMatrixSegment* segments;
+        /// Count of segments
+        unsigned int count;
+        /// `microQr`, `fnc1First`, `fnc1Second` (with its Application Indicator) or `none`
+        QRMatrixExtraMode extraMode;
+        /// Structured Append: index of this symbol (0...15)
+        UnsignedByte sequenceIndex;
+        /// Structured Append: number of symbols (0 if this symbol is not a part of Structured Append)
+        UnsignedByte sequenceTotal;
+        /// Structured Append: parity of whole data
+        UnsignedByte parity;
+        /// Number of codewords fixed by error correction
+        unsigned int correctedCodewords;
+
+        QRMatrixDecodedSymbol();
+        QRMatrixDecodedSymbol(QRMatrixDecodedSymbol &other);
+        ~QRMatrixDecodedSymbol();
+        void operator=(QRMatrixDecodedSymbol other);
+    };
+
+    /// Read content of `QRMatrixBoard` (eg. to verify encoded symbols or cached boards).
+    /// Format (and version) information is read with error correction, cells are unmasked & read in the order
+    /// codewords bits are placed (see `QRMatrixLayout::position`), blocks are de-interleaved & fixed
+    /// by their error correction codewords, then data codewords are parsed into segments.
+    /// Only the color plane of board is read (`QRMatrixBoard::packed()`).
+    class QRMatrixDecoder {
+    public:
+        /// Read content of `board`. Throw exception if it is not a valid symbol.
+        static QRMatrixDecodedSymbol decode(QRMatrixBoard& board);
+        /// Read content of `board` into `result` without throwing exception.
+        static QRMatrixStatus tryDecode(QRMatrixBoard& board, QRMatrixDecodedSymbol& result) noexcept;
+    };
+
+}
+
+#endif // QRMATRIXDECODER_H
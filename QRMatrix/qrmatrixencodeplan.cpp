@@ -0,0 +1,123 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixencodeplan.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+QRMatrixEncodePlan::~QRMatrixEncodePlan() {
+    if (segments_ != nullptr) {
+        delete[] segments_;
+    }
+    if (charactersCountBits_ != nullptr) {
+        delete[] charactersCountBits_;
+    }
+}
+
+QRMatrixEncodePlan::QRMatrixEncodePlan() {
+    segments_ = nullptr;
+    charactersCountBits_ = nullptr;
+    count_ = 0;
+    maskId_ = 0xFF;
+    dimension_ = 0;
+    bitsCount_ = 0;
+}
+
+QRMatrixEncodePlan::QRMatrixEncodePlan(const QRMatrixEncodePlan &other) {
+    segments_ = nullptr;
+    charactersCountBits_ = nullptr;
+    count_ = other.count_;
+    extraMode_ = other.extraMode_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    if (other.segments_ != nullptr) {
+        segments_ = new QRMatrixSegment [count_];
+        for (unsigned int index = 0; index < count_; index += 1) {
+            segments_[index] = other.segments_[index];
+        }
+    }
+    if (other.charactersCountBits_ != nullptr) {
+        charactersCountBits_ = new UnsignedByte [count_];
+        memcpy(charactersCountBits_, other.charactersCountBits_, count_);
+    }
+}
+
+QRMatrixEncodePlan::QRMatrixEncodePlan(QRMatrixEncodePlan &&other) {
+    segments_ = other.segments_;
+    charactersCountBits_ = other.charactersCountBits_;
+    count_ = other.count_;
+    extraMode_ = other.extraMode_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    other.segments_ = nullptr;
+    other.charactersCountBits_ = nullptr;
+    other.count_ = 0;
+    other.ecInfo_ = ErrorCorrectionInfo();
+}
+
+void QRMatrixEncodePlan::operator=(QRMatrixEncodePlan other) {
+    // `other` is already a copy, take its arrays & let it release ours
+    QRMatrixSegment* segments = segments_;
+    UnsignedByte* charactersCountBits = charactersCountBits_;
+    unsigned int count = count_;
+    segments_ = other.segments_;
+    charactersCountBits_ = other.charactersCountBits_;
+    count_ = other.count_;
+    extraMode_ = other.extraMode_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    other.segments_ = segments;
+    other.charactersCountBits_ = charactersCountBits;
+    other.count_ = count;
+}
+
+unsigned int QRMatrixEncodePlan::headerBitsCount(unsigned int index) const {
+    if (index >= count_ || !isValid()) {
+        return 0;
+    }
+    QRMatrixSegment& segment = segments_[index];
+    if (segment.length() == 0) {
+        return 0;
+    }
+    if (isMicro()) {
+        return Common::microModeIndicatorLength(ecInfo_.version, segment.mode()) + charactersCountBits_[index];
+    }
+    unsigned int result = 4 + charactersCountBits_[index];
+    if (segment.isEciHeaderRequired()) {
+        // 4 bits ECI mode indicator, 1...3 bytes ECI indicator
+        if (segment.eci() <= 127) {
+            result += 4 + 8;
+        } else if (segment.eci() <= 16383) {
+            result += 4 + 16;
+        } else {
+            result += 4 + 24;
+        }
+    }
+    return result;
+}
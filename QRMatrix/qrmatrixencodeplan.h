@@ -0,0 +1,90 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXENCODEPLAN_H
+#define QRMATRIXENCODEPLAN_H
+
+#include "constants.h"
+#include "common.h"
+#include "qrmatrixsegment.h"
+#include "qrmatrixextramode.h"
+
+namespace QRMatrix {
+
+    /// Result of `QRMatrixEncoder::prepare`: QR version & properties chosen for given segments.
+    /// Pass it to `QRMatrixEncoder::encode` to encode without analysing segments again.
+    /// The plan keeps a copy of segments & the Characters Count bits of each of them,
+    /// so given segments can be changed or deleted after `prepare`.
+    class QRMatrixEncodePlan {
+    public:
+        ~QRMatrixEncodePlan();
+        QRMatrixEncodePlan(const QRMatrixEncodePlan &other);
+        QRMatrixEncodePlan(QRMatrixEncodePlan &&other);
+        void operator=(QRMatrixEncodePlan other);
+        /// Empty plan (not valid for encoding). Result of `QRMatrixEncoder::prepare` will be assigned later.
+        QRMatrixEncodePlan();
+
+        /// Plan is made by `QRMatrixEncoder::prepare` successfully
+        inline bool isValid() const { return ecInfo_.version > 0; }
+        /// Copy of encoded segments (must not be changed)
+        inline QRMatrixSegment* segments() const { return segments_; }
+        /// Number of segments
+        inline unsigned int count() const { return count_; }
+        /// Error correction level
+        inline ErrorCorrectionLevel level() const { return ecInfo_.level; }
+        /// Extra mode
+        inline const QRMatrixExtraMode& extraMode() const { return extraMode_; }
+        /// Forced mask (0xFF for best mask)
+        inline UnsignedByte maskId() const { return maskId_; }
+        /// QR Version (MicroQR version if `isMicro()`)
+        inline UnsignedByte version() const { return ecInfo_.version; }
+        /// Is MicroQR symbol
+        inline bool isMicro() const { return extraMode_.mode == EncodingExtraMode::microQr; }
+        /// Symbol dimension (number of cells on each side)
+        inline UnsignedByte dimension() const { return dimension_; }
+        /// Internal purpose. Blocks & codewords of symbol.
+        inline const ErrorCorrectionInfo& errorCorrectionInfo() const { return ecInfo_; }
+        /// Number of data bits (all headers included, terminator & paddings excluded)
+        inline unsigned int bitsCount() const { return bitsCount_; }
+        /// Number of data bits the symbol can hold
+        inline unsigned int capacity() const { return ecInfo_.codewords * 8; }
+        /// Number of header bits (ECI, Mode indicator, Characters count) of segment at given index
+        /// (FNC1 & Structured Append headers are not included).
+        unsigned int headerBitsCount(unsigned int index) const;
+        /// Internal purpose. Number of Characters Count bits of each segment.
+        inline const UnsignedByte* charactersCountBits() const { return charactersCountBits_; }
+    private:
+        friend class QRMatrixEncoder;
+
+        QRMatrixSegment* segments_;
+        UnsignedByte* charactersCountBits_;
+        unsigned int count_;
+        QRMatrixExtraMode extraMode_;
+        UnsignedByte maskId_;
+        UnsignedByte dimension_;
+        ErrorCorrectionInfo ecInfo_;
+        unsigned int bitsCount_;
+    };
+
+}
+
+#endif // QRMATRIXENCODEPLAN_H
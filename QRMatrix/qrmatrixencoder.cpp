@@ -23,6 +23,9 @@
 #include "qrmatrixencoder.h"
 #include "common.h"
 #include <string>
+#include <cstring>
+#include <atomic>
+#include <utility>
 
 #include "Encoder/numericencoder.h"
 #include "Encoder/alphanumericencoder.h"
@@ -38,213 +41,350 @@ using namespace QRMatrix;
 
 // PREPARE DATA --------------------------------------------------------------------------------------------------------------------------------------
 
-/// Calculate encoded data bits count,
+/// Calculate encoded data bits count of 1 segment,
 /// include Mode Indicator and ECI header bits,
 /// exclude Characters Count bits
 unsigned int QRMatrixEncoder_calculateEncodedDataBitsCount(
+    EncodingMode mode,
+    unsigned int length,
+    bool isEciHeaderRequired,
+    unsigned int eci
+) {
+    if (length == 0) {
+        return 0;
+    }
+    // Mode indicator
+    unsigned int totalDataBitsCount = 4;
+    // ECI
+    if (isEciHeaderRequired) {
+        totalDataBitsCount += 4; // ECI Header
+        if (eci <= 128) {
+            totalDataBitsCount += 8; // 1 byte ECI Indicator
+        } else if (eci <= 16383) {
+            totalDataBitsCount += 16; // 2 bytes ECI Indicator
+        } else {
+            totalDataBitsCount += 24; // 3 bytes ECI Indicator
+        }
+    }
+    // Data
+    switch (mode) {
+    case EncodingMode::numeric: {
+        // 3 characters encoded in 10 bits (each character is 1 byte)
+        unsigned int numberOfGroups = (length / 3);
+        totalDataBitsCount += numberOfGroups * NUM_TRIPLE_DIGITS_BITS_LEN;
+        // Remaining chars
+        UnsignedByte remainChars = length % 3;
+        switch (remainChars) {
+        case 1:
+            totalDataBitsCount += NUM_SINGLE_DIGIT_BITS_LEN;
+            break;
+        case 2:
+            totalDataBitsCount += NUM_DOUBLE_DIGITS_BITS_LEN;
+        default:
+            break;
+        }
+    }
+    break;
+    case EncodingMode::alphaNumeric: {
+        // 2 characters encoded in 11 bits (each character is 1 byte)
+        // Remaining character encoded in 6 bits.
+        unsigned int numberOfGroups = length / 2;
+        unsigned int remaining = length % 2;
+        totalDataBitsCount += ALPHA_NUM_PAIR_CHARS_BITS_LEN * numberOfGroups +
+                              ALPHA_NUM_SINGLE_CHAR_BITS_LEN * remaining;
+    }
+    break;
+    case EncodingMode::kanji:
+        // 2 bytes per Kanji character.
+        // Each character is encoded in 13 bits.
+        totalDataBitsCount += (length / 2) * 13;
+        break;
+    case EncodingMode::byte:
+        totalDataBitsCount += length * 8;
+        break;
+    }
+    return totalDataBitsCount;
+}
+
+/// Index of encoding mode in tables of `QRMatrixEncoder_Capacities` & `QRMatrixEncoder_DataSize`
+unsigned int QRMatrixEncoder_modeIndex(EncodingMode mode) {
+    switch (mode) {
+    case EncodingMode::numeric:
+        return 0;
+    case EncodingMode::alphaNumeric:
+        return 1;
+    case EncodingMode::byte:
+        return 2;
+    case EncodingMode::kanji:
+        return 3;
+    }
+    return 0;
+}
+
+/// Precomputed tables to find version without building `ErrorCorrectionInfo` of each version
+struct QRMatrixEncoder_Capacities {
+    /// Data capacity (bits) of each level (index by `ErrorCorrectionLevel` value) and version (index by version, index 0 is not used)
+    Unsigned2Bytes bits[4][QR_MAX_VERSION + 1];
+    /// Number of Characters Count bits of each version and mode (index by `QRMatrixEncoder_modeIndex`)
+    UnsignedByte charactersCountBits[QR_MAX_VERSION + 1][4];
+    /// Same as `bits` for MicroQR (0 if level is not available)
+    Unsigned2Bytes microBits[4][MICROQR_MAX_VERSION + 1];
+    /// Same as `charactersCountBits` for MicroQR
+    UnsignedByte microCharactersCountBits[MICROQR_MAX_VERSION + 1][4];
+};
+
+const QRMatrixEncoder_Capacities& QRMatrixEncoder_capacities() {
+    static const QRMatrixEncoder_Capacities capacities = []() {
+        static const EncodingMode modes[4] = { numeric, alphaNumeric, byte, kanji };
+        QRMatrixEncoder_Capacities result = {};
+        for (unsigned int level = 0; level < 4; level += 1) {
+            for (UnsignedByte version = 1; version <= QR_MAX_VERSION; version += 1) {
+                result.bits[level][version] = ErrorCorrectionInfo::errorCorrectionInfo(version, (ErrorCorrectionLevel)level).codewords * 8;
+            }
+            for (UnsignedByte version = 1; version <= MICROQR_MAX_VERSION; version += 1) {
+                result.microBits[level][version] = ErrorCorrectionInfo::microErrorCorrectionInfo(version, (ErrorCorrectionLevel)level).codewords * 8;
+            }
+        }
+        for (unsigned int index = 0; index < 4; index += 1) {
+            for (UnsignedByte version = 1; version <= QR_MAX_VERSION; version += 1) {
+                result.charactersCountBits[version][index] = Common::charactersCountIndicatorLength(version, modes[index]);
+            }
+            for (UnsignedByte version = 1; version <= MICROQR_MAX_VERSION; version += 1) {
+                result.microCharactersCountBits[version][index] = Common::microCharactersCountIndicatorLength(version, modes[index]);
+            }
+        }
+        return result;
+    } ();
+    return capacities;
+}
+
+/// Size of data to be encoded, independent from QR version
+struct QRMatrixEncoder_DataSize {
+    /// Total bits, excluding bits for Characters Count,
+    /// because each version requires difference number of Characters Count bits.
+    unsigned int bitsCount;
+    /// Number of non-empty segments of each mode (index by `QRMatrixEncoder_modeIndex`)
+    unsigned int modeCounts[4];
+
+    QRMatrixEncoder_DataSize() {
+        bitsCount = 0;
+        for (unsigned int index = 0; index < 4; index += 1) {
+            modeCounts[index] = 0;
+        }
+    }
+
+    /// Add 1 segment
+    void add(EncodingMode mode, unsigned int length, bool isEciHeaderRequired, unsigned int eci) {
+        if (length == 0) {
+            return;
+        }
+        bitsCount += QRMatrixEncoder_calculateEncodedDataBitsCount(mode, length, isEciHeaderRequired, eci);
+        modeCounts[QRMatrixEncoder_modeIndex(mode)] += 1;
+    }
+
+    /// Add bits of Structured Append & FNC1 headers
+    void addHeaders(const QRMatrixExtraMode& extraMode, bool isStructuredAppend) {
+        if (isStructuredAppend) {
+            bitsCount += 20; // 4 bits header, 4 bits position, 4 bits total number, 1 byte parity
+        }
+        if (extraMode.mode == EncodingExtraMode::fnc1First) {
+            bitsCount += 4; // 4 bits FNC1 indicator
+        } else  if (extraMode.mode == EncodingExtraMode::fnc1Second) {
+            bitsCount += 12; // 4 bits FNC1 indicator, 8 bits Application Indicator
+        }
+    }
+
+    inline bool isEmpty() { return modeCounts[0] + modeCounts[1] + modeCounts[2] + modeCounts[3] == 0; }
+
+    /// Total number of Characters Count bits of a version which has given Characters Count bits for each mode.
+    unsigned int charactersCountBitsCount(const UnsignedByte* charactersCountBits) {
+        unsigned int bits = 0;
+        for (unsigned int index = 0; index < 4; index += 1) {
+            bits += modeCounts[index] * charactersCountBits[index];
+        }
+        return bits;
+    }
+
+    /// Number of capacity bits required by a version which has given Characters Count bits for each mode.
+    /// Data must be less than capacity even if it does not have Characters Count bits.
+    unsigned int requiredBits(const UnsignedByte* charactersCountBits) {
+        unsigned int bits = charactersCountBitsCount(charactersCountBits);
+        return bitsCount + (bits > 0 ? bits : 1);
+    }
+};
+
+QRMatrixEncoder_DataSize QRMatrixEncoder_dataSize(
     QRMatrixSegment* segments,
-    unsigned int count
+    unsigned int count,
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend
 ) {
-    unsigned int totalDataBitsCount = 0;
+    QRMatrixEncoder_DataSize result;
     for (unsigned int index = 0; index < count; index += 1) {
-        QRMatrixSegment segment = segments[index];
-        if (segment.length() == 0) {
+        QRMatrixSegment& segment = segments[index];
+        result.add(segment.mode(), segment.length(), segment.isEciHeaderRequired(), segment.eci());
+    }
+    result.addHeaders(extraMode, isStructuredAppend);
+    return result;
+}
+
+/// Find smallest QR version (≥ `minVersion`) to fit data (0 if not found).
+/// Data capacity increases by version and Characters Count bits are the same for
+/// all versions of each class (1-9, 10-26, 27-40), so binary search on capacity table of each class.
+UnsignedByte QRMatrixEncoder_findStandardVersion(
+    QRMatrixEncoder_DataSize& size,
+    ErrorCorrectionLevel level,
+    UnsignedByte minVersion
+) {
+    static const UnsignedByte versionClasses[3][2] = {{ 1, 9 }, { 10, 26 }, { 27, QR_MAX_VERSION }};
+    const QRMatrixEncoder_Capacities& capacities = QRMatrixEncoder_capacities();
+    const Unsigned2Bytes* bits = capacities.bits[level];
+    for (unsigned int index = 0; index < 3; index += 1) {
+        UnsignedByte lower = versionClasses[index][0] > minVersion ? versionClasses[index][0] : minVersion;
+        UnsignedByte upper = versionClasses[index][1];
+        if (lower > upper) {
             continue;
         }
-        // Mode indicator
-        totalDataBitsCount += 4;
-        // ECI
-        if (segment.isEciHeaderRequired()) {
-            totalDataBitsCount += 4; // ECI Header
-            if (segment.eci() <= 128) {
-                totalDataBitsCount += 8; // 1 byte ECI Indicator
-            } else if (segment.eci() <= 16383) {
-                totalDataBitsCount += 16; // 2 bytes ECI Indicator
-            } else {
-                totalDataBitsCount += 24; // 3 bytes ECI Indicator
-            }
+        unsigned int required = size.requiredBits(capacities.charactersCountBits[upper]);
+        if (bits[upper] < required) {
+            continue;
         }
-        // Data
-        switch (segment.mode()) {
-        case EncodingMode::numeric: {
-            // 3 characters encoded in 10 bits (each character is 1 byte)
-            unsigned int numberOfGroups = (segment.length() / 3);
-            totalDataBitsCount += numberOfGroups * NUM_TRIPLE_DIGITS_BITS_LEN;
-            // Remaining chars
-            UnsignedByte remainChars = segment.length() % 3;
-            switch (remainChars) {
-            case 1:
-                totalDataBitsCount += NUM_SINGLE_DIGIT_BITS_LEN;
-                break;
-            case 2:
-                totalDataBitsCount += NUM_DOUBLE_DIGITS_BITS_LEN;
-            default:
-                break;
+        while (lower < upper) {
+            UnsignedByte middle = (lower + upper) / 2;
+            if (bits[middle] < required) {
+                lower = middle + 1;
+            } else {
+                upper = middle;
             }
         }
-        break;
-        case EncodingMode::alphaNumeric: {
-            // 2 characters encoded in 11 bits (each character is 1 byte)
-            // Remaining character encoded in 6 bits.
-            unsigned int numberOfGroups = segment.length() / 2;
-            unsigned int remaining = segment.length() % 2;
-            totalDataBitsCount += ALPHA_NUM_PAIR_CHARS_BITS_LEN * numberOfGroups +
-                                  ALPHA_NUM_SINGLE_CHAR_BITS_LEN * remaining;
+        return lower;
+    }
+    return 0;
+}
+
+/// Find smallest MicroQR version (≥ `minVersion`) to fit data.
+QRMatrixStatus QRMatrixEncoder_findMicroVersion(
+    QRMatrixEncoder_DataSize& size,
+    ErrorCorrectionLevel level,
+    UnsignedByte minVersion,
+    UnsignedByte* result
+) {
+    const QRMatrixEncoder_Capacities& capacities = QRMatrixEncoder_capacities();
+    const Unsigned2Bytes* bits = capacities.microBits[level];
+    UnsignedByte found = 0;
+    for (UnsignedByte version = minVersion; version <= MICROQR_MAX_VERSION; version += 1) {
+        if (version > 1 && level == ErrorCorrectionLevel::high) {
+            return QRMatrixStatus(EncodingStatus::levelNotAvailable);
         }
-        break;
-        case EncodingMode::kanji:
-            // 2 bytes per Kanji character.
-            // Each character is encoded in 13 bits.
-            totalDataBitsCount += (segment.length() / 2) * 13;
+        if (bits[version] == 0) {
             break;
-        case EncodingMode::byte:
-            totalDataBitsCount += segment.length() * 8;
+        }
+        if (size.requiredBits(capacities.microCharactersCountBits[version]) <= bits[version]) {
+            found = version;
             break;
         }
     }
-    return totalDataBitsCount;
+    if (found == 0) {
+        return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+    }
+    if (found < 2 && size.modeCounts[QRMatrixEncoder_modeIndex(alphaNumeric)] > 0) {
+        // AlphaNumeric Mode is not available with M1
+        found = 2;
+    }
+    if (found < 3 && (size.modeCounts[QRMatrixEncoder_modeIndex(byte)] > 0 || size.modeCounts[QRMatrixEncoder_modeIndex(kanji)] > 0)) {
+        // Byte/Kanji Mode is not available with <= M2
+        found = 3;
+    }
+    // Level Q is available with M4 only, level H is not available with M2+
+    while (found <= MICROQR_MAX_VERSION && bits[found] == 0) {
+        found += 1;
+    }
+    if (found > MICROQR_MAX_VERSION) {
+        return QRMatrixStatus(EncodingStatus::levelNotAvailable);
+    }
+    if (size.requiredBits(capacities.microCharactersCountBits[found]) > bits[found]) {
+        return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+    }
+    *result = found;
+    return QRMatrixStatus();
+}
+
+/// Find QR Version for data of given size
+QRMatrixStatus QRMatrixEncoder_findVersion(
+    QRMatrixEncoder_DataSize& size,
+    ErrorCorrectionLevel level,
+    UnsignedByte minVersion,
+    bool isMicro,
+    UnsignedByte* result
+) noexcept {
+    UnsignedByte maxVer = isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION;
+    UnsignedByte version = (minVersion > 0 && minVersion <= maxVer) ? minVersion : 1;
+    if (isMicro) {
+        return QRMatrixEncoder_findMicroVersion(size, level, version, result);
+    }
+    *result = QRMatrixEncoder_findStandardVersion(size, level, version);
+    if (*result == 0) {
+        return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+    }
+    return QRMatrixStatus();
 }
 
 /// Find QR Version & its properties
-ErrorCorrectionInfo QRMatrixEncoder_findVersion(
+QRMatrixStatus QRMatrixEncoder_findVersion(
     QRMatrixSegment* segments,
     unsigned int count,
     ErrorCorrectionLevel level,
     UnsignedByte minVersion,
-    QRMatrixExtraMode extraMode,
-    bool isStructuredAppend
-) {
-    // This is total estimated bits of data, excluding bits for Characters Count,
-    // because each version requires difference number of Characters Count bits.
-    unsigned int totalDataBitsCount = QRMatrixEncoder_calculateEncodedDataBitsCount(segments, count);
-    if (isStructuredAppend) {
-        totalDataBitsCount += 20; // 4 bits header, 4 bits position, 4 bits total number, 1 byte parity
-    }
-    if (extraMode.mode == EncodingExtraMode::fnc1First) {
-        totalDataBitsCount += 4; // 4 bits FNC1 indicator
-    } else  if (extraMode.mode == EncodingExtraMode::fnc1Second) {
-        totalDataBitsCount += 12; // 4 bits FNC1 indicator, 8 bits Application Indicator
-    }
-    // Go for each version, get total bits and check
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend,
+    ErrorCorrectionInfo* result
+) noexcept {
+    QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, extraMode, isStructuredAppend);
     bool isMicro = (extraMode.mode == EncodingExtraMode::microQr && !isStructuredAppend);
-    UnsignedByte maxVer = isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION;
-    for (UnsignedByte version = (minVersion > 0 && minVersion <= maxVer) ? minVersion : 1; version <= maxVer; version += 1) {
-        if (version > 1 && isMicro && level == ErrorCorrectionLevel::high) {
-            throw QR_EXCEPTION("Error Correction Level High not available in MicroQR.");
-        }
-        ErrorCorrectionInfo info = isMicro ?
+    UnsignedByte version = 0;
+    QRMatrixStatus status = QRMatrixEncoder_findVersion(size, level, minVersion, isMicro, &version);
+    if (status.isSucceeded()) {
+        *result = isMicro ?
             ErrorCorrectionInfo::microErrorCorrectionInfo(version, level) :
             ErrorCorrectionInfo::errorCorrectionInfo(version, level);
-        unsigned int capacity = info.codewords * 8;
-        if (capacity == 0) {
-            break;
-        }
-        if (totalDataBitsCount >= capacity) {
-            // Not need to count total bits, just go to next version
-            continue;
-        }
-        // Calculate total number of bits for Characters Count for this version
-        unsigned int totalBits = totalDataBitsCount;
-        bool hasAlpha = false;
-        bool hasKanji = false;
-        bool hasByte = false;
-        for (unsigned int index = 0; index < count; index += 1) {
-            QRMatrixSegment segment = segments[index];
-            if (segment.length() == 0) {
-                continue;
-            }
-            switch (segment.mode()) {
-            case QRMatrix::alphaNumeric:
-                hasAlpha = true;
-                break;
-            case QRMatrix::byte:
-                hasByte = true;
-                break;
-            case QRMatrix::kanji:
-                hasKanji = true;
-                break;
-            default:
-                break;
-            }
-            totalBits += isMicro ?
-                Common::microCharactersCountIndicatorLength(version, segment.mode()) :
-                Common::charactersCountIndicatorLength(version, segment.mode());
-        }
-        // Check if this QR version bits capacity is enough for required total bits
-        if (totalBits <= capacity) {
-            UnsignedByte finalVer = version;
-            if (isMicro) {
-                if (finalVer < 2 && hasAlpha) {
-                    // AlphaNumeric Mode is not available with M1
-                    finalVer = 2;
-                }
-                if (finalVer < 3 && (hasByte || hasKanji)) {
-                    // Byte/Kanji Mode is not available with <= M2
-                    finalVer = 3;
-                }
-            }
-            if (finalVer == version) {
-                return info;
-            }
-            return isMicro ?
-                ErrorCorrectionInfo::microErrorCorrectionInfo(finalVer, level) :
-                ErrorCorrectionInfo::errorCorrectionInfo(finalVer, level);
-        }
     }
-    return ErrorCorrectionInfo();
+    return status;
 }
 
 // ENCODE DATA---------------------------------------------------------------------------------------------------------------------------------------
 
-/// Encode ECI Indicator
-UnsignedByte* QRMatrixEncoder_encodeEciIndicator(Unsigned4Bytes indicator, UnsignedByte* resultLength) {
-    UnsignedByte* indicatorPtr = (UnsignedByte*)&indicator;
-    UnsignedByte* result;
+/// Encode ECI Indicator into `result` (3 bytes maximum)
+/// @return Number of bytes of encoded ECI Indicator
+UnsignedByte QRMatrixEncoder_encodeEciIndicator(Unsigned4Bytes indicator, UnsignedByte* result) {
     if (indicator <= 127) {
-        *resultLength = 1;
-        result = new UnsignedByte [1];
-        if (Common::isLittleEndian) {
-            result[0] = indicatorPtr[0] & 0x7F;
-        } else {
-            result[0] = indicatorPtr[3] & 0x7F;
-        }
-    } else if (indicator <= 16383) {
-        *resultLength = 2;
-        result = new UnsignedByte [2];
-        if (Common::isLittleEndian) {
-            result[0] = (indicatorPtr[1] & 0x3F) | 0x80;
-            result[1] = indicatorPtr[0];
-        } else {
-            result[0] = (indicatorPtr[2] & 0x3F) | 0x80;
-            result[1] = indicatorPtr[3];
-        }
-    } else if (indicator <= 999999) {
-        *resultLength = 3;
-        result = new UnsignedByte [3];
-        if (Common::isLittleEndian) {
-            result[0] = (indicatorPtr[2] & 0x1F) | 0xC0;
-            result[1] = indicatorPtr[1];
-            result[2] = indicatorPtr[0];
-        } else {
-            result[0] = (indicatorPtr[1] & 0x1F) | 0xC0;
-            result[1] = indicatorPtr[2];
-            result[2] = indicatorPtr[3];
-        }
-    } else {
-        throw QR_EXCEPTION("Invalid ECI Indicator");
+        result[0] = indicator & 0x7F;
+        return 1;
     }
-    return result;
+    if (indicator <= 16383) {
+        result[0] = ((indicator >> 8) & 0x3F) | 0x80;
+        result[1] = indicator & 0xFF;
+        return 2;
+    }
+    if (indicator <= 999999) {
+        result[0] = ((indicator >> 16) & 0x1F) | 0xC0;
+        result[1] = (indicator >> 8) & 0xFF;
+        result[2] = indicator & 0xFF;
+        return 3;
+    }
+    throw QR_EXCEPTION("Invalid ECI Indicator");
 }
 
-/// Encode segments into buffer
+/// Encode segments into buffer.
+/// `charactersCountBits`: number of Characters Count bits if known (0 to look it up from version & mode).
 void QRMatrixEncoder_encodeSegment(
     UnsignedByte* buffer,
-    QRMatrixSegment segment,
+    QRMatrixSegment& segment,
     unsigned int segmentIndex,
     ErrorCorrectionLevel level,
-    ErrorCorrectionInfo ecInfo,
+    ErrorCorrectionInfo& ecInfo,
     unsigned int* bitIndex,
-    QRMatrixExtraMode extraMode
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte charactersCountBits = 0
 ) {
     if (segment.length() == 0) {
         return;
@@ -253,8 +393,8 @@ void QRMatrixEncoder_encodeSegment(
     unsigned int uintSize = sizeof(unsigned int);
     // ECI Header if enable
     if (!isMicro && segment.isEciHeaderRequired()) {
-        UnsignedByte eciLen = 0;
-        UnsignedByte* eciHeader = QRMatrixEncoder_encodeEciIndicator(segment.eci(), &eciLen);
+        UnsignedByte eciHeader[3];
+        UnsignedByte eciLen = QRMatrixEncoder_encodeEciIndicator(segment.eci(), eciHeader);
         // 4 bits of ECI mode indicator
         UnsignedByte eciModeHeader = 0b0111;
         Common::copyBits(&eciModeHeader, 1, 4, false, buffer, *bitIndex, 4);
@@ -270,7 +410,6 @@ void QRMatrixEncoder_encodeSegment(
             8 * eciLen // number of bits to be copied
             );
         *bitIndex += 8 * eciLen;
-        delete[] eciHeader;
     }
     if (segmentIndex == 0) {
         if (extraMode.mode == EncodingExtraMode::fnc1First) {
@@ -286,10 +425,8 @@ void QRMatrixEncoder_encodeSegment(
             case 1:
                 fnc1Header = extraMode.appIndicator[0] + 100;
                 break;
-            case 2: {
-                std::string numStr = std::string((char*)extraMode.appIndicator, 2);
-                fnc1Header = std::stoi(numStr);
-            }
+            case 2:
+                fnc1Header = (extraMode.appIndicator[0] - '0') * 10 + (extraMode.appIndicator[1] - '0');
                 break;
             default:
                 break;
@@ -306,9 +443,12 @@ void QRMatrixEncoder_encodeSegment(
         *bitIndex += numberOfModeBits;
     }
     // Character counts bits
-    unsigned int charCountIndicatorLen = isMicro ?
-        Common::microCharactersCountIndicatorLength(ecInfo.version, segment.mode()) :
-        Common::charactersCountIndicatorLength(ecInfo.version, segment.mode());
+    unsigned int charCountIndicatorLen = charactersCountBits;
+    if (charCountIndicatorLen == 0) {
+        charCountIndicatorLen = isMicro ?
+            Common::microCharactersCountIndicatorLength(ecInfo.version, segment.mode()) :
+            Common::charactersCountIndicatorLength(ecInfo.version, segment.mode());
+    }
     unsigned int charCount = 0;
     switch (segment.mode()) {
     case EncodingMode::numeric:
@@ -366,17 +506,18 @@ void QRMatrixEncoder_encodeSegment(
 
 // ERROR CORRECTION ---------------------------------------------------------------------------------------------------------------------------------
 
-/// Generate Error correction bytes
-/// @return Binary data (should be deleted on unused)
-UnsignedByte* QRMatrixEncoder_generateErrorCorrections(
+/// Generate Error correction bytes of 1 block into `result` (`ecInfo.ecCodewordsPerBlock` bytes)
+void QRMatrixEncoder_generateErrorCorrections(
     /// Bytes from previous (encode data) step
     UnsignedByte* encodedData,
     /// EC Info from previous step
-    ErrorCorrectionInfo ecInfo,
+    ErrorCorrectionInfo& ecInfo,
     /// Group number: 0, 1
     UnsignedByte group,
     /// Block number: 0, ...
-    UnsignedByte block
+    UnsignedByte block,
+    /// Buffer to write result into
+    UnsignedByte* result
 ) {
     UnsignedByte maxGroup = ecInfo.groupCount();
     if (group >= maxGroup) {
@@ -402,40 +543,31 @@ UnsignedByte* QRMatrixEncoder_generateErrorCorrections(
     if (block >= maxBlock) {
         throw QR_EXCEPTION("Invalid block number");
     }
-
-    Polynomial mesg(blockSize);
-    for (unsigned int index = 0; index < blockSize; index += 1) {
-        mesg.terms[index] = encodedData[offset + index];
-    }
-    Polynomial ecc = mesg.getErrorCorrections(ecInfo.ecCodewordsPerBlock);
-    UnsignedByte* result = Common::allocate(ecc.length);
-    for (unsigned int index = 0; index < ecc.length; index += 1) {
-        result[index] = ecc.terms[index];
-    }
+    Polynomial::getErrorCorrections(&encodedData[offset], blockSize, ecInfo.ecCodewordsPerBlock, result);
 #if LOGABLE
     LOG("DATA to ECC", ":",
         "group=", std::to_string(group).c_str(),
         "block=", std::to_string(block).c_str(),
-        DevTools::getBin(mesg.terms, mesg.length).c_str());
+        DevTools::getBin(&encodedData[offset], blockSize).c_str());
     LOG("ECC", ":",
         "group=", std::to_string(group).c_str(),
         "block=", std::to_string(block).c_str(),
-        DevTools::getBin(result, ecc.length).c_str());
+        DevTools::getBin(result, ecInfo.ecCodewordsPerBlock).c_str());
 #endif
-    return result;
 }
 
 
-/// Generate Error correction bytes
-/// @return Binary data (should be deleted on unused). 2D array contains EC bytes for all blocks.
-UnsignedByte** QRMatrixEncoder_generateErrorCorrections(
+/// Generate Error correction bytes for all blocks into `result`
+/// (`ecInfo.ecCodewordsTotalCount()` bytes, `ecInfo.ecCodewordsPerBlock` bytes for each block).
+void QRMatrixEncoder_generateErrorCorrections(
     /// Bytes from previous (encode data) step
     UnsignedByte* encodedData,
     /// EC Info from previous step
-    ErrorCorrectionInfo ecInfo
+    ErrorCorrectionInfo& ecInfo,
+    /// Buffer to write result into
+    UnsignedByte* result
 ) {
     UnsignedByte maxGroup = ecInfo.groupCount();
-    UnsignedByte** result = new UnsignedByte* [ecInfo.ecBlockTotalCount()];
     unsigned int blockIndex = 0;
     for (UnsignedByte group = 0; group < maxGroup; group += 1) {
         UnsignedByte maxBlock = 0;
@@ -450,28 +582,61 @@ UnsignedByte** QRMatrixEncoder_generateErrorCorrections(
             break;
         }
         for (UnsignedByte block = 0; block < maxBlock; block += 1) {
-            result[blockIndex] = QRMatrixEncoder_generateErrorCorrections(encodedData, ecInfo, group, block);
+            QRMatrixEncoder_generateErrorCorrections(
+                encodedData, ecInfo, group, block,
+                &result[blockIndex * ecInfo.ecCodewordsPerBlock]
+            );
             blockIndex += 1;
         }
     }
-    return result;
+}
+
+/// Continue Error correction bytes of all blocks in `result` (same layout as above) with codewords
+/// from index `begin` to `end` (excluded) of encoded data.
+/// `result` must hold the remainders of codewords before `begin` of each block (all 0 if `begin` is 0).
+void QRMatrixEncoder_continueErrorCorrections(
+    /// Bytes from previous (encode data) step
+    const UnsignedByte* encodedData,
+    /// EC Info from previous step
+    ErrorCorrectionInfo& ecInfo,
+    /// Index of first codeword to add
+    unsigned int begin,
+    /// Index after last codeword to add
+    unsigned int end,
+    /// Remainders to update
+    UnsignedByte* result
+) {
+    unsigned int blockCount = ecInfo.ecBlockTotalCount();
+    unsigned int offset = 0;
+    for (unsigned int index = 0; index < blockCount; index += 1) {
+        unsigned int blockSize = index < ecInfo.group1Blocks ? ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords;
+        unsigned int first = begin > offset ? begin : offset;
+        unsigned int last = end < offset + blockSize ? end : offset + blockSize;
+        if (first < last) {
+            Polynomial::continueErrorCorrections(
+                &encodedData[first], last - first, ecInfo.ecCodewordsPerBlock,
+                &result[index * ecInfo.ecCodewordsPerBlock]
+            );
+        }
+        offset += blockSize;
+    }
 }
 
 // INTERLEAVE ---------------------------------------------------------------------------------------------------------------------------------------
 
-/// Interleave data codeworks
+/// Interleave data codeworks into `result` (`ecInfo.codewords` bytes)
 /// Throw error if QR has only 1 block in total (check ecInfo before call this function)
-/// @return Binary data (should be deleted on unused)
-UnsignedByte* QRMatrixEncoder_interleave(
+void QRMatrixEncoder_interleave(
     /// Encoded data
     UnsignedByte* encodedData,
     /// EC info
-    ErrorCorrectionInfo ecInfo
+    ErrorCorrectionInfo& ecInfo,
+    /// Buffer to write result into
+    UnsignedByte* result
 ) {
     if (ecInfo.ecBlockTotalCount() == 1) {
         throw QR_EXCEPTION("Interleave not required");
     }
-    UnsignedByte* result = new UnsignedByte [ecInfo.codewords];
     unsigned int blockCount = ecInfo.ecBlockTotalCount();
     UnsignedByte* blockPtr[blockCount];
     UnsignedByte* blockEndPtr[blockCount];
@@ -520,49 +685,101 @@ UnsignedByte* QRMatrixEncoder_interleave(
             loopCount += 1;
         }
     }
-    return result;
 }
 
-/// Interleave error correction codeworks
+/// Interleave error correction codeworks into `result` (`ecInfo.ecCodewordsTotalCount()` bytes)
 /// Throw error if QR has only 1 block in total (check ecInfo before call this function)
-/// @return Binary data (should be deleted on unused)
-UnsignedByte* QRMatrixEncoder_interleave(
-    /// Error correction data
-    UnsignedByte** data,
+void QRMatrixEncoder_interleaveErrorCorrections(
+    /// Error correction data (`ecInfo.ecCodewordsPerBlock` bytes for each block)
+    UnsignedByte* data,
     /// EC info
-    ErrorCorrectionInfo ecInfo
+    ErrorCorrectionInfo& ecInfo,
+    /// Buffer to write result into
+    UnsignedByte* result
 ) {
     if (ecInfo.ecBlockTotalCount() == 1) {
         throw QR_EXCEPTION("Interleave not required");
     }
     unsigned int blockCount = ecInfo.ecBlockTotalCount();
-    UnsignedByte* result = new UnsignedByte[ecInfo.ecCodewordsTotalCount()];
     unsigned int resIndex = 0;
     for (unsigned int index = 0; index < ecInfo.ecCodewordsPerBlock; index += 1) {
         for (unsigned int jndex = 0; jndex < blockCount; jndex += 1) {
-            result[resIndex] = data[jndex][index];
+            result[resIndex] = data[jndex * ecInfo.ecCodewordsPerBlock + index];
             resIndex += 1;
         }
     }
-    return result;
+}
+
+/// Generate Error correction bytes of all blocks on workers of `pool`.
+/// Each block writes its data & error correction codewords directly into their interleaved positions
+/// (same result as `QRMatrixEncoder_interleave` & `QRMatrixEncoder_interleaveErrorCorrections`).
+void QRMatrixEncoder_generateInterleavedErrorCorrections(
+    /// Workers
+    QRMatrixThreadPool& pool,
+    /// Bytes from previous (encode data) step
+    UnsignedByte* encodedData,
+    /// EC Info from previous step
+    ErrorCorrectionInfo& ecInfo,
+    /// Buffer to write interleaved data into (`ecInfo.codewords` bytes)
+    UnsignedByte* interleave,
+    /// Buffer to write interleaved error corrections into (`ecInfo.ecCodewordsTotalCount()` bytes)
+    UnsignedByte* ecInterleave
+) {
+    unsigned int blockCount = ecInfo.ecBlockTotalCount();
+    pool.run(blockCount, [encodedData, &ecInfo, interleave, ecInterleave, blockCount](unsigned int, unsigned int block) {
+        unsigned int group1Size = ecInfo.group1BlockCodewords;
+        unsigned int blockSize = group1Size;
+        unsigned int offset = block * group1Size;
+        if (block >= ecInfo.group1Blocks) {
+            blockSize = ecInfo.group2BlockCodewords;
+            offset = ecInfo.group1Blocks * group1Size + (block - ecInfo.group1Blocks) * blockSize;
+        }
+        // Column `index` of interleaved data holds byte `index` of all blocks,
+        // columns after the size of group 1 blocks only hold group 2 blocks
+        for (unsigned int index = 0; index < blockSize; index += 1) {
+            unsigned int position = index < group1Size ?
+                index * blockCount + block :
+                group1Size * blockCount + (index - group1Size) * ecInfo.group2Blocks + (block - ecInfo.group1Blocks);
+            interleave[position] = encodedData[offset + index];
+        }
+        UnsignedByte errorCorrection[256];
+        Polynomial::getErrorCorrections(&encodedData[offset], blockSize, ecInfo.ecCodewordsPerBlock, errorCorrection);
+        for (unsigned int index = 0; index < ecInfo.ecCodewordsPerBlock; index += 1) {
+            ecInterleave[index * blockCount + block] = errorCorrection[index];
+        }
+    });
 }
 
 // FINALIZE -----------------------------------------------------------------------------------------------------------------------------------------
 
-void QRMatrixEncoder_clean(UnsignedByte* buffer, UnsignedByte** ecBuffer, ErrorCorrectionInfo ecInfo) {
-    for (unsigned int index = 0; index < (ecInfo.group1Blocks + ecInfo.group2Blocks); index += 1) {
-        delete[] ecBuffer[index];
-    }
-    delete[] ecBuffer;
-    delete[] buffer;
+/// Codewords ready to be placed into QR board (buffers are taken from encoder context)
+struct QRMatrixEncoder_Codewords {
+    ErrorCorrectionInfo ecInfo;
+    bool isMicro;
+    UnsignedByte dimension;
+    /// Data codewords (interleaved)
+    UnsignedByte* data;
+    /// Error correction codewords (interleaved)
+    UnsignedByte* errorCorrection;
+    /// Scratch memory (dimension x dimension) to evaluate masks
+    UnsignedByte* maskBuffer;
+};
+
+/// Board of encoded codewords: cells are built in scratch memory of `context` (1 board plane) & packed into the board
+QRMatrixBoard QRMatrixEncoder_board(QRMatrixEncoderContext& context, const QRMatrixEncoder_Codewords& codewords, UnsignedByte maskId) {
+    return QRMatrixBoard(
+        codewords.data, codewords.errorCorrection, codewords.ecInfo,
+        maskId, codewords.isMicro, codewords.maskBuffer,
+        context.take(codewords.dimension * codewords.dimension)
+    );
 }
 
-QRMatrixBoard QRMatrixEncoder_finishEncodingData(
+/// Add terminator & filling bytes after encoded data
+void QRMatrixEncoder_padData(
     UnsignedByte* buffer,
-    ErrorCorrectionInfo ecInfo,
+    ErrorCorrectionInfo& ecInfo,
     unsigned int* bitIndex,
-    UnsignedByte maskId,
-    QRMatrixExtraMode extraMode
+    const QRMatrixExtraMode& extraMode
 ) {
     bool isMicro = (extraMode.mode == EncodingExtraMode::microQr);
     bool isMicroV13 = isMicro && ((ecInfo.version == 1) || ecInfo.version == 3);
@@ -610,20 +827,36 @@ QRMatrixBoard QRMatrixEncoder_finishEncodingData(
         }
     }
     *bitIndex = bufferBitsLen;
+}
 
-    // Error corrections
-    UnsignedByte** ecBuffer = QRMatrixEncoder_generateErrorCorrections(buffer, ecInfo);
-
+/// Interleave padded data & error corrections (`ecInfo.ecCodewordsPerBlock` bytes for each block) if required
+QRMatrixEncoder_Codewords QRMatrixEncoder_finishCodewords(
+    QRMatrixEncoderContext& context,
+    UnsignedByte* buffer,
+    UnsignedByte* ecBuffer,
+    ErrorCorrectionInfo& ecInfo,
+    bool isMicro
+) {
 #if LOGABLE
     LOG(
         "Payload:\n", DevTools::getBin(buffer, ecInfo.codewords).c_str()
     );
 #endif
 
+    QRMatrixEncoder_Codewords result;
+    result.ecInfo = ecInfo;
+    result.isMicro = isMicro;
+    result.dimension = isMicro ?
+        Common::microDimensionByVersion(ecInfo.version) :
+        Common::dimensionByVersion(ecInfo.version);
+    result.maskBuffer = context.take(result.dimension * result.dimension);
+
     // Interleave or not
     if (ecInfo.ecBlockTotalCount() > 1) {
-        UnsignedByte *interleave = QRMatrixEncoder_interleave(buffer, ecInfo);
-        UnsignedByte *ecInterleave = QRMatrixEncoder_interleave(ecBuffer, ecInfo);
+        UnsignedByte *interleave = context.take(ecInfo.codewords);
+        UnsignedByte *ecInterleave = context.take(ecInfo.ecCodewordsTotalCount());
+        QRMatrixEncoder_interleave(buffer, ecInfo, interleave);
+        QRMatrixEncoder_interleaveErrorCorrections(ecBuffer, ecInfo, ecInterleave);
 
 #if LOGABLE
         LOG(
@@ -632,36 +865,56 @@ QRMatrixBoard QRMatrixEncoder_finishEncodingData(
         );
 #endif
 
-        QRMatrixBoard board(interleave, ecInterleave, ecInfo, maskId, isMicro);
-
-        delete[] interleave;
-        delete[] ecInterleave;
-        QRMatrixEncoder_clean(buffer, ecBuffer, ecInfo);
-        return board;
-    } else {
+        result.data = interleave;
+        result.errorCorrection = ecInterleave;
+        return result;
+    }
 #if LOGABLE
     LOG(
-        "EC:\n", DevTools::getBin(ecBuffer[0], ecInfo.ecCodewordsPerBlock).c_str()
+        "EC:\n", DevTools::getBin(ecBuffer, ecInfo.ecCodewordsPerBlock).c_str()
     );
 #endif
-        QRMatrixBoard board(buffer, ecBuffer[0], ecInfo, maskId, isMicro);
-        QRMatrixEncoder_clean(buffer, ecBuffer, ecInfo);
-        return board;
-    }
+    result.data = buffer;
+    result.errorCorrection = ecBuffer;
+    return result;
+}
 
+/// Pad data, generate error corrections & interleave.
+/// With `pool` (of more than 1 worker), blocks are processed in parallel.
+QRMatrixEncoder_Codewords QRMatrixEncoder_finishEncodingData(
+    QRMatrixEncoderContext& context,
+    UnsignedByte* buffer,
+    ErrorCorrectionInfo& ecInfo,
+    unsigned int* bitIndex,
+    const QRMatrixExtraMode& extraMode,
+    QRMatrixThreadPool* pool = nullptr
+) {
+    QRMatrixEncoder_padData(buffer, ecInfo, bitIndex, extraMode);
+    if (pool != nullptr && pool->workerCount() > 1 && ecInfo.ecBlockTotalCount() > 1) {
+        QRMatrixEncoder_Codewords result;
+        result.ecInfo = ecInfo;
+        result.isMicro = extraMode.mode == EncodingExtraMode::microQr;
+        result.dimension = result.isMicro ?
+            Common::microDimensionByVersion(ecInfo.version) :
+            Common::dimensionByVersion(ecInfo.version);
+        result.maskBuffer = context.take(result.dimension * result.dimension);
+        result.data = context.take(ecInfo.codewords);
+        result.errorCorrection = context.take(ecInfo.ecCodewordsTotalCount());
+        QRMatrixEncoder_generateInterleavedErrorCorrections(*pool, buffer, ecInfo, result.data, result.errorCorrection);
+        return result;
+    }
+    // Error corrections
+    UnsignedByte* ecBuffer = context.take(ecInfo.ecCodewordsTotalCount());
+    QRMatrixEncoder_generateErrorCorrections(buffer, ecInfo, ecBuffer);
+    return QRMatrixEncoder_finishCodewords(context, buffer, ecBuffer, ecInfo, extraMode.mode == EncodingExtraMode::microQr);
 }
 
-QRMatrixBoard QRMatrixEncoder_encodeSingle(
+/// Check input before encoding
+QRMatrixStatus QRMatrixEncoder_validate(
     QRMatrixSegment* segments,
     unsigned int count,
-    ErrorCorrectionLevel level,
-    QRMatrixExtraMode extraMode,
-    UnsignedByte minVersion,
-    UnsignedByte maskId,
-    UnsignedByte sequenceIndex,
-    UnsignedByte sequenceTotal,
-    UnsignedByte parity
-) {
+    const QRMatrixExtraMode& extraMode
+) noexcept {
     unsigned int segCount = 0;
     for (unsigned int index = 0; index < count; index += 1) {
         if (segments[index].length() > 0) {
@@ -669,7 +922,7 @@ QRMatrixBoard QRMatrixEncoder_encodeSingle(
         }
     }
     if (segCount == 0) {
-        throw QR_EXCEPTION("No input.");
+        return QRMatrixStatus(EncodingStatus::noInput);
     }
     if (extraMode.mode == EncodingExtraMode::fnc1Second) {
         bool isValid = false;
@@ -690,19 +943,54 @@ QRMatrixBoard QRMatrixEncoder_encodeSingle(
             break;
         }
         if (!isValid) {
-            throw QR_EXCEPTION("Invalid Application Indicator for FNC1 Second Position mode");
+            return QRMatrixStatus(EncodingStatus::invalidApplicationIndicator);
         }
     }
-    bool isStructuredAppend = sequenceTotal > 0 && sequenceTotal <= 16;
-    ErrorCorrectionInfo ecInfo = QRMatrixEncoder_findVersion(segments, count, level, minVersion, extraMode, isStructuredAppend);
-    if (ecInfo.version == 0) {
-        throw QR_EXCEPTION("Unable to find suitable QR version.");
+    return QRMatrixStatus();
+}
+
+/// Check ECI Indicators of segments which require ECI header
+QRMatrixStatus QRMatrixEncoder_validateEci(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    bool isMicro
+) noexcept {
+    if (isMicro) {
+        return QRMatrixStatus();
     }
-    if (isStructuredAppend && extraMode.mode == EncodingExtraMode::microQr) {
-        extraMode = QRMatrixExtraMode();
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixSegment& segment = segments[index];
+        if (segment.length() > 0 && segment.isEciHeaderRequired() && segment.eci() > 999999) {
+            return QRMatrixStatus(EncodingStatus::invalidEciIndicator, index);
+        }
     }
-    // Allocate
-    UnsignedByte* buffer = Common::allocate(ecInfo.codewords);
+    return QRMatrixStatus();
+}
+
+/// Encode data segments into codewords of the version given by `ecInfo`
+/// (`charactersCountBits`: optional number of Characters Count bits of each segment).
+void QRMatrixEncoder_encodeData(
+    QRMatrixEncoderContext& context,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    ErrorCorrectionInfo ecInfo,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte sequenceIndex,
+    UnsignedByte sequenceTotal,
+    UnsignedByte parity,
+    QRMatrixEncoder_Codewords* result,
+    QRMatrixThreadPool* pool = nullptr,
+    const UnsignedByte* charactersCountBits = nullptr
+) {
+    bool isStructuredAppend = sequenceTotal > 0 && sequenceTotal <= 16;
+    bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+    // Scratch memory
+    UnsignedByte dimension = isMicro ?
+        Common::microDimensionByVersion(ecInfo.version) :
+        Common::dimensionByVersion(ecInfo.version);
+    context.reset(QRMatrixEncoderContext::requiredCapacity(ecInfo, dimension));
+    UnsignedByte* buffer = context.take(ecInfo.codewords);
     unsigned int bitIndex = 0;
     // Structured append
     if (isStructuredAppend) {
@@ -719,99 +1007,1662 @@ QRMatrixBoard QRMatrixEncoder_encodeSingle(
     }
     // Encode data
     for (unsigned int index = 0; index < count; index += 1) {
-        QRMatrixEncoder_encodeSegment(buffer, segments[index], index, level, ecInfo, &bitIndex, extraMode);
+        QRMatrixEncoder_encodeSegment(
+            buffer, segments[index], index, level, ecInfo, &bitIndex, extraMode,
+            charactersCountBits != nullptr ? charactersCountBits[index] : 0
+        );
     }
     // Finish
-    return QRMatrixEncoder_finishEncodingData(buffer, ecInfo, &bitIndex, maskId, extraMode);
+    *result = QRMatrixEncoder_finishEncodingData(context, buffer, ecInfo, &bitIndex, extraMode, pool);
 }
 
-// PUBLIC METHODS -----------------------------------------------------------------------------------------------------------------------------------
-
-QRMatrixBoard QRMatrixEncoder::encode(
+/// Encode data segments into codewords
+QRMatrixStatus QRMatrixEncoder_encodeCodewords(
+    QRMatrixEncoderContext& context,
     QRMatrixSegment* segments,
     unsigned int count,
     ErrorCorrectionLevel level,
-    QRMatrixExtraMode extraMode,
+    const QRMatrixExtraMode& originalExtraMode,
     UnsignedByte minVersion,
-    UnsignedByte maskId
+    UnsignedByte sequenceIndex,
+    UnsignedByte sequenceTotal,
+    UnsignedByte parity,
+    QRMatrixEncoder_Codewords* result,
+    QRMatrixThreadPool* pool = nullptr
 ) {
-    return QRMatrixEncoder_encodeSingle(
-        segments, count, level, extraMode, minVersion, maskId, 0, 0, 0
+    QRMatrixStatus status = QRMatrixEncoder_validate(segments, count, originalExtraMode);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    bool isStructuredAppend = sequenceTotal > 0 && sequenceTotal <= 16;
+    ErrorCorrectionInfo ecInfo;
+    status = QRMatrixEncoder_findVersion(segments, count, level, minVersion, originalExtraMode, isStructuredAppend, &ecInfo);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    QRMatrixExtraMode noneMode;
+    bool isNoneMode = isStructuredAppend && originalExtraMode.mode == EncodingExtraMode::microQr;
+    const QRMatrixExtraMode& extraMode = isNoneMode ? noneMode : originalExtraMode;
+    bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+    status = QRMatrixEncoder_validateEci(segments, count, isMicro);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    QRMatrixEncoder_encodeData(
+        context, segments, count, level, ecInfo, extraMode, sequenceIndex, sequenceTotal, parity, result, pool
     );
+    return status;
 }
 
-UnsignedByte QRMatrixEncoder::getVersion(
+/// Throw exception for failed status
+void QRMatrixEncoder_check(QRMatrixStatus status) {
+    if (!status.isSucceeded()) {
+        throw QR_EXCEPTION(status.message());
+    }
+}
+
+QRMatrixBoard QRMatrixEncoder_encodeSingle(
+    QRMatrixEncoderContext& context,
     QRMatrixSegment* segments,
     unsigned int count,
     ErrorCorrectionLevel level,
-    QRMatrixExtraMode extraMode,
-    bool isStructuredAppend
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId,
+    UnsignedByte sequenceIndex,
+    UnsignedByte sequenceTotal,
+    UnsignedByte parity
 ) {
-    unsigned int segCount = 0;
-    for (unsigned int index = 0; index < count; index += 1) {
-        if (segments[index].length() > 0) {
-            segCount += 1;
-        }
-    }
-    if (segCount == 0) {
-        return 0;
-    }
-    try {
-        ErrorCorrectionInfo ecInfo = QRMatrixEncoder_findVersion(segments, count, level, 0, extraMode, isStructuredAppend);
-        if (ecInfo.version == 0) {
-            return 0;
-        }
-        return ecInfo.version;
-    } catch (QRMatrixException exception) {
-        return 0;
-    }
+    QRMatrixEncoder_Codewords codewords;
+    QRMatrixEncoder_check(QRMatrixEncoder_encodeCodewords(
+        context, segments, count, level, extraMode, minVersion, sequenceIndex, sequenceTotal, parity, &codewords
+    ));
+    return QRMatrixEncoder_board(context, codewords, maskId);
 }
 
-QRMatrixBoard* QRMatrixEncoder::encode(
+// STRUCTURED APPEND SPLITTING ----------------------------------------------------------------------------------------------------------------------
+
+/// ECI Assignment value of Shift JIS
+#define QRMATRIXENCODER_SHIFTJIS_ECI 20
+
+/// Data of all segments as 1 sequence of bytes to find split positions
+struct QRMatrixEncoder_Payload {
+    QRMatrixSegment* segments;
+    unsigned int count;
+    ErrorCorrectionLevel level;
+    /// Start position of each segment in sequence (`count + 1` items)
+    unsigned int* offsets;
+    /// Position is between 2 characters (`total + 1` items)
+    bool* boundaries;
+    /// Number of bytes of all segments
+    unsigned int total;
+
+    QRMatrixEncoder_Payload(QRMatrixSegment* segs, unsigned int segCount, ErrorCorrectionLevel ecLevel);
+    ~QRMatrixEncoder_Payload();
+};
+
+/// Mark positions of `segment` (`length + 1` items) which are not inside a character
+void QRMatrixEncoder_markBoundaries(QRMatrixSegment& segment, bool* result) {
+    unsigned int length = segment.length();
+    UnsignedByte* data = segment.data();
+    switch (segment.mode()) {
+    case EncodingMode::numeric:
+    case EncodingMode::alphaNumeric:
+        for (unsigned int index = 0; index < length; index += 1) {
+            result[index] = true;
+        }
+        break;
+    case EncodingMode::kanji:
+        // 2 bytes per character
+        for (unsigned int index = 0; index < length; index += 1) {
+            result[index] = index % 2 == 0;
+        }
+        break;
+    case EncodingMode::byte:
+        if (segment.eci() == QRMATRIXENCODER_SHIFTJIS_ECI) {
+            // Shift JIS: 1 byte character or lead byte (0x81...0x9F, 0xE0...0xFC) + trail byte
+            unsigned int index = 0;
+            while (index < length) {
+                result[index] = true;
+                UnsignedByte value = data[index];
+                bool isLead = (value >= 0x81 && value <= 0x9F) || (value >= 0xE0 && value <= 0xFC);
+                if (isLead && index + 1 < length) {
+                    result[index + 1] = false;
+                    index += 2;
+                } else {
+                    index += 1;
+                }
+            }
+        } else {
+            // UTF-8 (or single byte encoding): do not split before continuation bytes (10xxxxxx)
+            for (unsigned int index = 0; index < length; index += 1) {
+                result[index] = (data[index] & 0xC0) != 0x80;
+            }
+        }
+        break;
+    }
+    result[length] = true;
+}
+
+QRMatrixEncoder_Payload::QRMatrixEncoder_Payload(QRMatrixSegment* segs, unsigned int segCount, ErrorCorrectionLevel ecLevel) {
+    segments = segs;
+    count = segCount;
+    level = ecLevel;
+    offsets = new unsigned int [count + 1];
+    total = 0;
+    for (unsigned int index = 0; index < count; index += 1) {
+        offsets[index] = total;
+        total += segments[index].length();
+    }
+    offsets[count] = total;
+    boundaries = new bool [total + 1];
+    boundaries[0] = true;
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixEncoder_markBoundaries(segments[index], boundaries + offsets[index]);
+    }
+}
+
+QRMatrixEncoder_Payload::~QRMatrixEncoder_Payload() {
+    delete[] offsets;
+    delete[] boundaries;
+}
+
+/// Size of bytes `begin..<end` of payload as 1 Structured Append part
+QRMatrixEncoder_DataSize QRMatrixEncoder_partSize(QRMatrixEncoder_Payload& payload, unsigned int begin, unsigned int end) {
+    QRMatrixEncoder_DataSize result;
+    for (unsigned int index = 0; index < payload.count; index += 1) {
+        unsigned int lower = payload.offsets[index] > begin ? payload.offsets[index] : begin;
+        unsigned int upper = payload.offsets[index + 1] < end ? payload.offsets[index + 1] : end;
+        if (lower >= upper) {
+            continue;
+        }
+        QRMatrixSegment& segment = payload.segments[index];
+        result.add(segment.mode(), upper - lower, segment.isEciHeaderRequired(), segment.eci());
+    }
+    QRMatrixExtraMode noneMode;
+    result.addHeaders(noneMode, true);
+    return result;
+}
+
+/// Bytes `begin..<end` can be encoded as 1 Structured Append part of given version
+bool QRMatrixEncoder_partFits(QRMatrixEncoder_Payload& payload, unsigned int begin, unsigned int end, UnsignedByte version) {
+    QRMatrixEncoder_DataSize size = QRMatrixEncoder_partSize(payload, begin, end);
+    UnsignedByte result = 0;
+    QRMatrixStatus status = QRMatrixEncoder_findVersion(size, payload.level, version, false, &result);
+    return status.isSucceeded() && result == version;
+}
+
+/// Biggest end position of part starting at `begin` with given version (`begin` if nothing fits).
+/// Number of bits increases with number of bytes, so binary search.
+unsigned int QRMatrixEncoder_longestPart(QRMatrixEncoder_Payload& payload, unsigned int begin, UnsignedByte version) {
+    unsigned int lower = begin;
+    unsigned int upper = payload.total;
+    while (lower < upper) {
+        unsigned int middle = lower + (upper - lower + 1) / 2;
+        if (QRMatrixEncoder_partFits(payload, begin, middle, version)) {
+            lower = middle;
+        } else {
+            upper = middle - 1;
+        }
+    }
+    while (lower > begin && !payload.boundaries[lower]) {
+        lower -= 1;
+    }
+    return lower;
+}
+
+/// Number of parts to hold bytes from `begin` with given version, by filling each part as much as possible.
+/// @return `limit + 1` if more than `limit` parts are required.
+unsigned int QRMatrixEncoder_countParts(QRMatrixEncoder_Payload& payload, unsigned int begin, UnsignedByte version, unsigned int limit) {
+    unsigned int result = 0;
+    while (begin < payload.total) {
+        if (result == limit) {
+            return limit + 1;
+        }
+        unsigned int end = QRMatrixEncoder_longestPart(payload, begin, version);
+        if (end == begin) {
+            return limit + 1;
+        }
+        begin = end;
+        result += 1;
+    }
+    return result;
+}
+
+/// End position of next part: close to `1 / partsCount` of remaining data bits,
+/// but the rest must still fit in `partsCount - 1` parts.
+unsigned int QRMatrixEncoder_balancedPart(QRMatrixEncoder_Payload& payload, unsigned int begin, UnsignedByte version, unsigned int partsCount) {
+    unsigned int longest = QRMatrixEncoder_longestPart(payload, begin, version);
+    if (partsCount <= 1 || longest == payload.total) {
+        return longest;
+    }
+    unsigned int target = QRMatrixEncoder_partSize(payload, begin, payload.total).bitsCount / partsCount;
+    // Smallest end reaching target bits
+    unsigned int lower = begin + 1;
+    unsigned int upper = longest;
+    while (lower < upper) {
+        unsigned int middle = lower + (upper - lower) / 2;
+        if (QRMatrixEncoder_partSize(payload, begin, middle).bitsCount >= target) {
+            upper = middle;
+        } else {
+            lower = middle + 1;
+        }
+    }
+    while (lower < longest && !payload.boundaries[lower]) {
+        lower += 1;
+    }
+    if (QRMatrixEncoder_countParts(payload, lower, version, partsCount - 1) > partsCount - 1) {
+        return longest;
+    }
+    return lower;
+}
+
+// FIXED VERSION ------------------------------------------------------------------------------------------------------------------------------------
+
+/// Check version & level of symbols of fixed version
+QRMatrixStatus QRMatrixEncoder_fixedVersionInfo(
+    UnsignedByte version,
+    ErrorCorrectionLevel level,
+    bool isMicro,
+    ErrorCorrectionInfo* result
+) noexcept {
+    if (version < 1 || version > (isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION)) {
+        return QRMatrixStatus(EncodingStatus::invalidVersion);
+    }
+    if (isMicro) {
+        // Level H is not available in MicroQR (M1 has error detection only, its level is not meaningful)
+        if (level == ErrorCorrectionLevel::high || QRMatrixEncoder_capacities().microBits[level][version] == 0) {
+            return QRMatrixStatus(EncodingStatus::levelNotAvailable);
+        }
+        *result = ErrorCorrectionInfo::microErrorCorrectionInfo(version, level);
+    } else {
+        *result = ErrorCorrectionInfo::errorCorrectionInfo(version, level);
+    }
+    return QRMatrixStatus();
+}
+
+/// Check segments to be encoded in given version
+QRMatrixStatus QRMatrixEncoder_validateFixedVersion(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    UnsignedByte version,
+    const QRMatrixExtraMode& extraMode
+) noexcept {
+    QRMatrixStatus status = QRMatrixEncoder_validate(segments, count, extraMode);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, extraMode, false);
+    bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+    UnsignedByte found = 0;
+    status = QRMatrixEncoder_findVersion(size, level, version, isMicro, &found);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    if (found != version) {
+        return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+    }
+    return QRMatrixEncoder_validateEci(segments, count, isMicro);
+}
+
+// SEQUENCE -----------------------------------------------------------------------------------------------------------------------------------------
+
+/// Place all codewords of the first symbol of sequence into `cells`.
+/// @return Number of placed codewords.
+unsigned int QRMatrixEncoder_placeSequence(
+    const QRMatrixLayout& layout,
+    /// Codewords of the symbol (not interleaved)
+    UnsignedByte* buffer,
+    /// Codewords of sequence to write into
+    UnsignedByte* data,
+    /// Error corrections of sequence to write into
+    UnsignedByte* errorCorrection,
+    /// Cells of sequence (final cells if mask of layout is fixed, otherwise unmasked cells)
+    UnsignedByte* cells
+) {
+    ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+    unsigned int ecCount = ecInfo.ecCodewordsTotalCount();
+    bool isMasked = layout.isMaskFixed();
+    memcpy(cells, isMasked ? layout.maskedCells() : layout.cells(), layout.dimension() * layout.dimension());
+    memcpy(data, buffer, ecInfo.codewords);
+    QRMatrixEncoder_generateErrorCorrections(data, ecInfo, errorCorrection);
+    for (unsigned int index = 0; index < ecInfo.codewords; index += 1) {
+        layout.placeCodeword(layout.dataModule(index), data[index], cells, isMasked);
+    }
+    for (unsigned int index = 0; index < ecCount; index += 1) {
+        layout.placeCodeword(layout.errorCorrectionModule(index), errorCorrection[index], cells, isMasked);
+    }
+    return ecInfo.codewords + ecCount;
+}
+
+/// Place codewords which differ from the last symbol of sequence into `cells`.
+/// Reed-Solomon codes are linear: error corrections of new codewords = old error corrections XOR
+/// error corrections of the difference, which is calculated from the first changed codeword of each block.
+/// @return Number of placed codewords.
+unsigned int QRMatrixEncoder_updateSequence(
+    const QRMatrixLayout& layout,
+    /// Codewords of the symbol (not interleaved)
+    UnsignedByte* buffer,
+    /// Codewords of the last symbol to update
+    UnsignedByte* data,
+    /// Error corrections of the last symbol to update
+    UnsignedByte* errorCorrection,
+    /// Cells of the last symbol to update (final cells if mask of layout is fixed, otherwise unmasked cells)
+    UnsignedByte* cells
+) {
+    ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+    bool isMasked = layout.isMaskFixed();
+    unsigned int blockCount = ecInfo.ecBlockTotalCount();
+    unsigned int ecPerBlock = ecInfo.ecCodewordsPerBlock;
+    UnsignedByte delta[256];
+    UnsignedByte ecDelta[256];
+    unsigned int changedCount = 0;
+    unsigned int offset = 0;
+    for (unsigned int block = 0; block < blockCount; block += 1) {
+        unsigned int end = offset + (block < ecInfo.group1Blocks ? ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords);
+        unsigned int first = offset;
+        while (first < end && buffer[first] == data[first]) {
+            first += 1;
+        }
+        offset = end;
+        if (first == end) {
+            continue;
+        }
+        for (unsigned int index = first; index < end; index += 1) {
+            delta[index - first] = buffer[index] ^ data[index];
+            if (delta[index - first] != 0) {
+                data[index] = buffer[index];
+                layout.placeCodeword(layout.dataModule(index), buffer[index], cells, isMasked);
+                changedCount += 1;
+            }
+        }
+        Polynomial::getErrorCorrections(delta, end - first, ecPerBlock, ecDelta);
+        UnsignedByte* blockErrorCorrection = errorCorrection + block * ecPerBlock;
+        for (unsigned int index = 0; index < ecPerBlock; index += 1) {
+            if (ecDelta[index] != 0) {
+                blockErrorCorrection[index] ^= ecDelta[index];
+                layout.placeCodeword(
+                    layout.errorCorrectionModule(block * ecPerBlock + index), blockErrorCorrection[index], cells, isMasked
+                );
+                changedCount += 1;
+            }
+        }
+    }
+    return changedCount;
+}
+
+/// Write final cells of symbol of fixed layout (`dimension * dimension` bytes) of given interleaved codewords.
+/// `maskBuffer` (scratch memory of `dimension * dimension` bytes) is used if the mask is not fixed.
+void QRMatrixEncoder_stampLayout(
+    const QRMatrixLayout& layout,
+    const UnsignedByte* data,
+    const UnsignedByte* errorCorrection,
+    UnsignedByte* cells,
+    UnsignedByte* maskBuffer
+) {
+    if (layout.isMaskFixed()) {
+        layout.stamp(data, errorCorrection, cells);
+        return;
+    }
+    layout.place(data, errorCorrection, cells);
+    UnsignedByte dimension = layout.dimension();
+    UnsignedByte* rows[dimension];
+    for (UnsignedByte row = 0; row < dimension; row += 1) {
+        rows[row] = cells + row * dimension;
+    }
+    ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+    QRMatrixBoard::finish(rows, dimension, ecInfo, layout.maskId(), layout.isMicro(), maskBuffer);
+}
+
+/// Check input of a symbol of fixed layout
+QRMatrixStatus QRMatrixEncoder_validateLayout(
+    const QRMatrixLayout& layout,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    const QRMatrixExtraMode& extraMode
+) noexcept {
+    if (!layout.isValid()) {
+        return QRMatrixStatus(EncodingStatus::invalidObject);
+    }
+    bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+    if (isMicro != layout.isMicro()) {
+        return QRMatrixStatus(EncodingStatus::invalidVersion);
+    }
+    ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+    return QRMatrixEncoder_validateFixedVersion(segments, count, ecInfo.level, ecInfo.version, extraMode);
+}
+
+/// Encode single QR symbol of fixed layout into `board`: codewords bits are stamped on precomputed cells
+QRMatrixStatus QRMatrixEncoder_encodeLayout(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    const QRMatrixLayout& layout,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    const QRMatrixExtraMode& extraMode
+) {
+    QRMatrixStatus status = QRMatrixEncoder_validateLayout(layout, segments, count, extraMode);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    bool isMicro = layout.isMicro();
+    ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+    UnsignedByte dimension = layout.dimension();
+    context.reset(QRMatrixEncoderContext::requiredCapacity(ecInfo, dimension));
+    UnsignedByte* buffer = context.take(ecInfo.codewords);
+    unsigned int bitIndex = 0;
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixEncoder_encodeSegment(buffer, segments[index], index, ecInfo.level, ecInfo, &bitIndex, extraMode);
+    }
+    QRMatrixEncoder_Codewords codewords = QRMatrixEncoder_finishEncodingData(context, buffer, ecInfo, &bitIndex, extraMode);
+    UnsignedByte* cells = context.take(dimension * dimension);
+    QRMatrixEncoder_stampLayout(layout, codewords.data, codewords.errorCorrection, cells, codewords.maskBuffer);
+    board = QRMatrixBoard(cells, ecInfo, isMicro);
+    return status;
+}
+
+// LANES --------------------------------------------------------------------------------------------------------------------------------------------
+
+/// Generate Error correction bytes of `lanes` (up to `POLYNOMIAL_LANES`) symbols of the same version & level at once.
+/// Each block is copied into `dataLanes` (byte `index` of symbol `lane` at `index * POLYNOMIAL_LANES + lane`),
+/// so all symbols go through the Reed-Solomon division together.
+void QRMatrixEncoder_generateErrorCorrectionsLanes(
+    /// Bytes from previous (encode data) step of each symbol
+    UnsignedByte** encodedData,
+    /// Number of symbols
+    unsigned int lanes,
+    /// EC Info of all symbols
+    ErrorCorrectionInfo& ecInfo,
+    /// Scratch memory of (largest block size * `POLYNOMIAL_LANES`) bytes
+    UnsignedByte* dataLanes,
+    /// Scratch memory of (`ecInfo.ecCodewordsPerBlock` * `POLYNOMIAL_LANES`) bytes
+    UnsignedByte* ecLanes,
+    /// Buffers to write result of each symbol into (same layout as `QRMatrixEncoder_generateErrorCorrections`)
+    UnsignedByte** results
+) {
+    unsigned int blockCount = ecInfo.ecBlockTotalCount();
+    unsigned int ecPerBlock = ecInfo.ecCodewordsPerBlock;
+    unsigned int offset = 0;
+    for (unsigned int block = 0; block < blockCount; block += 1) {
+        unsigned int blockSize = block < ecInfo.group1Blocks ? ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords;
+        for (unsigned int index = 0; index < blockSize; index += 1) {
+            for (unsigned int lane = 0; lane < lanes; lane += 1) {
+                dataLanes[index * POLYNOMIAL_LANES + lane] = encodedData[lane][offset + index];
+            }
+        }
+        Polynomial::getErrorCorrectionsLanes(dataLanes, blockSize, ecPerBlock, ecLanes);
+        for (unsigned int index = 0; index < ecPerBlock; index += 1) {
+            for (unsigned int lane = 0; lane < lanes; lane += 1) {
+                results[lane][block * ecPerBlock + index] = ecLanes[index * POLYNOMIAL_LANES + lane];
+            }
+        }
+        offset += blockSize;
+    }
+}
+
+/// Encode up to `POLYNOMIAL_LANES` items of fixed layout into `boards` (error corrections of all items are calculated together).
+/// @return Number of succeeded items.
+unsigned int QRMatrixEncoder_encodeLayoutLanes(
+    QRMatrixEncoderContext& context,
+    const QRMatrixLayout& layout,
+    QRMatrixBatchItem* items,
+    unsigned int count,
+    QRMatrixBoard* boards,
+    QRMatrixStatus* statuses
+) noexcept {
+    try {
+        ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+        UnsignedByte dimension = layout.dimension();
+        unsigned int ecCount = ecInfo.ecCodewordsTotalCount();
+        unsigned int blockSize = ecInfo.group1BlockCodewords > ecInfo.group2BlockCodewords ?
+            ecInfo.group1BlockCodewords : ecInfo.group2BlockCodewords;
+        // Codewords of each lane, lanes buffers of 1 block, interleaved codewords, mask evaluation plane & cells plane (shared by lanes)
+        context.reset(
+            (ecInfo.codewords + ecCount) * POLYNOMIAL_LANES + (blockSize + ecInfo.ecCodewordsPerBlock) * POLYNOMIAL_LANES +
+            ecInfo.codewords + ecCount + dimension * dimension * 2
+        );
+        UnsignedByte* buffers[POLYNOMIAL_LANES];
+        UnsignedByte* ecBuffers[POLYNOMIAL_LANES];
+        unsigned int itemIndexes[POLYNOMIAL_LANES];
+        unsigned int lanes = 0;
+        for (unsigned int index = 0; index < count && index < POLYNOMIAL_LANES; index += 1) {
+            QRMatrixBatchItem& item = items[index];
+            statuses[index] = QRMatrixEncoder_validateLayout(layout, item.segments, item.count, item.extraMode);
+            if (!statuses[index].isSucceeded()) {
+                continue;
+            }
+            UnsignedByte* buffer = context.take(ecInfo.codewords);
+            unsigned int bitIndex = 0;
+            for (unsigned int jndex = 0; jndex < item.count; jndex += 1) {
+                QRMatrixEncoder_encodeSegment(buffer, item.segments[jndex], jndex, ecInfo.level, ecInfo, &bitIndex, item.extraMode);
+            }
+            QRMatrixEncoder_padData(buffer, ecInfo, &bitIndex, item.extraMode);
+            buffers[lanes] = buffer;
+            ecBuffers[lanes] = context.take(ecCount);
+            itemIndexes[lanes] = index;
+            lanes += 1;
+        }
+        if (lanes == 0) {
+            return 0;
+        }
+        UnsignedByte* dataLanes = context.take(blockSize * POLYNOMIAL_LANES);
+        UnsignedByte* ecLanes = context.take(ecInfo.ecCodewordsPerBlock * POLYNOMIAL_LANES);
+        QRMatrixEncoder_generateErrorCorrectionsLanes(buffers, lanes, ecInfo, dataLanes, ecLanes, ecBuffers);
+
+        bool isInterleaved = ecInfo.ecBlockTotalCount() > 1;
+        UnsignedByte* interleave = isInterleaved ? context.take(ecInfo.codewords) : nullptr;
+        UnsignedByte* ecInterleave = isInterleaved ? context.take(ecCount) : nullptr;
+        UnsignedByte* maskBuffer = layout.isMaskFixed() ? nullptr : context.take(dimension * dimension);
+        UnsignedByte* cells = context.take(dimension * dimension);
+        for (unsigned int lane = 0; lane < lanes; lane += 1) {
+            UnsignedByte* data = buffers[lane];
+            UnsignedByte* errorCorrection = ecBuffers[lane];
+            if (isInterleaved) {
+                QRMatrixEncoder_interleave(data, ecInfo, interleave);
+                QRMatrixEncoder_interleaveErrorCorrections(errorCorrection, ecInfo, ecInterleave);
+                data = interleave;
+                errorCorrection = ecInterleave;
+            }
+            QRMatrixEncoder_stampLayout(layout, data, errorCorrection, cells, maskBuffer);
+            boards[itemIndexes[lane]] = QRMatrixBoard(cells, ecInfo, layout.isMicro());
+        }
+        return lanes;
+    } catch (...) {
+        for (unsigned int index = 0; index < count && index < POLYNOMIAL_LANES; index += 1) {
+            statuses[index] = QRMatrixStatus(EncodingStatus::internalError);
+        }
+        return 0;
+    }
+}
+
+// PREFIX TEMPLATE ----------------------------------------------------------------------------------------------------------------------------------
+
+/// Check tail segments of prefix template: ECI indicators & remaining capacity
+QRMatrixStatus QRMatrixEncoder_validateTail(
+    const QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count
+) noexcept {
+    bool isMicro = prefix.isMicro();
+    QRMatrixStatus status = QRMatrixEncoder_validateEci(segments, count, isMicro);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, QRMatrixExtraMode(), false);
+    const QRMatrixEncoder_Capacities& capacities = QRMatrixEncoder_capacities();
+    const UnsignedByte* charactersCountBits = isMicro ?
+        capacities.microCharactersCountBits[prefix.version()] :
+        capacities.charactersCountBits[prefix.version()];
+    if (isMicro) {
+        // Mode is not available with this MicroQR version
+        for (unsigned int index = 0; index < 4; index += 1) {
+            if (size.modeCounts[index] > 0 && charactersCountBits[index] == 0) {
+                return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+            }
+        }
+    }
+    if (prefix.bitsCount() + size.bitsCount + size.charactersCountBitsCount(charactersCountBits) > prefix.capacity()) {
+        return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+    }
+    return status;
+}
+
+/// Encode tail segments after encoded prefix into codewords.
+/// Only codewords from the first one which is not fully filled by prefix are added to error corrections.
+void QRMatrixEncoder_encodeTail(
+    QRMatrixEncoderContext& context,
+    const QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    QRMatrixEncoder_Codewords* result
+) {
+    ErrorCorrectionInfo ecInfo = prefix.errorCorrectionInfo();
+    unsigned int ecCount = ecInfo.ecCodewordsTotalCount();
+    context.reset(QRMatrixEncoderContext::requiredCapacity(ecInfo, prefix.dimension()));
+    UnsignedByte* buffer = context.take(ecInfo.codewords);
+    unsigned int bitIndex = prefix.bitsCount();
+    memcpy(buffer, prefix.data(), (bitIndex + 7) / 8);
+    for (unsigned int index = 0; index < count; index += 1) {
+        QRMatrixEncoder_encodeSegment(
+            buffer, segments[index], prefix.count() + index, ecInfo.level, ecInfo, &bitIndex, prefix.extraMode()
+        );
+    }
+    QRMatrixEncoder_padData(buffer, ecInfo, &bitIndex, prefix.extraMode());
+    UnsignedByte* ecBuffer = context.take(ecCount);
+    memcpy(ecBuffer, prefix.errorCorrectionStates(), ecCount);
+    QRMatrixEncoder_continueErrorCorrections(buffer, ecInfo, prefix.bitsCount() / 8, ecInfo.codewords, ecBuffer);
+    *result = QRMatrixEncoder_finishCodewords(context, buffer, ecBuffer, ecInfo, prefix.isMicro());
+}
+
+// PUBLIC METHODS -----------------------------------------------------------------------------------------------------------------------------------
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    QRMatrixExtraMode extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    QRMatrixEncoderContext context(0);
+    return QRMatrixEncoder_encodeSingle(
+        context, segments, count, level, extraMode, minVersion, maskId, 0, 0, 0
+    );
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    return QRMatrixEncoder_encodeSingle(
+        context, segments, count, level, extraMode, minVersion, maskId, 0, 0, 0
+    );
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    QRMatrixThreadPool& pool,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    QRMatrixBoard board;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, pool, board, segments, count, level, extraMode, minVersion, maskId));
+    return board;
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixCache& cache,
+    QRMatrixEncoderContext& context,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    QRMatrixBoard board;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(cache, context, board, segments, count, level, extraMode, minVersion, maskId));
+    return board;
+}
+
+QRMatrixCompactSymbol QRMatrixEncoder::encodeCompact(
+    QRMatrixEncoderContext& context,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    QRMatrixCompactSymbol symbol;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, symbol, segments, count, level, extraMode, minVersion, maskId));
+    return symbol;
+}
+
+int QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    UnsignedByte* output,
+    unsigned int stride,
+    unsigned int capacity,
+    BoardFormat format,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    UnsignedByte dimension = 0;
+    QRMatrixStatus status = QRMatrixEncoder::tryEncode(
+        context, output, stride, capacity, format, &dimension,
+        segments, count, level, extraMode, minVersion, maskId
+    );
+    switch (status.code) {
+    case EncodingStatus::succeeded:
+        return dimension;
+    case EncodingStatus::invalidStride:
+        return QR_OUTPUT_INVALID_STRIDE;
+    case EncodingStatus::insufficientCapacity:
+        return QR_OUTPUT_INSUFFICIENT_CAPACITY;
+    default:
+        break;
+    }
+    QRMatrixEncoder_check(status);
+    return 0;
+}
+
+UnsignedByte QRMatrixEncoder::getVersion(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend
+) {
+    UnsignedByte version = 0;
+    QRMatrixEncoder::tryGetVersion(&version, segments, count, level, extraMode, isStructuredAppend);
+    return version;
+}
+
+/// XOR of `length` bytes of `data`, 8 bytes at a time
+UnsignedByte QRMatrixEncoder_xor(const UnsignedByte* data, unsigned int length) {
+    Unsigned8Bytes word = 0;
+    unsigned int index = 0;
+    for (; index + 8 <= length; index += 8) {
+        Unsigned8Bytes value;
+        memcpy(&value, data + index, 8);
+        word ^= value;
+    }
+    // XOR of all bytes of `word` (byte order does not matter)
+    word ^= word >> 32;
+    word ^= word >> 16;
+    word ^= word >> 8;
+    UnsignedByte result = word & 0xFF;
+    for (; index < length; index += 1) {
+        result ^= data[index];
+    }
+    return result;
+}
+
+/// XOR of all data bytes of all parts
+UnsignedByte QRMatrixEncoder_structuredAppendParity(QRMatrixStructuredAppend* parts, unsigned int count) {
+    UnsignedByte parity = 0;
+    for (UnsignedByte index = 0; index < count; index += 1) {
+        QRMatrixStructuredAppend& part = parts[index];
+        for (unsigned int segIndex = 0; segIndex < part.count; segIndex += 1) {
+            QRMatrixSegment& segment = part.segments[segIndex];
+            parity ^= QRMatrixEncoder_xor(segment.data(), segment.length());
+        }
+    }
+    return parity;
+}
+
+/// Encode 1 part of Structured Append into `board`
+QRMatrixStatus QRMatrixEncoder_encodePart(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    QRMatrixStructuredAppend& part,
+    UnsignedByte index,
+    UnsignedByte count,
+    UnsignedByte parity
+) {
+    QRMatrixEncoder_Codewords codewords;
+    QRMatrixStatus status = QRMatrixEncoder_encodeCodewords(
+        context, part.segments, part.count,
+        part.level, part.extraMode, part.minVersion,
+        index, count, parity, &codewords
+    );
+    if (!status.isSucceeded()) {
+        status.partIndex = index;
+        return status;
+    }
+    board = QRMatrixEncoder_board(context, codewords, part.maskId);
+    return status;
+}
+
+/// Check number of Structured Append parts
+QRMatrixStatus QRMatrixEncoder_validateParts(unsigned int count) noexcept {
+    if (count > 16) {
+        return QRMatrixStatus(EncodingStatus::tooManyParts);
+    }
+    if (count == 0) {
+        return QRMatrixStatus(EncodingStatus::noInput);
+    }
+    return QRMatrixStatus();
+}
+
+QRMatrixBoard* QRMatrixEncoder::encode(
     /// Array of data parts to be encoded
     QRMatrixStructuredAppend* parts,
     /// Number of parts
     unsigned int count
 ) {
-    if (count > 16) {
-        throw QR_EXCEPTION("Structured Append only accepts 16 parts maximum");
+    QRMatrixEncoder_check(QRMatrixEncoder_validateParts(count));
+//    if (count == 1) {
+        // Should change to encode single QR symbol or throw error?
+        // But no rule prevents to make a Structured Append QR symbol single part
+//    }
+    QRMatrixBoard* result = new QRMatrixBoard [count];
+    QRMatrixStatus status = QRMatrixEncoder::tryEncode(result, parts, count);
+    if (!status.isSucceeded()) {
+        delete[] result;
+        QRMatrixEncoder_check(status);
+    }
+    return result;
+}
+
+QRMatrixBoard* QRMatrixEncoder::encode(
+    QRMatrixThreadPool& pool,
+    QRMatrixStructuredAppend* parts,
+    unsigned int count
+) {
+    QRMatrixEncoder_check(QRMatrixEncoder_validateParts(count));
+    QRMatrixBoard* result = new QRMatrixBoard [count];
+    QRMatrixStatus status = QRMatrixEncoder::tryEncode(pool, result, parts, count);
+    if (!status.isSucceeded()) {
+        delete[] result;
+        QRMatrixEncoder_check(status);
+    }
+    return result;
+}
+
+QRMatrixBoard* QRMatrixEncoder::encodeStructuredAppend(
+    QRMatrixThreadPool& pool,
+    unsigned int* partsCount,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    UnsignedByte maxVersion
+) {
+    QRMatrixStructuredAppend parts[16];
+    QRMatrixEncoder_check(QRMatrixEncoder::trySplit(parts, partsCount, segments, count, level, maxVersion));
+    return QRMatrixEncoder::encode(pool, parts, *partsCount);
+}
+
+QRMatrixEncodePlan QRMatrixEncoder::prepare(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) {
+    QRMatrixEncodePlan plan;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryPrepare(plan, segments, count, level, extraMode, minVersion, maskId));
+    return plan;
+}
+
+QRMatrixPrefixTemplate QRMatrixEncoder::preparePrefix(
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    UnsignedByte version,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte maskId
+) {
+    QRMatrixPrefixTemplate prefix;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryPreparePrefix(prefix, segments, count, level, version, extraMode, maskId));
+    return prefix;
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    const QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count
+) {
+    QRMatrixEncoderContext context(0);
+    return QRMatrixEncoder::encode(context, prefix, segments, count);
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    const QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count
+) {
+    QRMatrixBoard board;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, board, prefix, segments, count));
+    return board;
+}
+
+QRMatrixLayout QRMatrixEncoder::prepareLayout(
+    UnsignedByte version,
+    ErrorCorrectionLevel level,
+    bool isMicro,
+    UnsignedByte maskId
+) {
+    QRMatrixLayout layout;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryPrepareLayout(layout, version, level, isMicro, maskId));
+    return layout;
+}
+
+QRMatrixSequence QRMatrixEncoder::prepareSequence(
+    UnsignedByte version,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte maskId
+) {
+    QRMatrixSequence sequence;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryPrepareSequence(sequence, version, level, extraMode, maskId));
+    return sequence;
+}
+
+QRMatrixBoard& QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    QRMatrixSequence& sequence,
+    QRMatrixSegment* segments,
+    unsigned int count
+) {
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, sequence, segments, count));
+    return sequence.board();
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(
+    QRMatrixEncoderContext& context,
+    const QRMatrixLayout& layout,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    const QRMatrixExtraMode& extraMode
+) {
+    QRMatrixBoard board;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, board, layout, segments, count, extraMode));
+    return board;
+}
+
+unsigned int QRMatrixEncoder::encodeBatch(
+    QRMatrixThreadPool& pool,
+    const QRMatrixLayout& layout,
+    QRMatrixBatchItem* items,
+    unsigned int count,
+    QRMatrixBoard* boards,
+    QRMatrixStatus* statuses
+) {
+    // 1 task for each `POLYNOMIAL_LANES` items
+    std::atomic<unsigned int> succeeded(0);
+    unsigned int taskCount = (count + POLYNOMIAL_LANES - 1) / POLYNOMIAL_LANES;
+    pool.run(taskCount, [&pool, &layout, items, count, boards, statuses, &succeeded](unsigned int worker, unsigned int index) {
+        unsigned int first = index * POLYNOMIAL_LANES;
+        succeeded += QRMatrixEncoder_encodeLayoutLanes(
+            pool.context(worker), layout, &items[first], count - first, &boards[first], &statuses[first]
+        );
+    });
+    return succeeded;
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(const QRMatrixEncodePlan& plan) {
+    QRMatrixEncoderContext context(0);
+    return QRMatrixEncoder::encode(context, plan);
+}
+
+QRMatrixBoard QRMatrixEncoder::encode(QRMatrixEncoderContext& context, const QRMatrixEncodePlan& plan) {
+    QRMatrixBoard board;
+    QRMatrixEncoder_check(QRMatrixEncoder::tryEncode(context, board, plan));
+    return board;
+}
+
+unsigned int QRMatrixEncoder::encodeBatch(
+    QRMatrixThreadPool& pool,
+    QRMatrixBatchItem* items,
+    unsigned int count,
+    QRMatrixBoard* boards,
+    QRMatrixStatus* statuses
+) {
+    std::atomic<unsigned int> succeeded(0);
+    pool.run(count, [&pool, items, boards, statuses, &succeeded](unsigned int worker, unsigned int index) {
+        QRMatrixBatchItem& item = items[index];
+        statuses[index] = QRMatrixEncoder::tryEncode(
+            pool.context(worker), boards[index],
+            item.segments, item.count, item.level, item.extraMode, item.minVersion, item.maskId
+        );
+        if (statuses[index].isSucceeded()) {
+            succeeded += 1;
+        }
+    });
+    return succeeded;
+}
+
+unsigned int QRMatrixEncoder::encodeBatch(
+    QRMatrixBatchItem* items,
+    unsigned int count,
+    QRMatrixBoard* boards,
+    QRMatrixStatus* statuses,
+    unsigned int threadCount
+) {
+    QRMatrixThreadPool pool(threadCount);
+    return QRMatrixEncoder::encodeBatch(pool, items, count, boards, statuses);
+}
+
+// EXCEPTION-FREE METHODS ---------------------------------------------------------------------------------------------------------------------------
+
+QRMatrixStatus QRMatrixEncoder::tryGetVersion(
+    UnsignedByte* version,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend
+) noexcept {
+    try {
+        *version = 0;
+        QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, extraMode, isStructuredAppend);
+        if (size.isEmpty()) {
+            return QRMatrixStatus(EncodingStatus::noInput);
+        }
+        bool isMicro = (extraMode.mode == EncodingExtraMode::microQr && !isStructuredAppend);
+        return QRMatrixEncoder_findVersion(size, level, 0, isMicro, version);
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
     }
-    if (count == 0) {
-        throw QR_EXCEPTION("No input.");
+}
+
+bool QRMatrixEncoder::fits(
+    UnsignedByte version,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend
+) noexcept {
+    bool isMicro = (extraMode.mode == EncodingExtraMode::microQr && !isStructuredAppend);
+    if (version < 1 || version > (isMicro ? MICROQR_MAX_VERSION : QR_MAX_VERSION)) {
+        return false;
     }
-//    if (count == 1) {
-        // Should change to encode single QR symbol or throw error?
-        // But no rule prevents to make a Structured Append QR symbol single part
-//    }
-    UnsignedByte parity = 0;
-    for (UnsignedByte index = 0; index < count; index += 1) {
-        QRMatrixStructuredAppend part = parts[index];
-        for (unsigned int segIndex = 0; segIndex < part.count; segIndex += 1) {
-            QRMatrixSegment segment = part.segments[segIndex];
-            for (unsigned int idx = 0; idx < segment.length(); idx += 1) {
-                if (index == 0 && segIndex == 0 && idx == 0) {
-                    parity = segment.data()[idx];
-                } else {
-                    parity = parity ^ segment.data()[idx];
-                }
+    QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, extraMode, isStructuredAppend);
+    if (size.isEmpty()) {
+        return false;
+    }
+    UnsignedByte result = 0;
+    QRMatrixStatus status = QRMatrixEncoder_findVersion(size, level, version, isMicro, &result);
+    return status.isSucceeded() && result == version;
+}
+
+UnsignedByte QRMatrixEncoder::predictVersion(
+    const EncodingMode* modes,
+    const unsigned int* lengths,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    bool isStructuredAppend
+) noexcept {
+    QRMatrixEncoder_DataSize size;
+    for (unsigned int index = 0; index < count; index += 1) {
+        size.add(modes[index], lengths[index], false, defaultEciAssigmentValue);
+    }
+    if (size.isEmpty()) {
+        return 0;
+    }
+    size.addHeaders(extraMode, isStructuredAppend);
+    bool isMicro = (extraMode.mode == EncodingExtraMode::microQr && !isStructuredAppend);
+    UnsignedByte version = 0;
+    QRMatrixEncoder_findVersion(size, level, 0, isMicro, &version);
+    return version;
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixStatus status = QRMatrixEncoder_encodeCodewords(
+            context, segments, count, level, extraMode, minVersion, 0, 0, 0, &codewords
+        );
+        if (status.isSucceeded()) {
+            board = QRMatrixEncoder_board(context, codewords, maskId);
+        }
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixThreadPool& pool,
+    QRMatrixBoard& board,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixStatus status = QRMatrixEncoder_encodeCodewords(
+            context, segments, count, level, extraMode, minVersion, 0, 0, 0, &codewords, &pool
+        );
+        if (status.isSucceeded()) {
+            board = QRMatrixEncoder_board(context, codewords, maskId);
+        }
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixCache& cache,
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        return cache.fetch(
+            segments, count, level, extraMode, minVersion, maskId, board,
+            [&context, segments, count, level, &extraMode, minVersion, maskId](QRMatrixCompactSymbol& symbol) {
+                return QRMatrixEncoder::tryEncode(context, symbol, segments, count, level, extraMode, minVersion, maskId);
+            }
+        );
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixCompactSymbol& symbol,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixStatus status = QRMatrixEncoder_encodeCodewords(
+            context, segments, count, level, extraMode, minVersion, 0, 0, 0, &codewords
+        );
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte appliedMaskId = maskId;
+        if (maskId >= (codewords.isMicro ? 4 : 8)) {
+            // Evaluate masks on unmasked cells made in scratch memory
+            UnsignedByte dimension = codewords.dimension;
+            const QRMatrixLayout& layout = QRMatrixCompactSymbol::sharedLayout(codewords.ecInfo, codewords.isMicro, 0xFF);
+            UnsignedByte* cells = context.take(dimension * dimension);
+            layout.place(codewords.data, codewords.errorCorrection, cells);
+            UnsignedByte* rows[dimension];
+            for (unsigned int row = 0; row < dimension; row += 1) {
+                rows[row] = &cells[row * dimension];
             }
+            appliedMaskId = QRMatrixBoard::finish(rows, dimension, codewords.ecInfo, maskId, codewords.isMicro, codewords.maskBuffer);
         }
+        symbol = QRMatrixCompactSymbol(
+            codewords.ecInfo, codewords.isMicro, appliedMaskId, codewords.data, codewords.errorCorrection
+        );
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
     }
-    QRMatrixBoard* result = new QRMatrixBoard [count];
-    for (UnsignedByte index = 0; index < count; index += 1) {
-        QRMatrixStructuredAppend part = parts[index];
-        try {
-            result[index] = QRMatrixEncoder_encodeSingle(
-                part.segments, part.count,
-                part.level, part.extraMode,
-                part.minVersion, part.maskId,
-                index, count, parity
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    UnsignedByte* output,
+    unsigned int stride,
+    unsigned int capacity,
+    BoardFormat format,
+    UnsignedByte* dimension,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        *dimension = 0;
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixStatus status = QRMatrixEncoder_encodeCodewords(
+            context, segments, count, level, extraMode, minVersion, 0, 0, 0, &codewords
+        );
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte size = codewords.dimension;
+        unsigned int rowLength = format == BoardFormat::packedBits ? (size + 7) / 8 : size;
+        if (stride < rowLength) {
+            return QRMatrixStatus(EncodingStatus::invalidStride);
+        }
+        if (capacity < stride * (size - 1) + rowLength) {
+            return QRMatrixStatus(EncodingStatus::insufficientCapacity);
+        }
+        UnsignedByte* rows[size];
+        if (format == BoardFormat::packedBits) {
+            // Build cells in scratch memory then pack them into output
+            UnsignedByte* cells = context.take(size * size);
+            for (UnsignedByte row = 0; row < size; row += 1) {
+                rows[row] = cells + row * size;
+            }
+        } else {
+            for (UnsignedByte row = 0; row < size; row += 1) {
+                rows[row] = output + row * stride;
+            }
+        }
+        QRMatrixBoard::build(
+            rows, size,
+            codewords.data, codewords.errorCorrection, codewords.ecInfo,
+            maskId, codewords.isMicro, codewords.maskBuffer
+        );
+        if (format == BoardFormat::packedBits) {
+            QRMatrixBoard::pack(rows, size, output, stride);
+        }
+        *dimension = size;
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryPrepare(
+    QRMatrixEncodePlan& plan,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte minVersion,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        QRMatrixStatus status = QRMatrixEncoder_validate(segments, count, extraMode);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(segments, count, extraMode, false);
+        bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+        UnsignedByte version = 0;
+        status = QRMatrixEncoder_findVersion(size, level, minVersion, isMicro, &version);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        status = QRMatrixEncoder_validateEci(segments, count, isMicro);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        const QRMatrixEncoder_Capacities& capacities = QRMatrixEncoder_capacities();
+        const UnsignedByte* charactersCountBits = isMicro ?
+            capacities.microCharactersCountBits[version] :
+            capacities.charactersCountBits[version];
+        QRMatrixEncodePlan result;
+        result.segments_ = new QRMatrixSegment [count];
+        result.charactersCountBits_ = new UnsignedByte [count];
+        result.count_ = count;
+        for (unsigned int index = 0; index < count; index += 1) {
+            result.segments_[index] = segments[index];
+            result.charactersCountBits_[index] = charactersCountBits[QRMatrixEncoder_modeIndex(segments[index].mode())];
+        }
+        result.extraMode_ = extraMode;
+        result.maskId_ = maskId;
+        result.ecInfo_ = isMicro ?
+            ErrorCorrectionInfo::microErrorCorrectionInfo(version, level) :
+            ErrorCorrectionInfo::errorCorrectionInfo(version, level);
+        result.dimension_ = isMicro ? Common::microDimensionByVersion(version) : Common::dimensionByVersion(version);
+        result.bitsCount_ = size.bitsCount + size.charactersCountBitsCount(charactersCountBits);
+        plan = std::move(result);
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    const QRMatrixEncodePlan& plan
+) noexcept {
+    try {
+        if (!plan.isValid()) {
+            return QRMatrixStatus(EncodingStatus::invalidObject);
+        }
+        // Segments of plan may have been changed via `segments()`: data must still take the planned bits
+        QRMatrixEncoder_DataSize size = QRMatrixEncoder_dataSize(plan.segments(), plan.count(), plan.extraMode(), false);
+        unsigned int bitsCount = size.bitsCount;
+        for (unsigned int index = 0; index < plan.count(); index += 1) {
+            if (plan.segments()[index].length() > 0) {
+                bitsCount += plan.charactersCountBits()[index];
+            }
+        }
+        if (bitsCount != plan.bitsCount() || bitsCount > plan.capacity()) {
+            return QRMatrixStatus(EncodingStatus::invalidObject);
+        }
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixEncoder_encodeData(
+            context, plan.segments(), plan.count(), plan.level(), plan.errorCorrectionInfo(), plan.extraMode(), 0, 0, 0, &codewords,
+            nullptr, plan.charactersCountBits()
+        );
+        board = QRMatrixEncoder_board(context, codewords, plan.maskId());
+        return QRMatrixStatus();
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryPreparePrefix(
+    QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    UnsignedByte version,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        bool isMicro = extraMode.mode == EncodingExtraMode::microQr;
+        ErrorCorrectionInfo ecInfo;
+        QRMatrixStatus status = QRMatrixEncoder_fixedVersionInfo(version, level, isMicro, &ecInfo);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        status = QRMatrixEncoder_validateFixedVersion(segments, count, level, version, extraMode);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte buffer[ecInfo.codewords];
+        for (unsigned int index = 0; index < ecInfo.codewords; index += 1) {
+            buffer[index] = 0;
+        }
+        unsigned int bitIndex = 0;
+        for (unsigned int index = 0; index < count; index += 1) {
+            QRMatrixEncoder_encodeSegment(buffer, segments[index], index, level, ecInfo, &bitIndex, extraMode);
+        }
+        prefix = QRMatrixPrefixTemplate();
+        prefix.count_ = count;
+        prefix.extraMode_ = extraMode;
+        prefix.maskId_ = maskId;
+        prefix.dimension_ = isMicro ? Common::microDimensionByVersion(version) : Common::dimensionByVersion(version);
+        prefix.ecInfo_ = ecInfo;
+        prefix.bitsCount_ = bitIndex;
+        prefix.data_ = Common::allocate((bitIndex + 7) / 8);
+        memcpy(prefix.data_, buffer, (bitIndex + 7) / 8);
+        // Remainders of codewords fully filled by prefix
+        prefix.ecStates_ = Common::allocate(ecInfo.ecCodewordsTotalCount());
+        QRMatrixEncoder_continueErrorCorrections(buffer, ecInfo, 0, bitIndex / 8, prefix.ecStates_);
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    const QRMatrixPrefixTemplate& prefix,
+    QRMatrixSegment* segments,
+    unsigned int count
+) noexcept {
+    try {
+        if (!prefix.isValid()) {
+            return QRMatrixStatus(EncodingStatus::invalidObject);
+        }
+        QRMatrixStatus status = QRMatrixEncoder_validateTail(prefix, segments, count);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        QRMatrixEncoder_Codewords codewords;
+        QRMatrixEncoder_encodeTail(context, prefix, segments, count, &codewords);
+        board = QRMatrixEncoder_board(context, codewords, prefix.maskId());
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryPrepareLayout(
+    QRMatrixLayout& layout,
+    UnsignedByte version,
+    ErrorCorrectionLevel level,
+    bool isMicro,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        ErrorCorrectionInfo ecInfo;
+        QRMatrixStatus status = QRMatrixEncoder_fixedVersionInfo(version, level, isMicro, &ecInfo);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        if (maskId != 0xFF && maskId >= (isMicro ? 4 : 8)) {
+            return QRMatrixStatus(EncodingStatus::invalidMask);
+        }
+        layout = QRMatrixLayout(ecInfo, isMicro, maskId);
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixBoard& board,
+    const QRMatrixLayout& layout,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    const QRMatrixExtraMode& extraMode
+) noexcept {
+    try {
+        return QRMatrixEncoder_encodeLayout(context, board, layout, segments, count, extraMode);
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryPrepareSequence(
+    QRMatrixSequence& sequence,
+    UnsignedByte version,
+    ErrorCorrectionLevel level,
+    const QRMatrixExtraMode& extraMode,
+    UnsignedByte maskId
+) noexcept {
+    try {
+        QRMatrixLayout layout;
+        QRMatrixStatus status = QRMatrixEncoder::tryPrepareLayout(
+            layout, version, level, extraMode.mode == EncodingExtraMode::microQr, maskId
+        );
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+        UnsignedByte dimension = layout.dimension();
+        sequence = QRMatrixSequence();
+        sequence.layout_ = layout;
+        sequence.extraMode_ = extraMode;
+        sequence.board_ = QRMatrixBoard(dimension);
+        sequence.data_ = Common::allocate(ecInfo.codewords);
+        sequence.errorCorrection_ = Common::allocate(ecInfo.ecCodewordsTotalCount());
+        sequence.cells_ = Common::allocate(dimension * dimension);
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixEncoderContext& context,
+    QRMatrixSequence& sequence,
+    QRMatrixSegment* segments,
+    unsigned int count
+) noexcept {
+    try {
+        if (!sequence.isValid()) {
+            return QRMatrixStatus(EncodingStatus::invalidObject);
+        }
+        const QRMatrixLayout& layout = sequence.layout();
+        ErrorCorrectionInfo ecInfo = layout.errorCorrectionInfo();
+        QRMatrixStatus status = QRMatrixEncoder_validateFixedVersion(
+            segments, count, ecInfo.level, ecInfo.version, sequence.extraMode()
+        );
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte dimension = layout.dimension();
+        context.reset(QRMatrixEncoderContext::requiredCapacity(ecInfo, dimension));
+        UnsignedByte* buffer = context.take(ecInfo.codewords);
+        unsigned int bitIndex = 0;
+        for (unsigned int index = 0; index < count; index += 1) {
+            QRMatrixEncoder_encodeSegment(buffer, segments[index], index, ecInfo.level, ecInfo, &bitIndex, sequence.extraMode());
+        }
+        QRMatrixEncoder_padData(buffer, ecInfo, &bitIndex, sequence.extraMode());
+        // With fixed mask, cells of board are patched directly
+        QRMatrixBoard& board = sequence.board();
+        UnsignedByte* cells = layout.isMaskFixed() ? board.buffer()[0] : sequence.cells_;
+        board.invalidatePacked();
+        if (sequence.isPlaced_) {
+            sequence.changedCount_ = QRMatrixEncoder_updateSequence(
+                layout, buffer, sequence.data_, sequence.errorCorrection_, cells
             );
-        } catch (QRMatrixException exception) {
-            delete[] result;
-            throw exception;
-            return nullptr;
+        } else {
+            sequence.changedCount_ = QRMatrixEncoder_placeSequence(
+                layout, buffer, sequence.data_, sequence.errorCorrection_, cells
+            );
+            sequence.isPlaced_ = true;
         }
+        if (layout.isMaskFixed()) {
+            sequence.maskId_ = layout.maskId();
+            return status;
+        }
+        // Mask & format
+        memcpy(board.buffer()[0], sequence.cells_, dimension * dimension);
+        sequence.maskId_ = QRMatrixBoard::finish(
+            board.buffer(), dimension, ecInfo, layout.maskId(), layout.isMicro(), context.take(dimension * dimension)
+        );
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::trySplit(
+    QRMatrixStructuredAppend* parts,
+    unsigned int* partsCount,
+    QRMatrixSegment* segments,
+    unsigned int count,
+    ErrorCorrectionLevel level,
+    UnsignedByte maxVersion
+) noexcept {
+    try {
+        *partsCount = 0;
+        QRMatrixExtraMode noneMode;
+        QRMatrixStatus status = QRMatrixEncoder_validate(segments, count, noneMode);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        if (maxVersion < 1 || maxVersion > QR_MAX_VERSION) {
+            return QRMatrixStatus(EncodingStatus::invalidVersion);
+        }
+        QRMatrixEncoder_Payload payload(segments, count, level);
+        if (payload.total == 0) {
+            return QRMatrixStatus(EncodingStatus::noInput);
+        }
+        // Minimum number of parts: fill parts of biggest version
+        unsigned int partsNeeded = QRMatrixEncoder_countParts(payload, 0, maxVersion, 16);
+        if (partsNeeded > 16) {
+            if (QRMatrixEncoder_longestPart(payload, 0, maxVersion) == 0) {
+                return QRMatrixStatus(EncodingStatus::dataOverCapacity);
+            }
+            return QRMatrixStatus(EncodingStatus::tooManyParts);
+        }
+        // Smallest version to hold data in that number of parts
+        UnsignedByte version = 1;
+        while (version < maxVersion && QRMatrixEncoder_countParts(payload, 0, version, partsNeeded) > partsNeeded) {
+            version += 1;
+        }
+        // Split evenly
+        QRMatrixSegment* pieces = new QRMatrixSegment [count];
+        unsigned int begin = 0;
+        unsigned int partIndex = 0;
+        // Catch failures here to release `pieces`
+        try {
+            while (begin < payload.total && partIndex < partsNeeded) {
+                unsigned int end = QRMatrixEncoder_balancedPart(payload, begin, version, partsNeeded - partIndex);
+                unsigned int piecesCount = 0;
+                for (unsigned int index = 0; index < count && status.isSucceeded(); index += 1) {
+                    unsigned int lower = payload.offsets[index] > begin ? payload.offsets[index] : begin;
+                    unsigned int upper = payload.offsets[index + 1] < end ? payload.offsets[index + 1] : end;
+                    if (lower >= upper) {
+                        continue;
+                    }
+                    QRMatrixSegment& segment = segments[index];
+                    status = pieces[piecesCount].tryFill(
+                        segment.mode(), segment.data() + (lower - payload.offsets[index]), upper - lower, segment.eci()
+                    );
+                    if (!status.isSucceeded()) {
+                        status.segmentIndex = index;
+                    }
+                    piecesCount += 1;
+                }
+                if (!status.isSucceeded()) {
+                    break;
+                }
+                parts[partIndex] = QRMatrixStructuredAppend(pieces, piecesCount, level);
+                parts[partIndex].minVersion = version;
+                partIndex += 1;
+                begin = end;
+            }
+        } catch (...) {
+            status = QRMatrixStatus(EncodingStatus::internalError);
+        }
+        delete[] pieces;
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        *partsCount = partIndex;
+        return QRMatrixStatus();
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixBoard* boards,
+    QRMatrixStructuredAppend* parts,
+    unsigned int count
+) noexcept {
+    try {
+        QRMatrixStatus status = QRMatrixEncoder_validateParts(count);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte parity = QRMatrixEncoder_structuredAppendParity(parts, count);
+        QRMatrixEncoderContext context(0);
+        for (UnsignedByte index = 0; index < count; index += 1) {
+            status = QRMatrixEncoder_encodePart(context, boards[index], parts[index], index, count, parity);
+            if (!status.isSucceeded()) {
+                return status;
+            }
+        }
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+}
+
+QRMatrixStatus QRMatrixEncoder::tryEncode(
+    QRMatrixThreadPool& pool,
+    QRMatrixBoard* boards,
+    QRMatrixStructuredAppend* parts,
+    unsigned int count
+) noexcept {
+    try {
+        QRMatrixStatus status = QRMatrixEncoder_validateParts(count);
+        if (!status.isSucceeded()) {
+            return status;
+        }
+        UnsignedByte parity = QRMatrixEncoder_structuredAppendParity(parts, count);
+        // Parts are independent once parity is known
+        QRMatrixStatus statuses[16];
+        pool.run(count, [&pool, boards, parts, count, parity, &statuses](unsigned int worker, unsigned int index) {
+            statuses[index] = QRMatrixEncoder_encodePart(pool.context(worker), boards[index], parts[index], index, count, parity);
+        });
+        // Report the first failed part, same as encoding serially
+        for (unsigned int index = 0; index < count; index += 1) {
+            if (!statuses[index].isSucceeded()) {
+                return statuses[index];
+            }
+        }
+        return status;
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
     }
-    return result;
 }
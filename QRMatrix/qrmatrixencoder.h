@@ -28,6 +28,20 @@
 #include "Exception/qrmatrixexception.h"
 #include "qrmatrixsegment.h"
 #include "qrmatrixextramode.h"
+#include "qrmatrixencodercontext.h"
+#include "qrmatrixstatus.h"
+#include "qrmatrixencodeplan.h"
+#include "qrmatrixprefixtemplate.h"
+#include "qrmatrixlayout.h"
+#include "qrmatrixsequence.h"
+#include "qrmatrixthreadpool.h"
+#include "qrmatrixcache.h"
+#include "qrmatrixcompactsymbol.h"
+
+/// `QRMatrixEncoder::encode` into buffer: stride is smaller than a row of given format
+#define QR_OUTPUT_INVALID_STRIDE        -1
+/// `QRMatrixEncoder::encode` into buffer: capacity is not enough for all rows
+#define QR_OUTPUT_INSUFFICIENT_CAPACITY -2
 
 namespace QRMatrix {
 
@@ -44,7 +58,7 @@ namespace QRMatrix {
             /// Error correction info
             ErrorCorrectionLevel level,
             /// Extra mode
-            QRMatrixExtraMode extraMode = QRMatrixExtraMode(),
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
             /// Is this symbol a part of Structured Append
             bool isStructuredAppend = false
         );
@@ -67,6 +81,126 @@ namespace QRMatrix {
             UnsignedByte maskId = 0xFF
         );
 
+        /// Encode single QR symbol using scratch memory of given context.
+        /// After the context has grown to fit the symbol size (warm-up),
+        /// the returned board is the only memory allocated by this function.
+        static QRMatrixBoard encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol, error correction blocks are calculated in parallel on workers of given pool
+        /// and written directly into their interleaved positions.
+        /// This reduces the latency of large symbols (version 30-40 at level Q/H have 40-81 blocks) on many cores;
+        /// small symbols (few blocks) are faster with `encode(context, ...)`.
+        static QRMatrixBoard encode(
+            /// Scratch memory to reuse between encodings (must not be a context of `pool`)
+            QRMatrixEncoderContext& context,
+            /// Workers for error correction blocks
+            QRMatrixThreadPool& pool,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol, or copy the result of the same input from `cache` (see `QRMatrixCache`).
+        static QRMatrixBoard encode(
+            /// Results of previous encodings (shared by threads)
+            QRMatrixCache& cache,
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol into compact form (version, level, mask & codewords only, see `QRMatrixCompactSymbol`).
+        static QRMatrixCompactSymbol encodeCompact(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol directly into caller's buffer (no `QRMatrixBoard` is created).
+        /// After the context has grown to fit the symbol size (warm-up), this function does not allocate memory.
+        /// @return Dimension of QR symbol (> 0),
+        /// or `QR_OUTPUT_INVALID_STRIDE`, `QR_OUTPUT_INSUFFICIENT_CAPACITY` (nothing is written into `output`).
+        static int encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Buffer to write QR cells into: row `r` starts at `output + r * stride`
+            UnsignedByte* output,
+            /// Number of bytes between 2 rows
+            unsigned int stride,
+            /// Size of `output` in bytes
+            unsigned int capacity,
+            /// Layout of cells in each row
+            BoardFormat format,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
         /// Encode Structured Append QR symbols
         /// @return Array of QRMatrixBoard (should be deleted when done).
         static QRMatrixBoard* encode(
@@ -76,6 +210,565 @@ namespace QRMatrix {
             unsigned int count
         );
 
+        /// Encode Structured Append QR symbols in parallel on workers of given pool
+        /// @return Array of QRMatrixBoard (should be deleted when done).
+        static QRMatrixBoard* encode(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Array of data parts to be encoded
+            QRMatrixStructuredAppend* parts,
+            /// Number of parts
+            unsigned int count
+        );
+
+        /// Split segments into the minimum number of Structured Append parts (see `trySplit`)
+        /// and encode them in parallel on workers of given pool.
+        /// @return Array of `partsCount` QRMatrixBoard (should be deleted when done).
+        static QRMatrixBoard* encodeStructuredAppend(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Result number of parts
+            unsigned int* partsCount,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Maximum version of each part (1...40)
+            UnsignedByte maxVersion = QR_MAX_VERSION
+        );
+
+        /// Find QR version & properties for given segments without encoding.
+        /// Returned plan can be encoded later by `encode(plan)` without analysing segments again
+        /// (plan keeps a copy of segments, so given segments can be released).
+        static QRMatrixEncodePlan prepare(
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol from result of `prepare`
+        static QRMatrixBoard encode(
+            /// Result of `prepare`
+            const QRMatrixEncodePlan& plan
+        );
+
+        /// Encode single QR symbol from result of `prepare` using scratch memory of given context
+        static QRMatrixBoard encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result of `prepare`
+            const QRMatrixEncodePlan& plan
+        );
+
+        /// Encode fixed leading segments (eg. URL prefix) once for symbols of given version & level.
+        /// Symbols sharing this prefix are encoded later by `encode(prefix, segments, count)`
+        /// with only their variable tail segments.
+        static QRMatrixPrefixTemplate preparePrefix(
+            /// Array of prefix segments
+            QRMatrixSegment* segments,
+            /// Number of prefix segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// QR Version of all symbols (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Force to use given mask (0-7).
+            /// Almost for test, you can ignore this.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol of prefix template followed by given tail segments
+        static QRMatrixBoard encode(
+            /// Result of `preparePrefix`
+            const QRMatrixPrefixTemplate& prefix,
+            /// Array of tail segments
+            QRMatrixSegment* segments,
+            /// Number of tail segments
+            unsigned int count
+        );
+
+        /// Encode single QR symbol of prefix template followed by given tail segments using scratch memory of given context.
+        /// Only codewords after the prefix are encoded & added to error corrections.
+        static QRMatrixBoard encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result of `preparePrefix`
+            const QRMatrixPrefixTemplate& prefix,
+            /// Array of tail segments
+            QRMatrixSegment* segments,
+            /// Number of tail segments
+            unsigned int count
+        );
+
+        /// Precompute codewords placement of symbols of given version & level.
+        static QRMatrixLayout prepareLayout(
+            /// QR Version (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Is MicroQR
+            bool isMicro = false,
+            /// Optional. Force all symbols to use given mask (0-7, or 0-3 for MicroQR)
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode single QR symbol of fixed layout: version, level (and mask if fixed) are given by `layout`.
+        /// If mask is fixed, codewords bits are stamped on precomputed cells (no function patterns, masking,
+        /// format or version placement for each symbol).
+        static QRMatrixBoard encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result of `prepareLayout`
+            const QRMatrixLayout& layout,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Extra mode (must be MicroQR if layout is MicroQR)
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode()
+        );
+
+        /// Encode many QR symbols of fixed layout on workers of given pool (see `encode(context, layout, ...)`).
+        /// `level`, `minVersion` & `maskId` of items are ignored (given by `layout`).
+        /// Items are encoded by groups of `POLYNOMIAL_LANES`: all symbols of a group have the same blocks,
+        /// so their error corrections are calculated together (1 symbol per vector lane).
+        /// This function does not throw exception for invalid input: check `statuses`.
+        /// @return Number of succeeded symbols.
+        static unsigned int encodeBatch(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Result of `prepareLayout`
+            const QRMatrixLayout& layout,
+            /// Array of inputs
+            QRMatrixBatchItem* items,
+            /// Number of items
+            unsigned int count,
+            /// Array of `count` boards to write result into
+            QRMatrixBoard* boards,
+            /// Array of `count` status of each item
+            QRMatrixStatus* statuses
+        );
+
+        /// Create state to encode a sequence of similar symbols (eg. serial numbers) of given version & level.
+        /// See `QRMatrixSequence`.
+        static QRMatrixSequence prepareSequence(
+            /// QR Version of all symbols (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Force all symbols to use given mask (0-7, or 0-3 for MicroQR):
+            /// masks are not evaluated for each symbol.
+            UnsignedByte maskId = 0xFF
+        );
+
+        /// Encode next symbol of sequence: only codewords which differ from the previous symbol are placed again.
+        /// @return `sequence.board()`, updated in place (copy it to keep the symbol after the next encoding).
+        static QRMatrixBoard& encode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result of `prepareSequence`
+            QRMatrixSequence& sequence,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count
+        );
+
+        /// Encode many QR symbols on workers of given pool.
+        /// Results are written in the same order of `items`.
+        /// This function does not throw exception for invalid input: check `statuses`.
+        /// @return Number of succeeded symbols.
+        static unsigned int encodeBatch(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Array of inputs
+            QRMatrixBatchItem* items,
+            /// Number of items
+            unsigned int count,
+            /// Array of `count` boards to write result into
+            QRMatrixBoard* boards,
+            /// Array of `count` status of each item
+            QRMatrixStatus* statuses
+        );
+
+        /// Encode many QR symbols on a temporary pool of given number of threads (0 for number of CPU cores).
+        /// Prefer the function with `QRMatrixThreadPool` to encode many batches.
+        static unsigned int encodeBatch(
+            /// Array of inputs
+            QRMatrixBatchItem* items,
+            /// Number of items
+            unsigned int count,
+            /// Array of `count` boards to write result into
+            QRMatrixBoard* boards,
+            /// Array of `count` status of each item
+            QRMatrixStatus* statuses,
+            /// Number of threads
+            unsigned int threadCount = 0
+        );
+
+        // Exception-free functions ---------------------------------------------------------------------------
+        // Same as above functions but return status instead of throwing `QRMatrixException` for invalid input.
+        // Unexpected failures (eg. memory allocation) are reported as `internalError`.
+
+        /// Get QR Version (dimension) to encode given data.
+        static QRMatrixStatus tryGetVersion(
+            /// Result version (0 if failed)
+            UnsignedByte* version,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Is this symbol a part of Structured Append
+            bool isStructuredAppend = false
+        ) noexcept;
+
+        /// Check if given data can be encoded in given QR version
+        /// (ie. `version` is the result of `getVersion` when minimum version is `version`).
+        /// This does not encode data, it only looks up capacity tables.
+        static bool fits(
+            /// QR Version to check (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Is this symbol a part of Structured Append
+            bool isStructuredAppend = false
+        ) noexcept;
+
+        /// Predict QR Version (same as `getVersion`) from modes & lengths of segments,
+        /// so data is not required to be copied into `QRMatrixSegment` (segments are considered as no ECI header).
+        /// Data is not validated.
+        /// @return 0 if data is too big or empty.
+        static UnsignedByte predictVersion(
+            /// Encoding mode of each segment
+            const EncodingMode* modes,
+            /// Length in bytes of each segment
+            const unsigned int* lengths,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Is this symbol a part of Structured Append
+            bool isStructuredAppend = false
+        ) noexcept;
+
+        /// Encode single QR symbol into `board` (`board` is not changed if failed).
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixBoard& board,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol into `board` (`board` is not changed if failed),
+        /// error correction blocks are calculated in parallel on workers of given pool.
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (must not be a context of `pool`)
+            QRMatrixEncoderContext& context,
+            /// Workers for error correction blocks
+            QRMatrixThreadPool& pool,
+            /// Result
+            QRMatrixBoard& board,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol into `board` (`board` is not changed if failed),
+        /// or copy the result of the same input from `cache`. Failed inputs are not cached.
+        static QRMatrixStatus tryEncode(
+            /// Results of previous encodings (shared by threads)
+            QRMatrixCache& cache,
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixBoard& board,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol into compact form (`symbol` is not changed if failed).
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixCompactSymbol& symbol,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            /// (result version = max(minimum version, required version to fit data).
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol directly into caller's buffer (nothing is written if failed).
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Buffer to write QR cells into: row `r` starts at `output + r * stride`
+            UnsignedByte* output,
+            /// Number of bytes between 2 rows
+            unsigned int stride,
+            /// Size of `output` in bytes
+            unsigned int capacity,
+            /// Layout of cells in each row
+            BoardFormat format,
+            /// Result dimension of QR symbol (0 if failed)
+            UnsignedByte* dimension,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Find QR version & properties for given segments without encoding (`plan` is not changed if failed).
+        static QRMatrixStatus tryPrepare(
+            /// Result
+            QRMatrixEncodePlan& plan,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Limit minimum version
+            UnsignedByte minVersion = 0,
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol from result of `prepare` into `board`.
+        /// Status is `invalidObject` if plan is not valid or if its segments do not take the planned bits anymore.
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixBoard& board,
+            /// Result of `prepare`
+            const QRMatrixEncodePlan& plan
+        ) noexcept;
+
+        /// Encode fixed leading segments once for symbols of given version & level (`prefix` is not changed if failed).
+        /// Status is `invalidVersion` for invalid version, `dataOverCapacity` if prefix does not fit given version.
+        static QRMatrixStatus tryPreparePrefix(
+            /// Result
+            QRMatrixPrefixTemplate& prefix,
+            /// Array of prefix segments
+            QRMatrixSegment* segments,
+            /// Number of prefix segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// QR Version of all symbols (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Force to use given mask (0-7).
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol of prefix template followed by given tail segments into `board`.
+        /// Status is `invalidObject` if template is not valid, `dataOverCapacity` if tail does not fit the remaining capacity.
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixBoard& board,
+            /// Result of `preparePrefix`
+            const QRMatrixPrefixTemplate& prefix,
+            /// Array of tail segments
+            QRMatrixSegment* segments,
+            /// Number of tail segments
+            unsigned int count
+        ) noexcept;
+
+        /// Precompute codewords placement of symbols of given version & level (`layout` is not changed if failed).
+        /// Status is `invalidVersion` or `levelNotAvailable` (MicroQR) for invalid version & level,
+        /// `invalidMask` for a mask out of range (other than 0xFF).
+        static QRMatrixStatus tryPrepareLayout(
+            /// Result
+            QRMatrixLayout& layout,
+            /// QR Version (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Is MicroQR
+            bool isMicro = false,
+            /// Optional. Force all symbols to use given mask (0-7, or 0-3 for MicroQR; 0xFF for the best mask of each symbol)
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode single QR symbol of fixed layout into `board` (`board` is not changed if failed).
+        /// Status is `invalidObject` if layout is not valid, `invalidVersion` if MicroQR mode of `extraMode` & `layout` differ,
+        /// `dataOverCapacity` if data does not fit the version of layout.
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result
+            QRMatrixBoard& board,
+            /// Result of `prepareLayout`
+            const QRMatrixLayout& layout,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Extra mode (must be MicroQR if layout is MicroQR)
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode()
+        ) noexcept;
+
+        /// Create state to encode a sequence of similar symbols of given version & level
+        /// (`sequence` is not changed if failed).
+        static QRMatrixStatus tryPrepareSequence(
+            /// Result
+            QRMatrixSequence& sequence,
+            /// QR Version of all symbols (1...40, or 1...4 for MicroQR)
+            UnsignedByte version,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Extra mode
+            const QRMatrixExtraMode& extraMode = QRMatrixExtraMode(),
+            /// Optional. Force all symbols to use given mask (0-7, or 0-3 for MicroQR)
+            UnsignedByte maskId = 0xFF
+        ) noexcept;
+
+        /// Encode next symbol of sequence into `sequence.board()` (`sequence` is not changed if failed).
+        /// Status is `invalidObject` if sequence is not valid, `dataOverCapacity` if data does not fit the version of sequence.
+        static QRMatrixStatus tryEncode(
+            /// Scratch memory to reuse between encodings (1 context per thread)
+            QRMatrixEncoderContext& context,
+            /// Result of `prepareSequence`
+            QRMatrixSequence& sequence,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count
+        ) noexcept;
+
+        /// Split segments into the minimum number of Structured Append parts (16 maximum) of version ≤ `maxVersion`.
+        /// Parts are balanced by number of data bits and all of them have the smallest possible version
+        /// (`minVersion` of each part).
+        /// Characters are not splitted: Kanji segments are splitted at even bytes;
+        /// Byte segments are splitted between Shift JIS characters if their ECI is Shift JIS (20),
+        /// otherwise between UTF-8 characters.
+        /// Status is `tooManyParts` if data requires more than 16 parts, `invalidVersion` if `maxVersion` is not in 1...40,
+        /// `noInput` if all segments are empty.
+        static QRMatrixStatus trySplit(
+            /// Array of 16 parts to write result into
+            QRMatrixStructuredAppend* parts,
+            /// Result number of parts
+            unsigned int* partsCount,
+            /// Array of segments to be encoded
+            QRMatrixSegment* segments,
+            /// Number of segments
+            unsigned int count,
+            /// Error correction info
+            ErrorCorrectionLevel level,
+            /// Maximum version of each part (1...40)
+            UnsignedByte maxVersion = QR_MAX_VERSION
+        ) noexcept;
+
+        /// Encode Structured Append QR symbols into `boards`.
+        /// `partIndex` of result is the index of failed part.
+        static QRMatrixStatus tryEncode(
+            /// Array of `count` boards to write result into
+            QRMatrixBoard* boards,
+            /// Array of data parts to be encoded
+            QRMatrixStructuredAppend* parts,
+            /// Number of parts
+            unsigned int count
+        ) noexcept;
+
+        /// Encode Structured Append QR symbols into `boards` in parallel on workers of given pool.
+        /// `partIndex` of result is the index of the first failed part.
+        static QRMatrixStatus tryEncode(
+            /// Workers
+            QRMatrixThreadPool& pool,
+            /// Array of `count` boards to write result into
+            QRMatrixBoard* boards,
+            /// Array of data parts to be encoded
+            QRMatrixStructuredAppend* parts,
+            /// Number of parts
+            unsigned int count
+        ) noexcept;
+
     };
 
 }
@@ -0,0 +1,79 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixencodercontext.h"
+#include "common.h"
+#include "Exception/qrmatrixexception.h"
+
+using namespace QRMatrix;
+
+QRMatrixEncoderContext::~QRMatrixEncoderContext() {
+    if (arena_ != nullptr) {
+        delete[] arena_;
+    }
+}
+
+QRMatrixEncoderContext::QRMatrixEncoderContext(unsigned int capacity) {
+    arena_ = nullptr;
+    capacity_ = 0;
+    offset_ = 0;
+    allocationCount_ = 0;
+    reset(capacity);
+}
+
+QRMatrixEncoderContext::QRMatrixEncoderContext(): QRMatrixEncoderContext(0) {
+    // Version 40 has the most codewords & the biggest dimension for all EC levels
+    ErrorCorrectionInfo ecInfo = ErrorCorrectionInfo::errorCorrectionInfo(QR_MAX_VERSION, ErrorCorrectionLevel::high);
+    reset(requiredCapacity(ecInfo, Common::dimensionByVersion(QR_MAX_VERSION)));
+}
+
+unsigned int QRMatrixEncoderContext::requiredCapacity(const ErrorCorrectionInfo &ecInfo, UnsignedByte dimension) {
+    unsigned int ecCount = (ecInfo.group1Blocks + ecInfo.group2Blocks) * ecInfo.ecCodewordsPerBlock;
+    // Data & EC codewords, their interleaved copies,
+    // 1 board plane for mask evaluation, 1 board plane for packing cells into bits.
+    return (ecInfo.codewords + ecCount) * 2 + dimension * dimension * 2;
+}
+
+void QRMatrixEncoderContext::reset(unsigned int size) {
+    offset_ = 0;
+    if (size <= capacity_) {
+        return;
+    }
+    if (arena_ != nullptr) {
+        delete[] arena_;
+    }
+    arena_ = new UnsignedByte [size];
+    capacity_ = size;
+    allocationCount_ += 1;
+}
+
+UnsignedByte* QRMatrixEncoderContext::take(unsigned int count) {
+    if (count > capacity_ - offset_) {
+        throw QR_EXCEPTION("Internal error: encoder context scratch memory is not enough");
+    }
+    UnsignedByte* result = arena_ + offset_;
+    offset_ += count;
+    for (unsigned int index = 0; index < count; index += 1) {
+        result[index] = 0;
+    }
+    return result;
+}
@@ -0,0 +1,81 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXENCODERCONTEXT_H
+#define QRMATRIXENCODERCONTEXT_H
+
+#include "constants.h"
+
+namespace QRMatrix {
+
+    /// Internal data model
+    struct ErrorCorrectionInfo;
+
+    /// Scratch memory for `QRMatrixEncoder`.
+    /// Keep one context per thread and pass it to `QRMatrixEncoder::encode`
+    /// to reuse the intermediate buffers (codewords, error corrections, interleave, mask evaluation)
+    /// between encodings instead of allocating them again for each symbol.
+    /// A context must not be used by 2 encodings at the same time.
+    class QRMatrixEncoderContext {
+    public:
+        ~QRMatrixEncoderContext();
+        /// Create context with scratch memory sized for the largest QR symbol (version 40),
+        /// so encoding through this context never allocates scratch memory.
+        QRMatrixEncoderContext();
+        /// Create context with given scratch memory size in bytes.
+        /// Scratch memory grows on demand (pass 0 to allocate at the first encoding).
+        QRMatrixEncoderContext(unsigned int capacity);
+
+        /// Scratch memory size in bytes.
+        inline unsigned int capacity() { return capacity_; }
+        /// Number of times scratch memory has been allocated.
+        /// This number stops increasing once the context has grown to fit the largest symbol in use.
+        inline unsigned int allocationCount() { return allocationCount_; }
+
+        /// Number of scratch bytes required to encode a symbol of given version properties.
+        static unsigned int requiredCapacity(
+            /// EC Info of the symbol
+            const ErrorCorrectionInfo &ecInfo,
+            /// Dimension of the symbol
+            UnsignedByte dimension
+        );
+
+        /// Internal purpose.
+        /// Release all buffers taken from scratch memory and make sure it has at least `size` bytes.
+        void reset(unsigned int size);
+        /// Internal purpose.
+        /// Take `count` bytes (set to 0) from scratch memory. Throw exception if scratch memory is not enough.
+        UnsignedByte* take(unsigned int count);
+    private:
+        UnsignedByte* arena_;
+        unsigned int capacity_;
+        unsigned int offset_;
+        unsigned int allocationCount_;
+
+        // Not copyable
+        QRMatrixEncoderContext(QRMatrixEncoderContext &other);
+        void operator=(QRMatrixEncoderContext other);
+    };
+
+}
+
+#endif // QRMATRIXENCODERCONTEXT_H
@@ -51,24 +51,30 @@ QRMatrixExtraMode::QRMatrixExtraMode(UnsignedByte* appId, UnsignedByte appIdLen)
     }
 }
 
-QRMatrixExtraMode::QRMatrixExtraMode(QRMatrixExtraMode &other) {
+QRMatrixExtraMode::QRMatrixExtraMode(const QRMatrixExtraMode &other) {
     mode = other.mode;
     appIndicatorLength = other.appIndicatorLength;
-    appIndicator = new UnsignedByte [appIndicatorLength];
-    for (unsigned int index = 0; index < appIndicatorLength; index += 1) {
-        appIndicator[index] = other.appIndicator[index];
+    appIndicator = nullptr;
+    if (appIndicatorLength > 0) {
+        appIndicator = new UnsignedByte [appIndicatorLength];
+        for (unsigned int index = 0; index < appIndicatorLength; index += 1) {
+            appIndicator[index] = other.appIndicator[index];
+        }
     }
 }
 
 void QRMatrixExtraMode::operator=(QRMatrixExtraMode other) {
     if (appIndicator != nullptr) {
-        delete appIndicator;
+        delete[] appIndicator;
+        appIndicator = nullptr;
     }
     mode = other.mode;
     appIndicatorLength = other.appIndicatorLength;
-    appIndicator = new UnsignedByte [appIndicatorLength];
-    for (unsigned int index = 0; index < appIndicatorLength; index += 1) {
-        appIndicator[index] = other.appIndicator[index];
+    if (appIndicatorLength > 0) {
+        appIndicator = new UnsignedByte [appIndicatorLength];
+        for (unsigned int index = 0; index < appIndicatorLength; index += 1) {
+            appIndicator[index] = other.appIndicator[index];
+        }
     }
 }
 
@@ -121,3 +127,19 @@ void QRMatrixStructuredAppend::operator=(QRMatrixStructuredAppend other) {
     maskId = other.maskId;
     extraMode = other.extraMode;
 }
+
+QRMatrixBatchItem::QRMatrixBatchItem(QRMatrixSegment* segs, unsigned int segCount, ErrorCorrectionLevel ecLevel) {
+    segments = segs;
+    count = segCount;
+    level = ecLevel;
+    minVersion = 0;
+    maskId = 0xFF;
+}
+
+QRMatrixBatchItem::QRMatrixBatchItem() {
+    segments = nullptr;
+    count = 0;
+    level = ErrorCorrectionLevel::low;
+    minVersion = 0;
+    maskId = 0xFF;
+}
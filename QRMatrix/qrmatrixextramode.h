@@ -50,7 +50,7 @@ namespace QRMatrix {
         UnsignedByte appIndicatorLength;
 
         ~QRMatrixExtraMode();
-        QRMatrixExtraMode(QRMatrixExtraMode &other);
+        QRMatrixExtraMode(const QRMatrixExtraMode &other);
         void operator=(QRMatrixExtraMode other);
         /// Default init, none
         QRMatrixExtraMode();
@@ -84,6 +84,28 @@ namespace QRMatrix {
         void operator=(QRMatrixStructuredAppend other);
     };
 
+    /// Input of 1 QR symbol for `QRMatrixEncoder::encodeBatch`.
+    /// Unlike `QRMatrixStructuredAppend`, segments are not copied.
+    struct QRMatrixBatchItem {
+        /// Data segments
+        QRMatrixSegment* segments;
+        /// Count of segments
+        unsigned int count;
+        /// Error correction info
+        ErrorCorrectionLevel level;
+        /// Optional. Limit minimum version
+        /// (result version = max(minimum version, required version to fit data).
+        UnsignedByte minVersion;
+        /// Optional. Force to use given mask (0-7).
+        /// Almost for test, you can ignore this.
+        UnsignedByte maskId;
+        /// Extra mode
+        QRMatrixExtraMode extraMode;
+
+        QRMatrixBatchItem(QRMatrixSegment* segs, unsigned int segCount, ErrorCorrectionLevel ecLevel);
+        QRMatrixBatchItem();
+    };
+
 }
 
 #endif // QRMATRIXEXTRAMODE_H
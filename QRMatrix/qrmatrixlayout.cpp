@@ -0,0 +1,235 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixlayout.h"
+#include "qrmatrixboard.h"
+#include <cstring>
+
+using namespace QRMatrix;
+
+QRMatrixLayout::~QRMatrixLayout() {
+    if (positions_ != nullptr) {
+        delete[] positions_;
+    }
+    if (cells_ != nullptr) {
+        delete[] cells_;
+    }
+    if (maskedCells_ != nullptr) {
+        delete[] maskedCells_;
+    }
+}
+
+QRMatrixLayout::QRMatrixLayout() {
+    isMicro_ = false;
+    dimension_ = 0;
+    maskId_ = 0xFF;
+    dataModulesCount_ = 0;
+    modulesCount_ = 0;
+    positions_ = nullptr;
+    cells_ = nullptr;
+    maskedCells_ = nullptr;
+}
+
+QRMatrixLayout::QRMatrixLayout(const QRMatrixLayout &other) {
+    ecInfo_ = other.ecInfo_;
+    isMicro_ = other.isMicro_;
+    dimension_ = other.dimension_;
+    maskId_ = other.maskId_;
+    dataModulesCount_ = other.dataModulesCount_;
+    modulesCount_ = other.modulesCount_;
+    positions_ = nullptr;
+    cells_ = nullptr;
+    if (other.positions_ != nullptr) {
+        positions_ = new Unsigned2Bytes [modulesCount_];
+        memcpy(positions_, other.positions_, modulesCount_ * sizeof(Unsigned2Bytes));
+    }
+    if (other.cells_ != nullptr) {
+        cells_ = new UnsignedByte [dimension_ * dimension_];
+        memcpy(cells_, other.cells_, dimension_ * dimension_);
+    }
+    maskedCells_ = nullptr;
+    if (other.maskedCells_ != nullptr) {
+        maskedCells_ = new UnsignedByte [dimension_ * dimension_];
+        memcpy(maskedCells_, other.maskedCells_, dimension_ * dimension_);
+    }
+}
+
+QRMatrixLayout::QRMatrixLayout(QRMatrixLayout &&other) {
+    ecInfo_ = other.ecInfo_;
+    isMicro_ = other.isMicro_;
+    dimension_ = other.dimension_;
+    maskId_ = other.maskId_;
+    dataModulesCount_ = other.dataModulesCount_;
+    modulesCount_ = other.modulesCount_;
+    positions_ = other.positions_;
+    cells_ = other.cells_;
+    maskedCells_ = other.maskedCells_;
+    other.positions_ = nullptr;
+    other.cells_ = nullptr;
+    other.maskedCells_ = nullptr;
+    other.ecInfo_ = ErrorCorrectionInfo();
+}
+
+void QRMatrixLayout::operator=(QRMatrixLayout other) {
+    // `other` is already a copy, swap buffers & let it release ours
+    Unsigned2Bytes* positions = positions_;
+    UnsignedByte* cells = cells_;
+    UnsignedByte* maskedCells = maskedCells_;
+    ecInfo_ = other.ecInfo_;
+    isMicro_ = other.isMicro_;
+    dimension_ = other.dimension_;
+    maskId_ = other.maskId_;
+    dataModulesCount_ = other.dataModulesCount_;
+    modulesCount_ = other.modulesCount_;
+    positions_ = other.positions_;
+    cells_ = other.cells_;
+    maskedCells_ = other.maskedCells_;
+    other.positions_ = positions;
+    other.cells_ = cells;
+    other.maskedCells_ = maskedCells;
+}
+
+QRMatrixLayout::QRMatrixLayout(ErrorCorrectionInfo ecInfo, bool isMicro, UnsignedByte maskId) {
+    ecInfo_ = ecInfo;
+    isMicro_ = isMicro;
+    maskId_ = maskId;
+    dimension_ = isMicro ?
+        Common::microDimensionByVersion(ecInfo.version) :
+        Common::dimensionByVersion(ecInfo.version);
+    dataModulesCount_ = ecInfo.codewords * 8;
+    if (isMicro && (ecInfo.version == 1 || ecInfo.version == 3)) {
+        // Last data codeword of M1 & M3 has 4 bits
+        dataModulesCount_ -= 4;
+    }
+    modulesCount_ = dataModulesCount_ + ecInfo_.ecCodewordsTotalCount() * 8;
+    unsigned int remainderCount = QRMatrixBoard::remainderBitsCount(ecInfo.version, isMicro);
+
+    cells_ = new UnsignedByte [dimension_ * dimension_];
+    UnsignedByte* rows[dimension_];
+    for (UnsignedByte row = 0; row < dimension_; row += 1) {
+        rows[row] = cells_ + row * dimension_;
+    }
+    QRMatrixBoard::initialize(rows, dimension_, ecInfo_, isMicro);
+    positions_ = new Unsigned2Bytes [modulesCount_ + remainderCount];
+    QRMatrixBoard::dataModules(rows, dimension_, isMicro, positions_, modulesCount_ + remainderCount);
+    for (unsigned int index = modulesCount_; index < modulesCount_ + remainderCount; index += 1) {
+        cells_[positions_[index]] = BoardCell::remainder | BoardCell::unset;
+    }
+
+    maskedCells_ = nullptr;
+    if (maskId < (isMicro ? 4 : 8)) {
+        // Symbol of all codewords bits 0
+        maskedCells_ = new UnsignedByte [dimension_ * dimension_];
+        memcpy(maskedCells_, cells_, dimension_ * dimension_);
+        for (unsigned int index = 0; index < modulesCount_; index += 1) {
+            maskedCells_[positions_[index]] = BoardCell::unset | (index < dataModulesCount_ ? 0x00 : BoardCell::errorCorrection);
+        }
+        for (UnsignedByte row = 0; row < dimension_; row += 1) {
+            rows[row] = maskedCells_ + row * dimension_;
+        }
+        QRMatrixBoard::finish(rows, dimension_, ecInfo_, maskId, isMicro, nullptr);
+    }
+}
+
+unsigned int QRMatrixLayout::dataModule(unsigned int index) const {
+    unsigned int group1Count = ecInfo_.group1Blocks * ecInfo_.group1BlockCodewords;
+    unsigned int block = 0;
+    unsigned int offset = 0;
+    if (index < group1Count) {
+        block = index / ecInfo_.group1BlockCodewords;
+        offset = index % ecInfo_.group1BlockCodewords;
+    } else {
+        block = ecInfo_.group1Blocks + (index - group1Count) / ecInfo_.group2BlockCodewords;
+        offset = (index - group1Count) % ecInfo_.group2BlockCodewords;
+    }
+    unsigned int blockCount = ecInfo_.group1Blocks + ecInfo_.group2Blocks;
+    if (offset < ecInfo_.group1BlockCodewords) {
+        return (offset * blockCount + block) * 8;
+    }
+    // Last codeword of group 2 blocks (group 2 blocks are 1 codeword longer)
+    return (ecInfo_.group1BlockCodewords * blockCount + block - ecInfo_.group1Blocks) * 8;
+}
+
+unsigned int QRMatrixLayout::errorCorrectionModule(unsigned int index) const {
+    unsigned int blockCount = ecInfo_.group1Blocks + ecInfo_.group2Blocks;
+    unsigned int block = index / ecInfo_.ecCodewordsPerBlock;
+    unsigned int offset = index % ecInfo_.ecCodewordsPerBlock;
+    return dataModulesCount_ + (offset * blockCount + block) * 8;
+}
+
+/// Low 4 bits of cell XOR this value: black <-> white
+#define QRMATRIXLAYOUT_FLIP (BoardCell::set ^ BoardCell::unset)
+
+void QRMatrixLayout::placeCodeword(unsigned int module, UnsignedByte value, UnsignedByte* cells, bool isMasked) const {
+    bool isData = module < dataModulesCount_;
+    unsigned int end = module + 8;
+    if (isData && end > dataModulesCount_) {
+        end = dataModulesCount_;
+    }
+    UnsignedByte prefix = isData ? 0x00 : BoardCell::errorCorrection;
+    UnsignedByte mask = 0b10000000;
+    for (unsigned int index = module; index < end; index += 1) {
+        Unsigned2Bytes position = positions_[index];
+        if (isMasked) {
+            cells[position] = maskedCells_[position] ^ ((value & mask) > 0 ? QRMATRIXLAYOUT_FLIP : 0);
+        } else {
+            cells[position] = ((value & mask) > 0 ? BoardCell::set : BoardCell::unset) | prefix;
+        }
+        mask >>= 1;
+    }
+}
+
+void QRMatrixLayout::place(const UnsignedByte* data, const UnsignedByte* errorCorrection, UnsignedByte* cells) const {
+    memcpy(cells, cells_, dimension_ * dimension_);
+    for (unsigned int index = 0; index < modulesCount_; index += 1) {
+        bool isData = index < dataModulesCount_;
+        unsigned int bit = isData ? index : index - dataModulesCount_;
+        UnsignedByte value = isData ? data[bit / 8] : errorCorrection[bit / 8];
+        bool isSet = (value & (0b10000000 >> (bit % 8))) > 0;
+        cells[positions_[index]] = (isSet ? BoardCell::set : BoardCell::unset) | (isData ? 0x00 : BoardCell::errorCorrection);
+    }
+}
+
+void QRMatrixLayout::stamp(const UnsignedByte* data, const UnsignedByte* errorCorrection, UnsignedByte* cells) const {
+    memcpy(cells, maskedCells_, dimension_ * dimension_);
+    const Unsigned2Bytes* positions = positions_;
+    const UnsignedByte* bytes = data;
+    unsigned int count = dataModulesCount_;
+    for (UnsignedByte phase = 0; phase < 2; phase += 1) {
+        // Only bits 1 change cells
+        for (unsigned int index = 0; index < count; index += 8) {
+            UnsignedByte value = bytes[index / 8];
+            if (value == 0) {
+                continue;
+            }
+            unsigned int end = index + 8 < count ? index + 8 : count;
+            for (unsigned int bit = index; bit < end; bit += 1) {
+                if ((value & (0b10000000 >> (bit - index))) > 0) {
+                    cells[positions[bit]] ^= QRMATRIXLAYOUT_FLIP;
+                }
+            }
+        }
+        positions += dataModulesCount_;
+        bytes = errorCorrection;
+        count = modulesCount_ - dataModulesCount_;
+    }
+}
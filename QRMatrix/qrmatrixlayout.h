@@ -0,0 +1,106 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXLAYOUT_H
+#define QRMATRIXLAYOUT_H
+
+#include "constants.h"
+#include "common.h"
+
+namespace QRMatrix {
+
+    /// Placement of codewords in QR symbols of fixed version & error correction level.
+    /// Function patterns & reserved cells are filled once, and the cell of each codeword bit is precomputed
+    /// (scatter table), so a symbol of this layout is built by writing its codewords bits only.
+    /// The layout is not changed by encoding, so it can be shared by many threads.
+    class QRMatrixLayout {
+    public:
+        ~QRMatrixLayout();
+        QRMatrixLayout(const QRMatrixLayout &other);
+        QRMatrixLayout(QRMatrixLayout &&other);
+        void operator=(QRMatrixLayout other);
+        /// Empty layout (not valid). Result of `QRMatrixEncoder::prepareLayout` will be assigned later.
+        QRMatrixLayout();
+        /// Internal purpose. Use `QRMatrixEncoder::prepareLayout` (version & level are not validated here).
+        QRMatrixLayout(ErrorCorrectionInfo ecInfo, bool isMicro, UnsignedByte maskId);
+
+        /// Layout is made by `QRMatrixEncoder::prepareLayout` successfully
+        inline bool isValid() const { return ecInfo_.version > 0; }
+        /// Error correction level
+        inline ErrorCorrectionLevel level() const { return ecInfo_.level; }
+        /// QR Version (MicroQR version if `isMicro()`)
+        inline UnsignedByte version() const { return ecInfo_.version; }
+        /// Is MicroQR symbol
+        inline bool isMicro() const { return isMicro_; }
+        /// Symbol dimension (number of cells on each side)
+        inline UnsignedByte dimension() const { return dimension_; }
+        /// Mask of all symbols (0xFF for best mask of each symbol)
+        inline UnsignedByte maskId() const { return maskId_; }
+        /// All symbols use the same mask (`maskId()`)
+        inline bool isMaskFixed() const { return maskedCells_ != nullptr; }
+        /// Internal purpose. Blocks & codewords of symbol.
+        inline const ErrorCorrectionInfo& errorCorrectionInfo() const { return ecInfo_; }
+        /// Number of cells of data codewords
+        inline unsigned int dataModulesCount() const { return dataModulesCount_; }
+        /// Number of cells of data & error correction codewords
+        inline unsigned int modulesCount() const { return modulesCount_; }
+        /// Position (`row * dimension() + column`) of the cell of codewords bit `index`
+        /// (bits of interleaved data codewords then interleaved error correction codewords, most significant bit first).
+        inline Unsigned2Bytes position(unsigned int index) const { return positions_[index]; }
+        /// Internal purpose. `dimension() * dimension()` cells of function patterns, reserved format (and version) cells
+        /// & remainder cells. Cells of codewords are `BoardCell::neutral`.
+        inline const UnsignedByte* cells() const { return cells_; }
+        /// Internal purpose. `dimension() * dimension()` cells of the symbol which has all codewords bits 0,
+        /// masked by the fixed mask, with format (and version) cells (`nullptr` if mask is not fixed).
+        /// Cells of a symbol of this layout differ from these cells only at the bits 1 of its codewords.
+        inline const UnsignedByte* maskedCells() const { return maskedCells_; }
+
+        /// Index of the first bit (see `position`) of data codeword `index` (codewords of blocks in order, not interleaved)
+        unsigned int dataModule(unsigned int index) const;
+        /// Index of the first bit (see `position`) of error correction codeword `index`
+        /// (`ecCodewordsPerBlock` codewords of each block in order, not interleaved)
+        unsigned int errorCorrectionModule(unsigned int index) const;
+        /// Internal purpose. Write bits of codeword starting at bit `module` (`dataModule` or `errorCorrectionModule`)
+        /// into unmasked `cells` (`dimension() * dimension()` bytes).
+        /// If `isMasked` (mask must be fixed), bits are masked & written into final `cells`.
+        void placeCodeword(unsigned int module, UnsignedByte value, UnsignedByte* cells, bool isMasked = false) const;
+        /// Internal purpose. Write unmasked cells of symbol of given interleaved codewords into `cells`
+        /// (`dimension() * dimension()` bytes). Mask & format are not applied.
+        void place(const UnsignedByte* data, const UnsignedByte* errorCorrection, UnsignedByte* cells) const;
+        /// Internal purpose. Write final cells of symbol of given interleaved codewords into `cells`
+        /// (`dimension() * dimension()` bytes): copy `maskedCells()` then flip cells of bits 1. Mask must be fixed.
+        void stamp(const UnsignedByte* data, const UnsignedByte* errorCorrection, UnsignedByte* cells) const;
+    private:
+        ErrorCorrectionInfo ecInfo_;
+        bool isMicro_;
+        UnsignedByte dimension_;
+        UnsignedByte maskId_;
+        unsigned int dataModulesCount_;
+        unsigned int modulesCount_;
+        Unsigned2Bytes* positions_;
+        UnsignedByte* cells_;
+        UnsignedByte* maskedCells_;
+    };
+
+}
+
+#endif // QRMATRIXLAYOUT_H
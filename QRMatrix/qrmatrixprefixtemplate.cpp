@@ -0,0 +1,99 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixprefixtemplate.h"
+
+using namespace QRMatrix;
+
+QRMatrixPrefixTemplate::~QRMatrixPrefixTemplate() {
+    if (data_ != nullptr) {
+        delete[] data_;
+    }
+    if (ecStates_ != nullptr) {
+        delete[] ecStates_;
+    }
+}
+
+QRMatrixPrefixTemplate::QRMatrixPrefixTemplate() {
+    count_ = 0;
+    maskId_ = 0xFF;
+    dimension_ = 0;
+    bitsCount_ = 0;
+    data_ = nullptr;
+    ecStates_ = nullptr;
+}
+
+QRMatrixPrefixTemplate::QRMatrixPrefixTemplate(const QRMatrixPrefixTemplate &other): extraMode_(other.extraMode_) {
+    count_ = other.count_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    data_ = nullptr;
+    ecStates_ = nullptr;
+    if (other.data_ != nullptr) {
+        unsigned int length = (bitsCount_ + 7) / 8;
+        data_ = new UnsignedByte [length];
+        for (unsigned int index = 0; index < length; index += 1) {
+            data_[index] = other.data_[index];
+        }
+    }
+    if (other.ecStates_ != nullptr) {
+        unsigned int length = ecInfo_.ecCodewordsTotalCount();
+        ecStates_ = new UnsignedByte [length];
+        for (unsigned int index = 0; index < length; index += 1) {
+            ecStates_[index] = other.ecStates_[index];
+        }
+    }
+}
+
+QRMatrixPrefixTemplate::QRMatrixPrefixTemplate(QRMatrixPrefixTemplate &&other): extraMode_(other.extraMode_) {
+    count_ = other.count_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    data_ = other.data_;
+    ecStates_ = other.ecStates_;
+    other.data_ = nullptr;
+    other.ecStates_ = nullptr;
+    other.ecInfo_ = ErrorCorrectionInfo();
+}
+
+void QRMatrixPrefixTemplate::operator=(QRMatrixPrefixTemplate other) {
+    if (data_ != nullptr) {
+        delete[] data_;
+    }
+    if (ecStates_ != nullptr) {
+        delete[] ecStates_;
+    }
+    count_ = other.count_;
+    extraMode_ = other.extraMode_;
+    maskId_ = other.maskId_;
+    dimension_ = other.dimension_;
+    ecInfo_ = other.ecInfo_;
+    bitsCount_ = other.bitsCount_;
+    data_ = other.data_;
+    ecStates_ = other.ecStates_;
+    other.data_ = nullptr;
+    other.ecStates_ = nullptr;
+}
@@ -0,0 +1,89 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXPREFIXTEMPLATE_H
+#define QRMATRIXPREFIXTEMPLATE_H
+
+#include "constants.h"
+#include "common.h"
+#include "qrmatrixextramode.h"
+
+namespace QRMatrix {
+
+    /// Result of `QRMatrixEncoder::preparePrefix`: fixed leading segments encoded once for a given version & level.
+    /// It keeps the encoded bits of the prefix and the error correction state of each block after its fixed codewords
+    /// (Reed-Solomon codes are linear, so encoding a variant only continues from this state with the tail codewords).
+    /// Pass it to `QRMatrixEncoder::encode` with the variable tail segments of each symbol.
+    /// Prefix segments are not required after the template is made.
+    /// The template is not changed by encoding, so it can be shared by many threads (1 encoder context per thread).
+    class QRMatrixPrefixTemplate {
+    public:
+        ~QRMatrixPrefixTemplate();
+        QRMatrixPrefixTemplate(const QRMatrixPrefixTemplate &other);
+        QRMatrixPrefixTemplate(QRMatrixPrefixTemplate &&other);
+        void operator=(QRMatrixPrefixTemplate other);
+        /// Empty template (not valid for encoding). Result of `QRMatrixEncoder::preparePrefix` will be assigned later.
+        QRMatrixPrefixTemplate();
+
+        /// Template is made by `QRMatrixEncoder::preparePrefix` successfully
+        inline bool isValid() const { return ecInfo_.version > 0; }
+        /// Number of prefix segments
+        inline unsigned int count() const { return count_; }
+        /// Error correction level
+        inline ErrorCorrectionLevel level() const { return ecInfo_.level; }
+        /// Extra mode
+        inline const QRMatrixExtraMode& extraMode() const { return extraMode_; }
+        /// Forced mask (0xFF for best mask)
+        inline UnsignedByte maskId() const { return maskId_; }
+        /// QR Version (MicroQR version if `isMicro()`)
+        inline UnsignedByte version() const { return ecInfo_.version; }
+        /// Is MicroQR symbol
+        inline bool isMicro() const { return extraMode_.mode == EncodingExtraMode::microQr; }
+        /// Symbol dimension (number of cells on each side)
+        inline UnsignedByte dimension() const { return dimension_; }
+        /// Internal purpose. Blocks & codewords of symbol.
+        inline const ErrorCorrectionInfo& errorCorrectionInfo() const { return ecInfo_; }
+        /// Number of data bits of prefix (all headers included)
+        inline unsigned int bitsCount() const { return bitsCount_; }
+        /// Number of data bits the symbol can hold
+        inline unsigned int capacity() const { return ecInfo_.codewords * 8; }
+        /// Internal purpose. Encoded prefix (`(bitsCount() + 7) / 8` bytes, unused bits of last byte are 0).
+        inline const UnsignedByte* data() const { return data_; }
+        /// Internal purpose. Error correction remainder of each block after its codewords fully filled by prefix
+        /// (`ecInfo.ecCodewordsPerBlock` bytes for each block).
+        inline const UnsignedByte* errorCorrectionStates() const { return ecStates_; }
+    private:
+        friend class QRMatrixEncoder;
+
+        unsigned int count_;
+        QRMatrixExtraMode extraMode_;
+        UnsignedByte maskId_;
+        UnsignedByte dimension_;
+        ErrorCorrectionInfo ecInfo_;
+        unsigned int bitsCount_;
+        UnsignedByte* data_;
+        UnsignedByte* ecStates_;
+    };
+
+}
+
+#endif // QRMATRIXPREFIXTEMPLATE_H
@@ -31,81 +31,71 @@ using namespace std;
 
 // Data Validation ----------------------------------------------------------------------------------------------------------------------------------
 
-void validateNumeric(const UnsignedByte* data, unsigned int length) {
-    static const char* pattern = "0123456789";
+QRMatrixStatus validateNumeric(const UnsignedByte* data, unsigned int length) noexcept {
     for (unsigned int index = 0; index < length; index += 1) {
         UnsignedByte byte = data[index];
-        if (strchr(pattern, (char)byte) == NULL) {
-            string mesg = "Invalid data for Numeric mode [";
-            mesg.append(std::to_string(index));
-            mesg.append("] ");
-            mesg.append(std::to_string(byte));
-            throw QR_EXCEPTION(mesg.c_str());
+        if (byte < '0' || byte > '9') {
+            return QRMatrixStatus(EncodingStatus::invalidNumericData, 0, index);
         }
     }
+    return QRMatrixStatus();
 }
 
-void validateAlphaNumeric(const UnsignedByte* data, unsigned int length) {
+QRMatrixStatus validateAlphaNumeric(const UnsignedByte* data, unsigned int length) noexcept {
     static const char* pattern = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
     for (unsigned int index = 0; index < length; index += 1) {
         UnsignedByte byte = data[index];
-        if (strchr(pattern, (char)byte) == NULL) {
-            string mesg = "Invalid data for AlphaNumeric mode [";
-            mesg.append(std::to_string(index));
-            mesg.append("] ");
-            mesg.append(std::to_string(byte));
-            throw QR_EXCEPTION(mesg.c_str());
+        if (byte == 0 || strchr(pattern, (char)byte) == NULL) {
+            return QRMatrixStatus(EncodingStatus::invalidAlphaNumericData, 0, index);
         }
     }
+    return QRMatrixStatus();
 }
 
-void validateKanji(const UnsignedByte* data, unsigned int length) {
+Unsigned2Bytes kanjiCharacter(const UnsignedByte* data) {
+    return ((Unsigned2Bytes)data[0] << 8) | data[1];
+}
+
+QRMatrixStatus validateKanji(const UnsignedByte* data, unsigned int length) noexcept {
     // Only accept 2 bytes ShiftJIS characters
     if ((length % 2) > 0) {
-        throw QR_EXCEPTION("Invalid data for Kanji mode");
+        return QRMatrixStatus(EncodingStatus::invalidKanjiData, 0, length);
     }
     for (unsigned int index = 0; index < length; index += 2) {
-        Unsigned2Bytes curChar = 0;
-        UnsignedByte* curCharPtr = (UnsignedByte*)&curChar;
-        if (Common::isLittleEndian) {
-            *curCharPtr = data[index + 1];
-            *(curCharPtr + 1) = data[index];
-        } else {
-            *curCharPtr = data[index];
-            *(curCharPtr + 1) = data[index + 1];
-        }
+        Unsigned2Bytes curChar = kanjiCharacter(&data[index]);
         bool isValid = (
             (curChar >= 0x8140) && (curChar <= 0x9FFC)) ||
             ((curChar >= 0xE040) && (curChar <= 0xEBBF)
         );
         if (!isValid) {
-            string mesg = "Invalid data for Kanji mode [";
-            mesg.append(std::to_string(index));
-            mesg.append("] ");
-            mesg.append(std::to_string(data[index]));
-            mesg.append(" ");
-            mesg.append(std::to_string(data[index + 1]));
-            mesg.append(": ");
-            mesg.append(std::to_string(curChar));
-            throw QR_EXCEPTION(mesg.c_str());
+            return QRMatrixStatus(EncodingStatus::invalidKanjiData, 0, index);
         }
     }
+    return QRMatrixStatus();
 }
 
+/// Throw exception for invalid input bytes
 void validateInputBytes(EncodingMode mode, const UnsignedByte* data, unsigned int length) {
-    switch (mode) {
-    case EncodingMode::numeric:
-        validateNumeric(data, length);
-        break;
-    case EncodingMode::alphaNumeric:
-        validateAlphaNumeric(data, length);
-        break;
-    case EncodingMode::kanji:
-        validateKanji(data, length);
-        break;
-    default:
-        break;
+    QRMatrixStatus status = QRMatrixSegment::validate(mode, data, length);
+    if (status.isSucceeded()) {
+        return;
     }
+    unsigned int index = status.byteOffset;
+    string mesg = status.message();
+    if (index >= length) {
+        throw QR_EXCEPTION(mesg.c_str());
+    }
+    mesg.append(" [");
+    mesg.append(std::to_string(index));
+    mesg.append("] ");
+    mesg.append(std::to_string(data[index]));
+    if (mode == EncodingMode::kanji) {
+        mesg.append(" ");
+        mesg.append(std::to_string(data[index + 1]));
+        mesg.append(": ");
+        mesg.append(std::to_string(kanjiCharacter(&data[index])));
+    }
+    throw QR_EXCEPTION(mesg.c_str());
 }
 
 // PUBLIC -------------------------------------------------------------------------------------------------------------------------------------------
@@ -152,8 +142,39 @@ QRMatrixSegment::QRMatrixSegment() {
     data_ = NULL;
 }
 
+QRMatrixStatus QRMatrixSegment::validate(EncodingMode mode, const UnsignedByte* data, unsigned int length) noexcept {
+    switch (mode) {
+    case EncodingMode::numeric:
+        return validateNumeric(data, length);
+    case EncodingMode::alphaNumeric:
+        return validateAlphaNumeric(data, length);
+    case EncodingMode::kanji:
+        return validateKanji(data, length);
+    default:
+        break;
+    }
+    return QRMatrixStatus();
+}
+
+QRMatrixStatus QRMatrixSegment::tryFill(EncodingMode mode, const UnsignedByte *data, unsigned int length, unsigned int eciIndicator) noexcept {
+    QRMatrixStatus status = QRMatrixSegment::validate(mode, data, length);
+    if (!status.isSucceeded()) {
+        return status;
+    }
+    try {
+        fillData(mode, data, length, eciIndicator);
+    } catch (...) {
+        return QRMatrixStatus(EncodingStatus::internalError);
+    }
+    return status;
+}
+
 void QRMatrixSegment::fill(EncodingMode mode, const UnsignedByte *data, unsigned int length, unsigned int eciIndicator) {
     validateInputBytes(mode, data, length);
+    fillData(mode, data, length, eciIndicator);
+}
+
+void QRMatrixSegment::fillData(EncodingMode mode, const UnsignedByte *data, unsigned int length, unsigned int eciIndicator) {
     if (data_ != NULL) {
         delete[] data_;
     }
@@ -24,6 +24,7 @@
 #define QRMATRIXSEGMENT_H
 
 #include "constants.h"
+#include "qrmatrixstatus.h"
 
 namespace QRMatrix {
 
@@ -55,6 +56,12 @@ namespace QRMatrix {
         QRMatrixSegment();
         /// Fill segment with given data
         void fill(EncodingMode mode, const UnsignedByte* data, unsigned int length, unsigned int eciIndicator = defaultEciAssigmentValue);
+        /// Fill segment with given data without throwing exception.
+        /// Segment is not changed if data is invalid (`byteOffset` of result is the position of invalid byte).
+        QRMatrixStatus tryFill(EncodingMode mode, const UnsignedByte* data, unsigned int length, unsigned int eciIndicator = defaultEciAssigmentValue) noexcept;
+        /// Check if `data` is valid for given encoding `mode`.
+        /// `byteOffset` of result is the position of invalid byte.
+        static QRMatrixStatus validate(EncodingMode mode, const UnsignedByte* data, unsigned int length) noexcept;
         void operator=(QRMatrixSegment other);
 
         inline EncodingMode mode() { return mode_; }
@@ -66,6 +73,8 @@ namespace QRMatrix {
         /// MicroQR does not have ECI mode, so we ignore this in MicroQR.
         inline bool isEciHeaderRequired() { return eci_ != defaultEciAssigmentValue; }
     private:
+        void fillData(EncodingMode mode, const UnsignedByte* data, unsigned int length, unsigned int eciIndicator);
+
         EncodingMode mode_;
         unsigned int length_;
         UnsignedByte* data_;
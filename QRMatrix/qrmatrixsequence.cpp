@@ -0,0 +1,71 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixsequence.h"
+#include <utility>
+
+using namespace QRMatrix;
+
+QRMatrixSequence::~QRMatrixSequence() {
+    if (data_ != nullptr) {
+        delete[] data_;
+    }
+    if (errorCorrection_ != nullptr) {
+        delete[] errorCorrection_;
+    }
+    if (cells_ != nullptr) {
+        delete[] cells_;
+    }
+}
+
+QRMatrixSequence::QRMatrixSequence() {
+    data_ = nullptr;
+    errorCorrection_ = nullptr;
+    cells_ = nullptr;
+    isPlaced_ = false;
+    maskId_ = 0xFF;
+    changedCount_ = 0;
+}
+
+QRMatrixSequence::QRMatrixSequence(QRMatrixSequence &&other): QRMatrixSequence() {
+    *this = std::move(other);
+}
+
+void QRMatrixSequence::operator=(QRMatrixSequence &&other) {
+    // Swap buffers & let `other` release ours
+    UnsignedByte* data = data_;
+    UnsignedByte* errorCorrection = errorCorrection_;
+    UnsignedByte* cells = cells_;
+    layout_ = std::move(other.layout_);
+    extraMode_ = other.extraMode_;
+    board_ = std::move(other.board_);
+    data_ = other.data_;
+    errorCorrection_ = other.errorCorrection_;
+    cells_ = other.cells_;
+    isPlaced_ = other.isPlaced_;
+    maskId_ = other.maskId_;
+    changedCount_ = other.changedCount_;
+    other.data_ = data;
+    other.errorCorrection_ = errorCorrection;
+    other.cells_ = cells;
+    other.isPlaced_ = false;
+}
@@ -0,0 +1,83 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXSEQUENCE_H
+#define QRMATRIXSEQUENCE_H
+
+#include "constants.h"
+#include "qrmatrixboard.h"
+#include "qrmatrixextramode.h"
+#include "qrmatrixlayout.h"
+
+namespace QRMatrix {
+
+    /// State of `QRMatrixEncoder::encode(context, sequence, segments, count)` to encode a sequence of similar symbols
+    /// (eg. serial numbers) of fixed version & level.
+    /// The sequence keeps codewords & unmasked cells of the last symbol: for the next symbol, only the codewords
+    /// which differ (and the difference of their error corrections) are calculated & placed again.
+    /// A sequence must not be used by 2 encodings at the same time.
+    class QRMatrixSequence {
+    public:
+        ~QRMatrixSequence();
+        /// Empty sequence (not valid). Result of `QRMatrixEncoder::prepareSequence` will be assigned later.
+        QRMatrixSequence();
+        QRMatrixSequence(QRMatrixSequence &&other);
+        void operator=(QRMatrixSequence &&other);
+
+        /// Sequence is made by `QRMatrixEncoder::prepareSequence` successfully
+        inline bool isValid() const { return layout_.isValid(); }
+        /// Codewords placement of all symbols
+        inline const QRMatrixLayout& layout() const { return layout_; }
+        /// Extra mode
+        inline const QRMatrixExtraMode& extraMode() const { return extraMode_; }
+        /// The last encoded symbol (empty board before the first encoding)
+        inline QRMatrixBoard& board() { return board_; }
+        /// Applied mask of the last encoded symbol
+        inline UnsignedByte maskId() const { return maskId_; }
+        /// Number of data & error correction codewords placed by the last encoding
+        inline unsigned int changedCount() const { return changedCount_; }
+        /// Forget the last symbol: the next encoding places all codewords.
+        inline void reset() { isPlaced_ = false; }
+    private:
+        friend class QRMatrixEncoder;
+
+        QRMatrixLayout layout_;
+        QRMatrixExtraMode extraMode_;
+        QRMatrixBoard board_;
+        /// Data codewords of the last symbol (not interleaved)
+        UnsignedByte* data_;
+        /// Error correction codewords of the last symbol (`ecCodewordsPerBlock` bytes for each block)
+        UnsignedByte* errorCorrection_;
+        /// Unmasked cells of the last symbol
+        UnsignedByte* cells_;
+        bool isPlaced_;
+        UnsignedByte maskId_;
+        unsigned int changedCount_;
+
+        // Not copyable
+        QRMatrixSequence(QRMatrixSequence &other);
+        void operator=(QRMatrixSequence &other);
+    };
+
+}
+
+#endif // QRMATRIXSEQUENCE_H
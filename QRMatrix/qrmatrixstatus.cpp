@@ -0,0 +1,69 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixstatus.h"
+
+using namespace QRMatrix;
+
+const char* QRMatrixStatus::message() const noexcept {
+    switch (code) {
+    case succeeded:
+        return "";
+    case noInput:
+        return "No input.";
+    case invalidNumericData:
+        return "Invalid data for Numeric mode";
+    case invalidAlphaNumericData:
+        return "Invalid data for AlphaNumeric mode";
+    case invalidKanjiData:
+        return "Invalid data for Kanji mode";
+    case invalidEciIndicator:
+        return "Invalid ECI Indicator";
+    case invalidApplicationIndicator:
+        return "Invalid Application Indicator for FNC1 Second Position mode";
+    case levelNotAvailable:
+        return "Error Correction Level High not available in MicroQR.";
+    case dataOverCapacity:
+        return "Unable to find suitable QR version.";
+    case tooManyParts:
+        return "Structured Append only accepts 16 parts maximum";
+    case invalidStride:
+        return "Output buffer stride is smaller than a row";
+    case insufficientCapacity:
+        return "Output buffer capacity is not enough";
+    case invalidVersion:
+        return "Invalid QR version";
+    case invalidFormat:
+        return "Unreadable format information of QR symbol";
+    case tooManyErrors:
+        return "Too many errors to be corrected in QR symbol";
+    case invalidBitStream:
+        return "Invalid data in QR symbol";
+    case invalidObject:
+        return "Plan, layout, prefix template or sequence is not prepared";
+    case invalidMask:
+        return "Invalid mask";
+    case internalError:
+        return "Internal error (eg. memory allocation failed)";
+    }
+    return "";
+}
@@ -0,0 +1,103 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXSTATUS_H
+#define QRMATRIXSTATUS_H
+
+#include "constants.h"
+
+namespace QRMatrix {
+
+    /// Result code of exception-free functions (`try...`)
+    enum EncodingStatus {
+        /// No error
+        succeeded = 0,
+        /// All data segments are empty
+        noInput,
+        /// Data of Numeric segment contains non-digit byte
+        invalidNumericData,
+        /// Data of AlphaNumeric segment contains unsupported byte
+        invalidAlphaNumericData,
+        /// Data of Kanji segment contains non 2-bytes ShiftJIS character
+        invalidKanjiData,
+        /// ECI Indicator is out of range (0...999999)
+        invalidEciIndicator,
+        /// Application Indicator for FNC1 Second Position mode is invalid
+        invalidApplicationIndicator,
+        /// Error Correction Level is not available (MicroQR)
+        levelNotAvailable,
+        /// Data is too big for all QR versions
+        dataOverCapacity,
+        /// Structured Append has more than 16 parts
+        tooManyParts,
+        /// Output buffer stride is smaller than a row
+        invalidStride,
+        /// Output buffer capacity is not enough for all rows
+        insufficientCapacity,
+        /// QR version is out of range (1...40, or 1...4 for MicroQR)
+        invalidVersion,
+        /// Decoding: format (or version) information of symbol is unreadable or does not match its dimension
+        invalidFormat,
+        /// Decoding: a block has too many errors to be fixed by its error correction codewords
+        tooManyErrors,
+        /// Decoding: data codewords are not a valid sequence of segments
+        invalidBitStream,
+        /// Plan, layout, prefix template or sequence is not prepared (placeholder or failed preparation)
+        invalidObject,
+        /// Mask is out of range (0...7, or 0...3 for MicroQR)
+        invalidMask,
+        /// Unexpected failure inside library (eg. memory allocation failed)
+        internalError
+    };
+
+    /// Result of exception-free functions (`try...`)
+    struct QRMatrixStatus {
+        /// Result code
+        EncodingStatus code;
+        /// Index of the data segment causing error (if available, decoding: index of segment being read)
+        unsigned int segmentIndex;
+        /// Offset of the byte causing error in data segment (if available)
+        unsigned int byteOffset;
+        /// Index of the Structured Append part causing error (if available)
+        unsigned int partIndex;
+
+        inline QRMatrixStatus() {
+            code = EncodingStatus::succeeded;
+            segmentIndex = 0;
+            byteOffset = 0;
+            partIndex = 0;
+        }
+        inline QRMatrixStatus(EncodingStatus statusCode, unsigned int segment = 0, unsigned int offset = 0) {
+            code = statusCode;
+            segmentIndex = segment;
+            byteOffset = offset;
+            partIndex = 0;
+        }
+
+        inline bool isSucceeded() const noexcept { return code == EncodingStatus::succeeded; }
+        /// Error message (same as description of `QRMatrixException` thrown by other functions)
+        const char* message() const noexcept;
+    };
+
+}
+
+#endif // QRMATRIXSTATUS_H
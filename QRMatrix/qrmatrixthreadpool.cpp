@@ -0,0 +1,194 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "qrmatrixthreadpool.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace QRMatrix;
+
+namespace QRMatrix {
+
+/// Remaining items of a worker: `begin..<end`
+struct QRMatrixThreadPool_Queue {
+    std::mutex mutex;
+    unsigned int begin = 0;
+    unsigned int end = 0;
+};
+
+struct QRMatrixThreadPool_State {
+    /// Guard all below properties
+    std::mutex mutex;
+    /// Signal workers a new run or stopping
+    std::condition_variable wake;
+    /// Signal `run` all workers are done
+    std::condition_variable done;
+    /// Increased for each run
+    unsigned long generation = 0;
+    /// Number of threads not done with current run yet
+    unsigned int pending = 0;
+    bool isStopping = false;
+    const std::function<void(unsigned int, unsigned int)>* task = nullptr;
+
+    /// Only 1 run at a time
+    std::mutex runMutex;
+    /// 1 for each worker
+    QRMatrixThreadPool_Queue* queues = nullptr;
+    QRMatrixEncoderContext* contexts = nullptr;
+    /// Worker 0 is the thread calling `run`, so thread `i` is worker `i + 1`
+    std::thread* threads = nullptr;
+};
+
+}
+
+/// Take next item for `worker`: its own item first, otherwise steal half of items of other worker.
+bool QRMatrixThreadPool_next(QRMatrixThreadPool_State* state, unsigned int workerCount, unsigned int worker, unsigned int* index) {
+    QRMatrixThreadPool_Queue& own = state->queues[worker];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end) {
+            *index = own.begin;
+            own.begin += 1;
+            return true;
+        }
+    }
+    for (unsigned int offset = 1; offset < workerCount; offset += 1) {
+        QRMatrixThreadPool_Queue& victim = state->queues[(worker + offset) % workerCount];
+        unsigned int begin = 0;
+        unsigned int end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) {
+                continue;
+            }
+            // Take the last half (rounded up) so the victim keeps going on its first items
+            unsigned int half = (victim.end - victim.begin + 1) / 2;
+            begin = victim.end - half;
+            end = victim.end;
+            victim.end = begin;
+        }
+        *index = begin;
+        if (begin + 1 < end) {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin + 1;
+            own.end = end;
+        }
+        return true;
+    }
+    return false;
+}
+
+void QRMatrixThreadPool_work(QRMatrixThreadPool_State* state, unsigned int workerCount, unsigned int worker) {
+    const std::function<void(unsigned int, unsigned int)>& task = *state->task;
+    unsigned int index = 0;
+    while (QRMatrixThreadPool_next(state, workerCount, worker, &index)) {
+        task(worker, index);
+    }
+}
+
+void QRMatrixThreadPool_loop(QRMatrixThreadPool_State* state, unsigned int workerCount, unsigned int worker) {
+    unsigned long generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->wake.wait(lock, [state, generation]() {
+                return state->isStopping || state->generation != generation;
+            });
+            if (state->isStopping) {
+                return;
+            }
+            generation = state->generation;
+        }
+        QRMatrixThreadPool_work(state, workerCount, worker);
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->pending -= 1;
+            if (state->pending == 0) {
+                state->done.notify_all();
+            }
+        }
+    }
+}
+
+QRMatrixThreadPool::QRMatrixThreadPool(unsigned int threadCount) {
+    workerCount_ = threadCount > 0 ? threadCount : std::thread::hardware_concurrency();
+    if (workerCount_ == 0) {
+        workerCount_ = 1;
+    }
+    state_ = new QRMatrixThreadPool_State();
+    state_->queues = new QRMatrixThreadPool_Queue [workerCount_];
+    state_->contexts = new QRMatrixEncoderContext [workerCount_];
+    state_->threads = new std::thread [workerCount_ - 1];
+    for (unsigned int index = 1; index < workerCount_; index += 1) {
+        state_->threads[index - 1] = std::thread(QRMatrixThreadPool_loop, state_, workerCount_, index);
+    }
+}
+
+QRMatrixThreadPool::~QRMatrixThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->isStopping = true;
+    }
+    state_->wake.notify_all();
+    for (unsigned int index = 0; index + 1 < workerCount_; index += 1) {
+        state_->threads[index].join();
+    }
+    delete[] state_->threads;
+    delete[] state_->contexts;
+    delete[] state_->queues;
+    delete state_;
+}
+
+QRMatrixEncoderContext& QRMatrixThreadPool::context(unsigned int worker) {
+    return state_->contexts[worker];
+}
+
+void QRMatrixThreadPool::run(unsigned int count, const std::function<void(unsigned int, unsigned int)>& task) {
+    if (count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> runLock(state_->runMutex);
+    // Split items evenly
+    unsigned long long total = count;
+    for (unsigned int worker = 0; worker < workerCount_; worker += 1) {
+        QRMatrixThreadPool_Queue& queue = state_->queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.begin = (unsigned int)(total * worker / workerCount_);
+        queue.end = (unsigned int)(total * (worker + 1) / workerCount_);
+    }
+    if (workerCount_ > 1) {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->task = &task;
+            state_->pending = workerCount_ - 1;
+            state_->generation += 1;
+        }
+        state_->wake.notify_all();
+    } else {
+        state_->task = &task;
+    }
+    QRMatrixThreadPool_work(state_, workerCount_, 0);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done.wait(lock, [this]() { return state_->pending == 0; });
+    state_->task = nullptr;
+}
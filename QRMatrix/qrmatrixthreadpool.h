@@ -0,0 +1,66 @@
+/*
+    QRMatrix - QR pixels presentation.
+    Copyright © 2023 duongpq/soleilpqd.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of
+    this software and associated documentation files (the “Software”), to deal in
+    the Software without restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+    Software, and to permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+    PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+    FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+    OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef QRMATRIXTHREADPOOL_H
+#define QRMATRIXTHREADPOOL_H
+
+#include "constants.h"
+#include "qrmatrixencodercontext.h"
+#include <functional>
+
+namespace QRMatrix {
+
+    /// Internal data model
+    struct QRMatrixThreadPool_State;
+
+    /// Workers to encode many QR symbols in parallel (see `QRMatrixEncoder::encodeBatch`).
+    /// Each worker has its own `QRMatrixEncoderContext` which is kept between runs.
+    /// Items of a run are split evenly between workers; a worker which has finished its items
+    /// steals half of remaining items of another worker, so symbols of different sizes are balanced.
+    class QRMatrixThreadPool {
+    public:
+        ~QRMatrixThreadPool();
+        /// Create pool with given number of workers (0 for number of CPU cores).
+        /// The thread calling `run` is also a worker, so `threadCount - 1` threads are created.
+        QRMatrixThreadPool(unsigned int threadCount = 0);
+
+        /// Number of workers (include the thread calling `run`)
+        inline unsigned int workerCount() { return workerCount_; }
+        /// Scratch memory of given worker
+        QRMatrixEncoderContext& context(unsigned int worker);
+
+        /// Call `task(worker, index)` for each `index` in `0..<count` on workers and wait until all are done.
+        /// `task` must not throw exception.
+        /// Runs from different threads are executed one by one.
+        void run(unsigned int count, const std::function<void(unsigned int worker, unsigned int index)>& task);
+    private:
+        unsigned int workerCount_;
+        QRMatrixThreadPool_State* state_;
+
+        // Not copyable
+        QRMatrixThreadPool(QRMatrixThreadPool &other);
+        void operator=(QRMatrixThreadPool other);
+    };
+
+}
+
+#endif // QRMATRIXTHREADPOOL_H